@@ -3,12 +3,15 @@
 #include "ThING/types/renderData.h"
 #include "glm/fwd.hpp"
 #include "glm/geometric.hpp"
+#include "glm/gtc/packing.hpp"
 #include "miniaudio.h"
 #include <ThING/types/vertex.h>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <mutex>
+#include <numeric>
 #include <span>
 #include <sys/stat.h>
 #include <utility>
@@ -16,17 +19,28 @@
 #include <vulkan/vulkan_core.h>
 #define MINIAUDIO_IMPLEMENTATION
 #include <ThING/api.h>
+#include <ThING/text/font.h>
 #include "imgui.h"
 
 // Backends (GLFW + Vulkan)
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_vulkan.h"
 
+// Runs fn when the scope is left, returning or unwinding
+template <typename Fn>
+struct ScopeExit{
+    Fn fn;
+    ~ScopeExit() {fn();}
+};
+
 //CONSTRUCTOR
 ThING::API::API(uint8_t flags) : app(){
     apiFlags = flags;
     if (ma_engine_init(nullptr, &audioEngine) != MA_SUCCESS){
         assert("ERROR: Initializing audio engine");
+    } else {
+        soundPool.init(&audioEngine);
+        synth.init(&audioEngine);
     }
     updateCallback = nullptr;
     uiCallback = nullptr;
@@ -47,18 +61,26 @@ ThING::API::API(uint8_t flags) : app(){
         app.initVulkan();
     }
     app.initImGui();
+    storeViewExtent(); // getWindowSize works before run()
 }
 
 ThING::API::API() : ThING::API(0){
 }
 
 ThING::API::~API(){
+    if(updateThread.joinable()){
+        updateRunning = false;
+        updateThread.join();
+    }
+    graphLoader.cancel(); // joins the driver and its parse workers before the rest goes down
+    soundPool.uninit();
+    synth.uninit();
     ma_engine_uninit(&audioEngine);
 }
 
 void ThING::API::run(){
+    ScopeExit cleanup{[this]{app.cleanup();}}; // a callback that throws still gets the device torn down after its frames
     mainLoop();
-    app.cleanup();
 }
 
 bool ThING::API::setUpdateCallback(std::function<void(ThING::API&, FPSCounter&)> update){
@@ -77,9 +99,15 @@ bool ThING::API::setUICallback(std::function<void(ThING::API&, FPSCounter&)> UI)
 
 //PRIVATE
 void ThING::API::mainLoop() {
+    if(apiFlags & ApiFlags_ThreadedUpdate){
+        threadedMainLoop();
+        return;
+    }
     FPSCounter fps;
     while (!glfwWindowShouldClose(app.windowManager.getWindow())) {
         fps.beginFrame();
+        app.beginFrame();
+        storeViewExtent();
 
         ImGui_ImplVulkan_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -87,6 +115,8 @@ void ThING::API::mainLoop() {
 
         dirtyFlags.ssbo = false;
         dirtyFlags.meshes = false;
+        dirtyFlags.circles = false;
+        spatialStale = true;
 
         // Callbacks
         if(apiFlags & ApiFlags_UpdateCallbackFirst){
@@ -96,11 +126,30 @@ void ThING::API::mainLoop() {
             if(uiCallback) uiCallback(*this, fps);
             if(updateCallback) updateCallback(*this, fps);
         }
+        stepScheduler.run();
+        drainEdits();
+        ingestGraph();
+        streamTiles();
+        expireTweens();
+        dropCircleLinks();
+        recordTimeline();
+        if(dirtyFlags.ssbo){
+            markInstancesWritten(); // recordWorldData remaps the objectIDs
+        }
         //RENDER
         ImGui::Render();
         app.recordWorldData(circleInstances, polygonInstances, std::span(reinterpret_cast<InstanceData*>(lineInstances.data()), 
-            lineInstances.size()), polygonMeshes, dirtyFlags);
+            lineInstances.size()), polygonMeshes, edges, texts, glyphs, dirtyFlags);
+        if(dirtyFlags.ssbo){
+            trackOutlineSlots();
+        }
         app.renderFrame();
+        app.outlineManager.clearDirty();
+        app.tweenManager.clearDirty();
+        // Here rather than with the others so texts added before run() still make it to the first frame
+        dirtyFlags.texts = false;
+        dirtyFlags.glyphs = false;
+        dirtyFlags.edges = false;
         
         fps.endFrame();
         if(EXIT_){
@@ -110,68 +159,282 @@ void ThING::API::mainLoop() {
     vkDeviceWaitIdle(app.device);
 }
 
+void ThING::API::threadedMainLoop() {
+    FPSCounter fps;
+    {
+        std::lock_guard<std::mutex> lock(sceneMutex);
+        publishSnapshot(); // so the first frame has something to draw
+    }
+    updateRunning = true;
+    updateThread = std::thread(&ThING::API::updateLoop, this);
+    // The UI callback or the renderer throwing leaves through here too, the update thread is stopped and the frames in
+    // flight are done before the exception goes on
+    ScopeExit stopUpdate{[this]{stopUpdateThread();}};
+
+    uint64_t meshVersionSeen = 0;
+    uint64_t outlineVersionSeen = 0;
+    uint64_t tweenVersionSeen = 0;
+    uint64_t textVersionSeen = 0;
+    uint64_t glyphVersionSeen = 0;
+    uint64_t edgeVersionSeen = 0;
+    while (!glfwWindowShouldClose(app.windowManager.getWindow())) {
+        fps.beginFrame();
+        app.beginFrame();
+        storeViewExtent();
+
+        ImGui_ImplVulkan_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        if(uiCallback){
+            uiWaiting = true;
+            std::unique_lock<std::mutex> lock(sceneMutex);
+            spatialStale = true;
+            uiCallback(*this, fps);
+            publishSnapshot();
+            uiWaiting = false;
+            lock.unlock();
+            uiDone.notify_one();
+        }
+        //RENDER
+        ImGui::Render();
+        DirtyFlags frameFlags{false, false};
+        frameFlags.texts = false;
+        frameFlags.glyphs = false;
+        frameFlags.edges = false;
+        if(snapshots.consume()){
+            const SceneSnapshot& snapshot = snapshots.readBuffer();
+            frameFlags.meshes = snapshot.meshVersion != meshVersionSeen;
+            frameFlags.ssbo = snapshot.outlineVersion != outlineVersionSeen;
+            frameFlags.tweens = snapshot.tweenVersion != tweenVersionSeen;
+            meshVersionSeen = snapshot.meshVersion;
+            outlineVersionSeen = snapshot.outlineVersion;
+            tweenVersionSeen = snapshot.tweenVersion;
+            frameFlags.texts = snapshot.textVersion != textVersionSeen;
+            frameFlags.glyphs = snapshot.glyphVersion != glyphVersionSeen;
+            textVersionSeen = snapshot.textVersion;
+            glyphVersionSeen = snapshot.glyphVersion;
+            frameFlags.edges = snapshot.edgeVersion != edgeVersionSeen;
+            edgeVersionSeen = snapshot.edgeVersion;
+        }
+        applyView(snapshots.readBuffer().view);
+        app.recordSnapshot(snapshots.readBuffer(), frameFlags);
+        app.renderFrame();
+
+        fps.endFrame();
+        if(EXIT_ || updateFailed){
+            break;
+        }
+    }
+    stopUpdateThread();
+    if(updateFailed){
+        std::rethrow_exception(updateError);
+    }
+}
+
+// Joins the update thread once, then waits for the device so nothing it published is still being drawn
+void ThING::API::stopUpdateThread() {
+    if(!updateThread.joinable()){
+        return;
+    }
+    updateRunning = false;
+    {
+        // A UI callback that threw never cleared its flag, the update thread would wait on it forever
+        std::lock_guard<std::mutex> lock(sceneMutex);
+        uiWaiting = false;
+    }
+    uiDone.notify_one();
+    updateThread.join();
+    vkDeviceWaitIdle(app.device);
+}
+
+void ThING::API::updateLoop() {
+    FPSCounter fps;
+    try {
+        while(updateRunning){
+            fps.beginFrame();
+            {
+                // Let a waiting UI callback in first, otherwise a fast update loop can keep the lock forever. The wait
+                // hands sceneMutex over and the UI clears the flag before giving it back
+                std::unique_lock<std::mutex> lock(sceneMutex);
+                uiDone.wait(lock, [this]{return !uiWaiting;});
+                spatialStale = true;
+                if(updateCallback) updateCallback(*this, fps);
+                stepScheduler.run();
+                publishSnapshot();
+            }
+            fps.endFrame();
+        }
+    } catch (...) {
+        updateError = std::current_exception();
+        updateFailed = true;
+    }
+}
+
+// Called with sceneMutex held. Outline resyncs happen here, on the writer side, so the remapped objectIDs
+// stick to the instances instead of to a snapshot copy
+void ThING::API::publishSnapshot() {
+    drainEdits();
+    ingestGraph();
+    streamTiles();
+    expireTweens();
+    dropCircleLinks();
+    std::span<InstanceData> lines(reinterpret_cast<InstanceData*>(lineInstances.data()), lineInstances.size());
+    if(dirtyFlags.ssbo){
+        app.syncOutlines(circleInstances, lines, polygonInstances);
+        trackOutlineSlots();
+        markInstancesWritten();
+    }
+    recordTimeline(); // after the resync so the recorded objectIDs are the ones the snapshot gets
+    if(dirtyFlags.meshes){
+        meshVersion++;
+    }
+    if(!app.outlineManager.viewDirtySlots().empty()){
+        outlineVersion++;
+        app.outlineManager.clearDirty();
+    }
+    if(!app.tweenManager.viewDirtySlots().empty()){
+        tweenVersion++;
+        app.tweenManager.clearDirty();
+    }
+    if(dirtyFlags.texts){
+        textVersion++;
+    }
+    if(dirtyFlags.glyphs){
+        glyphVersion++;
+    }
+    if(dirtyFlags.edges){
+        edgeVersion++;
+    }
+    dirtyFlags.ssbo = false;
+    dirtyFlags.meshes = false;
+    dirtyFlags.texts = false;
+    dirtyFlags.glyphs = false;
+    dirtyFlags.edges = false;
+
+    SceneSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.circleInstances.assign(circleInstances.begin(), circleInstances.end());
+    snapshot.polygonInstances.assign(polygonInstances.begin(), polygonInstances.end());
+    snapshot.lineInstances.assign(lineInstances.begin(), lineInstances.end());
+    snapshot.polygonMeshes.assign(polygonMeshes.begin(), polygonMeshes.end());
+
+    if(snapshot.meshVersion != meshVersion){
+        snapshot.vertices.assign(app.vertices.begin(), app.vertices.end());
+        snapshot.indices.assign(app.indices.begin(), app.indices.end());
+        snapshot.meshVersion = meshVersion;
+    }
+    if(snapshot.outlineVersion != outlineVersion){
+        std::span<const SSBO> slots = app.outlineManager.viewSlots();
+        snapshot.outlines.assign(slots.begin(), slots.end());
+        snapshot.outlineSlots.resize(slots.size());
+        std::iota(snapshot.outlineSlots.begin(), snapshot.outlineSlots.end(), 0u);
+        snapshot.outlineVersion = outlineVersion;
+    }
+    if(snapshot.tweenVersion != tweenVersion){
+        std::span<const TweenData> slots = app.tweenManager.viewSlots();
+        snapshot.tweens.assign(slots.begin(), slots.end());
+        snapshot.tweenSlots.resize(slots.size());
+        std::iota(snapshot.tweenSlots.begin(), snapshot.tweenSlots.end(), 0u);
+        snapshot.tweenVersion = tweenVersion;
+    }
+    if(snapshot.textVersion != textVersion){
+        snapshot.texts.assign(texts.begin(), texts.end());
+        snapshot.textVersion = textVersion;
+    }
+    if(snapshot.glyphVersion != glyphVersion){
+        snapshot.glyphs.assign(glyphs.begin(), glyphs.end());
+        snapshot.glyphVersion = glyphVersion;
+    }
+    if(snapshot.edgeVersion != edgeVersion){
+        snapshot.edges.assign(edges.begin(), edges.end());
+        snapshot.edgeVersion = edgeVersion;
+    }
+    snapshot.maxOutlineSize = app.outlineManager.getMaxOutlineSize();
+    snapshot.view = view;
+    snapshots.publish();
+}
+
+// Indices can be reserved ahead of the vector by queueX, the gap is filled with dead instances until
+// their edit is applied
+template <typename T>
+static void placeInstance(std::vector<T>& instances, uint32_t index, const T& value){
+    if(index >= instances.size()){
+        T dead = value;
+        dead.alive = 0;
+        dead.objectID = 0;
+        instances.resize(index + 1, dead);
+    }
+    instances[index] = value;
+}
+
+// Reserved counters hold epoch << 32 | next index. Returns the first of count indices, epoch gets the one they
+// belong to
+static uint32_t reserveIndices(std::atomic<uint64_t>& reserved, uint32_t count, uint32_t* epoch = nullptr){
+    const uint64_t previous = reserved.fetch_add(count, std::memory_order_relaxed);
+    if(epoch != nullptr){
+        *epoch = static_cast<uint32_t>(previous >> 32);
+    }
+    return static_cast<uint32_t>(previous);
+}
+
+// Consumer side only. A producer reserving between the load and the store gets the old epoch and its edit is dropped
+static void restartReserved(std::atomic<uint64_t>& reserved, uint32_t next){
+    const uint64_t epoch = (reserved.load(std::memory_order_relaxed) >> 32) + 1;
+    reserved.store((epoch << 32) | next, std::memory_order_relaxed);
+}
+
 Entity ThING::API::addCircle(InstanceData&& instance){
     Entity e;
     if(circleFreeList.empty()){
-        circleInstances.push_back(std::move(instance));
-        e = {static_cast<uint32_t>(circleInstances.size() - 1), InstanceType::Circle};
-        return e;
+        e = {reserveIndices(circleReserved, 1), InstanceType::Circle};
+        placeInstance(circleInstances, e.index, instance);
     } else {
+        dropCircleLinks(); // the slot may be one of them
         e = circleFreeList.back();
         circleFreeList.pop_back();
         circleInstances[e.index] = std::move(instance);
-        return e;
     }
+    markWritten(e);
+    dirtyFlags.circles = true;
+    markSpatial(e);
+    return e;
 };
 
 Entity ThING::API::addLine(LineData&& instance){
     Entity e;
     if(lineFreeList.empty()){
-        lineInstances.push_back(std::move(instance));
-        e = {static_cast<uint32_t>(lineInstances.size() - 1), InstanceType::Line};
-        return e;
+        e = {reserveIndices(lineReserved, 1), InstanceType::Line};
+        placeInstance(lineInstances, e.index, instance);
     } else {
         e = lineFreeList.back();
         lineFreeList.pop_back();
         lineInstances[e.index] = std::move(instance);
-        return e;
     }
+    markWritten(e);
+    markSpatial(e);
+    return e;
 }
 
 //PUBLIC
 
 uint32_t ThING::API::getInstanceCount(InstanceType type){
-    size_t count = 0;
-    switch (type) {
-        case InstanceType::Polygon:
-            for(InstanceData instance : polygonInstances){
-                if(instance.alive){
-                    count++;
-                }
-            }
-            return count;
-        case InstanceType::Circle:
-            for(InstanceData instance : circleInstances){
-                if(instance.alive){
-                    count++;
-                }
-            }
-            return count;
-        case InstanceType::Line:
-            for(LineData instance : lineInstances){
-                if(instance.alive){
-                    count++;
-                }
-            }
-            return count;
-        case InstanceType::Count: std::unreachable();
-        default: std::unreachable();
-    }
+    // Read only, getInstanceVector would mark the whole vector written
+    const std::span<const InstanceData> instances = viewInstanceVector(type);
+    std::atomic<uint32_t> count = 0;
+    app.jobSystem.parallelForRange(instances.size(), 0x4000, [&](size_t begin, size_t end){
+        uint32_t localCount = 0;
+        for(size_t i = begin; i < end; i++){
+            localCount += instances[i].alive ? 1 : 0;
+        }
+        count.fetch_add(localCount, std::memory_order_relaxed);
+    });
+    return count;
 }
 
 void ThING::API::getWindowSize(int* x, int* y){
-    glfwGetWindowSize(app.windowManager.getWindow(), x, y);
-    return;
+    const uint64_t size = windowSize.load(std::memory_order_relaxed);
+    *x = static_cast<int>(size >> 32);
+    *y = static_cast<int>(size & 0xFFFFFFFF);
 }
 
 Entity ThING::API::addCircle(glm::vec2 pos, float size, glm::vec4 color){
@@ -184,32 +447,68 @@ Entity ThING::API::addCircle(glm::vec2 pos, float size, glm::vec4 color){
 }
 
 std::span<InstanceData> ThING::API::getInstanceVector(InstanceType type){
+    spatialStale = true;
+    switch (type) {
+        case InstanceType::Polygon:
+            markAllWritten(TimelineStream::Polygons);
+            return polygonInstances;
+        case InstanceType::Circle: // can't tell what gets written
+            dirtyFlags.circles = true;
+            markAllWritten(TimelineStream::Circles);
+            return circleInstances;
+        case InstanceType::Line:
+            markAllWritten(TimelineStream::Lines);
+            return {reinterpret_cast<InstanceData*>(lineInstances.data()), lineInstances.size()};
+        case InstanceType::Count: std::unreachable();
+        default: std::unreachable();
+    }
+}
+
+std::span<const InstanceData> ThING::API::viewInstanceVector(InstanceType type) const{
     switch (type) {
         case InstanceType::Polygon: return polygonInstances;
         case InstanceType::Circle: return circleInstances;
-        case InstanceType::Line: return {reinterpret_cast<InstanceData*>(lineInstances.data()), lineInstances.size()};
+        case InstanceType::Line: return {reinterpret_cast<const InstanceData*>(lineInstances.data()), lineInstances.size()};
         case InstanceType::Count: std::unreachable();
         default: std::unreachable();
     }
 }
 
 std::span<LineData> ThING::API::getLineVector(){
+    spatialStale = true;
+    markAllWritten(TimelineStream::Lines);
     return lineInstances;
 }
 
 void ThING::API::setZoom(float zoom){
-    app.zoom = zoom;
+    view.zoom = zoom;
+    if(!(apiFlags & ApiFlags_ThreadedUpdate)){
+        applyView(view);
+    }
 }
 
 void ThING::API::setOffset(glm::vec2 offset){
-    app.offset = offset;
+    view.offset = offset;
+    if(!(apiFlags & ApiFlags_ThreadedUpdate)){
+        applyView(view);
+    }
 }
 
 void ThING::API::setBackgroundColor(glm::vec4 color){
-    app.clearColor[0].color.float32[0] = color.x;
-    app.clearColor[0].color.float32[1] = color.y;
-    app.clearColor[0].color.float32[2] = color.z;
-    app.clearColor[0].color.float32[3] = color.w;
+    view.background = color;
+    if(!(apiFlags & ApiFlags_ThreadedUpdate)){
+        applyView(view);
+    }
+}
+
+// Render thread (or the only thread)
+void ThING::API::applyView(const ViewState& state){
+    app.zoom = state.zoom;
+    app.offset = state.offset;
+    app.clearColor[0].color.float32[0] = state.background.x;
+    app.clearColor[0].color.float32[1] = state.background.y;
+    app.clearColor[0].color.float32[2] = state.background.z;
+    app.clearColor[0].color.float32[3] = state.background.w;
 }
 
 Entity ThING::API::addPolygon(glm::vec2 pos, glm::vec4 color, glm::vec2 scale, std::span<Vertex> ver, std::span<uint16_t> ind){
@@ -244,7 +543,10 @@ Entity ThING::API::addPolygon(glm::vec2 pos, glm::vec4 color, glm::vec2 scale, s
     }
     app.vertices.insert(app.vertices.end(), ver.begin(), ver.end());
     app.indices.insert(app.indices.end(), ind.begin(), ind.end());
+    markWritten(e);
+    markWritten(TimelineStream::Meshes, e.index);
     dirtyFlags.meshes = true;
+    markSpatial(e);
     return e;
 }
 
@@ -281,7 +583,10 @@ Entity ThING::API::addPolygon(glm::vec2 pos, glm::vec4 color, glm::vec2 scale, s
     }
     app.vertices.insert(app.vertices.end(), std::make_move_iterator(ver.begin()), std::make_move_iterator(ver.end()));
     app.indices.insert(app.indices.end(), std::make_move_iterator(ind.begin()), std::make_move_iterator(ind.end()));
+    markWritten(e);
+    markWritten(TimelineStream::Meshes, e.index);
     dirtyFlags.meshes = true;
+    markSpatial(e);
     return e;
 }
 
@@ -323,18 +628,31 @@ bool ThING::API::deleteInstance(const Entity e){
     if(!exists(e)){
         return false;
     }
+    markWritten(e);
+    markSpatial(e);
     switch (e.type) {
         case InstanceType::Polygon:
+            app.outlineManager.release(std::exchange(outlineSlot(e), 0u));
+            app.tweenManager.release(polygonInstances[e.index].tweenSlot);
+            polygonInstances[e.index].tweenSlot = 0;
             polygonInstances[e.index].alive = false;
             polygonInstances[e.index].objectID = 0;
             polygonFreeList.push_back(e);
             return true;
         case InstanceType::Circle:
+            app.outlineManager.release(std::exchange(outlineSlot(e), 0u));
+            app.tweenManager.release(circleInstances[e.index].tweenSlot);
+            circleInstances[e.index].tweenSlot = 0;
+            dirtyFlags.circles = true;
             circleInstances[e.index].alive = false;
             circleInstances[e.index].objectID = 0;
             circleFreeList.push_back(e);
+            freedCircles.push_back(e.index);
             return true;
         case InstanceType::Line:
+            app.outlineManager.release(std::exchange(outlineSlot(e), 0u));
+            app.tweenManager.release(lineInstances[e.index].tweenSlot);
+            lineInstances[e.index].tweenSlot = 0;
             lineInstances[e.index].alive = false;
             lineInstances[e.index].objectID = 0;
             lineFreeList.push_back(e);
@@ -345,12 +663,15 @@ bool ThING::API::deleteInstance(const Entity e){
 }
 
 InstanceData& ThING::API::getInstance(const Entity e){
+    markWritten(e);
+    markSpatial(e);
     switch (e.type) {
         case InstanceType::Polygon: 
             assert(e.index < polygonInstances.size() && "Invalid Entity passed to getInstance"); 
             return polygonInstances[e.index];
         case InstanceType::Circle: 
             assert(e.index < circleInstances.size() && "Invalid Entity passed to getInstance"); 
+            dirtyFlags.circles = true;
             return circleInstances[e.index];
         case InstanceType::Line:
             assert(e.index < lineInstances.size() && "Invalid Entity passed to getInstance");
@@ -362,6 +683,8 @@ InstanceData& ThING::API::getInstance(const Entity e){
 
 LineData& ThING::API::getLine(const Entity e){
     if(e.type == InstanceType::Line){
+        markWritten(e);
+        markSpatial(e);
         return lineInstances[e.index];
     }
     std::unreachable();
@@ -420,8 +743,7 @@ bool ThING::API::playAudio(const std::string& soundFile){
 }
 
 bool ThING::API::playAudio(const std::string& soundFile, uint8_t volume){
-    //Can be optimized by replaying instead of reloading, not high performance impact right now to bother
-    //Do if you/I need to play a lot of sounds at high speeds
+    //Opens and decodes the file every time, use loadSound + playAudio(SoundHandle) for sounds played a lot
     volume = this->volume * volume / 255.f;
     static bool first = true;
     static ma_sound_group playVolumeGroup{};
@@ -444,23 +766,947 @@ bool ThING::API::playAudio(const std::string& soundFile, uint8_t volume){
     return true;
 }
 
+bool ThING::API::playAudio(SoundHandle sound, uint8_t volume, float pitch){
+    static uint8_t vol = 0;
+    static bool first = true;
+    if(first || vol != this->volume){
+        vol = this->volume;
+        soundPool.setVolume(glm::pow((float)vol / 255.f, 2));
+        first = false;
+    }
+    return soundPool.play(sound, glm::pow((float)volume / 255.f, 2), pitch);
+}
+
+bool ThING::API::playTone(float frequency, float duration, uint8_t volume, Waveform waveform){
+    static uint8_t vol = 0;
+    static bool first = true;
+    if(first || vol != this->volume){
+        vol = this->volume;
+        synth.setVolume(glm::pow((float)vol / 255.f, 2));
+        first = false;
+    }
+    return synth.play({frequency, duration, glm::pow((float)volume / 255.f, 2), waveform});
+}
+
 void ThING::API::clearInstanceVector(InstanceType type){
+    spatialStale = true;
     switch (type) {
         case InstanceType::Circle:
+            graphLoader.cancel(); // its edges would point at whatever gets added next
+            tileSlots.clear();
+            tileStreamer.invalidate();
+            releaseOutlines(circleOutlineSlots);
+            releaseTweens(circleInstances);
             circleInstances.clear();
+            markAllWritten(TimelineStream::Circles);
             circleFreeList.clear();
+            freedCircles.clear();
+            restartReserved(circleReserved, 0);
+            dirtyFlags.circles = true;
+            clearEdges(); // every edge hangs off two circles
+            for(uint32_t i = 0; i < texts.size(); i++){
+                if(texts[i].alive && texts[i].anchor != NO_TEXT_ANCHOR) deleteText(i);
+            }
             break;
         case InstanceType::Line:
+            releaseOutlines(lineOutlineSlots);
+            releaseTweens(getInstanceVector(InstanceType::Line));
             lineInstances.clear();
+            markAllWritten(TimelineStream::Lines);
             lineFreeList.clear();
+            restartReserved(lineReserved, 0);
             break;
         case InstanceType::Polygon:
+            releaseOutlines(polygonOutlineSlots);
+            releaseTweens(polygonInstances);
             polygonInstances.clear();
             polygonMeshes.clear();
+            markAllWritten(TimelineStream::Polygons);
+            markAllWritten(TimelineStream::Meshes);
             polygonFreeList.clear();
+            polygonEpoch.fetch_add(1, std::memory_order_relaxed);
             break;
         case InstanceType::Count:
             std::unreachable();
             break;
     }
-}
\ No newline at end of file
+}
+
+bool ThING::API::setOutline(const Entity e, float size, glm::vec4 color, uint32_t groupID){
+    if(!exists(e)){
+        return false;
+    }
+    InstanceData& instance = getInstance(e);
+    instance.outlineSize = size;
+    instance.outlineColor = color;
+    instance.groupID = groupID;
+    return updateOutline(e);
+}
+
+bool ThING::API::updateOutline(const Entity e){
+    if(!exists(e)){
+        return false;
+    }
+    InstanceData& instance = getInstance(e);
+    uint32_t& slot = outlineSlot(e);
+    if(app.outlineManager.isShared(slot)){
+        app.outlineManager.release(slot); // copy on write, the others keep the outline they had
+        slot = 0;
+    }
+    if(!app.outlineManager.isLive(slot)){
+        slot = app.outlineManager.acquire();
+    }
+    instance.objectID = slot;
+    if(slot == 0){
+        return false;
+    }
+    const uint32_t enabled = (instance.outlineSize > 0.0f) ? 1u : 0u;
+    app.outlineManager.write(instance.objectID, {instance.outlineColor, instance.outlineSize, instance.groupID, enabled});
+    return true;
+}
+
+bool ThING::API::removeOutline(const Entity e){
+    if(!exists(e)){
+        return false;
+    }
+    InstanceData& instance = getInstance(e);
+    app.outlineManager.release(std::exchange(outlineSlot(e), 0u));
+    instance.objectID = 0;
+    instance.outlineSize = 0.0f;
+    return true;
+}
+
+bool ThING::API::readGpuPositions(std::vector<glm::vec2>& positions){
+    return app.gpuPhysics.readPositions(app.device, app.swapChainManager.getFrameTimeline(), app.bufferManager, positions);
+}
+
+size_t ThING::API::queryPoint(glm::vec2 point, std::vector<Entity>& out){
+    out.clear();
+    refitSpatialIndex().queryPoint(point, out);
+    return out.size();
+}
+
+size_t ThING::API::queryRect(glm::vec2 min, glm::vec2 max, std::vector<Entity>& out){
+    out.clear();
+    refitSpatialIndex().queryRect(glm::min(min, max), glm::max(min, max), out);
+    return out.size();
+}
+
+size_t ThING::API::queryRadius(glm::vec2 center, float radius, std::vector<Entity>& out){
+    out.clear();
+    refitSpatialIndex().queryRadius(center, radius, out);
+    return out.size();
+}
+
+Entity ThING::API::nearest(glm::vec2 point, float maxDistance){
+    return refitSpatialIndex().nearest(point, maxDistance);
+}
+
+// Lazy so a frame without queries costs nothing, and a frame full of them refits once. Between queries only the
+// entities handed out since are looked at again
+const SpatialIndex& ThING::API::refitSpatialIndex(){
+    if(spatialStale){
+        spatialIndex.refit(circleInstances, lineInstances, polygonInstances, polygonMeshes, app.vertices, app.jobSystem);
+        spatialStale = false;
+    } else if(!spatialDirty.empty()){
+        spatialIndex.refit(spatialDirty, circleInstances, lineInstances, polygonInstances, polygonMeshes, app.vertices);
+    }
+    spatialDirty.clear();
+    return spatialIndex;
+}
+
+// Past a few thousand entities one parallel full refit is cheaper than walking the list
+void ThING::API::markSpatial(const Entity e){
+    if(spatialStale) return;
+    if(spatialDirty.size() >= MAX_SPATIAL_DIRTY){
+        spatialStale = true;
+        spatialDirty.clear();
+        return;
+    }
+    spatialDirty.push_back(e);
+}
+
+bool ThING::API::readPick(uint64_t ticket, std::vector<Entity>& out){
+    return app.pickManager.read(ticket, app.device, app.swapChainManager.getFrameTimeline(), app.bufferManager, out);
+}
+
+uint32_t ThING::API::addEdge(const Entity from, const Entity to, float thickness, glm::vec4 color){
+    if(from.type != InstanceType::Circle || to.type != InstanceType::Circle || !exists(from) || !exists(to)){
+        return INVALID_EDGE;
+    }
+    const EdgeData edge{from.index, to.index, thickness, glm::packUnorm4x8(color)};
+    uint32_t index;
+    if(edgeFreeList.empty()){
+        index = static_cast<uint32_t>(edges.size());
+        edges.push_back(edge);
+    } else {
+        index = edgeFreeList.back();
+        edgeFreeList.pop_back();
+        edges[index] = edge;
+    }
+    markWritten(TimelineStream::Edges, index);
+    dirtyFlags.edges = true;
+    return index;
+}
+
+bool ThING::API::deleteEdge(uint32_t edge){
+    if(edge >= edges.size() || edges[edge].from == DEAD_EDGE_NODE){
+        return false;
+    }
+    edges[edge].from = DEAD_EDGE_NODE;
+    edges[edge].to = DEAD_EDGE_NODE;
+    edgeFreeList.push_back(edge);
+    markWritten(TimelineStream::Edges, edge);
+    dirtyFlags.edges = true;
+    return true;
+}
+
+EdgeData& ThING::API::getEdge(uint32_t edge){
+    assert(edge < edges.size() && "Invalid edge passed to getEdge");
+    markWritten(TimelineStream::Edges, edge);
+    dirtyFlags.edges = true;
+    return edges[edge];
+}
+
+void ThING::API::clearEdges(){
+    edges.clear();
+    edgeFreeList.clear();
+    markAllWritten(TimelineStream::Edges);
+    dirtyFlags.edges = true;
+}
+
+// Edges and labels of deleted circles go with them before the slot is handed out again. One pass over both per
+// batch of deletes instead of one per delete, the edges are scanned on the job system
+void ThING::API::dropCircleLinks(){
+    if(freedCircles.empty()){
+        return;
+    }
+    std::vector<uint8_t> freed(circleInstances.size(), 0);
+    for(uint32_t circle : freedCircles){
+        freed[circle] = 1;
+    }
+    freedCircles.clear();
+    auto gone = [&](uint32_t circle){return circle < freed.size() && freed[circle];};
+
+    std::vector<uint32_t> dropped;
+    std::mutex droppedMutex;
+    app.jobSystem.parallelForRange(edges.size(), GRAPH_INGEST_GRAIN, [&](size_t begin, size_t end){
+        std::vector<uint32_t> local;
+        for(size_t i = begin; i < end; i++){
+            EdgeData& edge = edges[i];
+            if(edge.from != DEAD_EDGE_NODE && (gone(edge.from) || gone(edge.to))){
+                edge.from = DEAD_EDGE_NODE;
+                edge.to = DEAD_EDGE_NODE;
+                local.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        if(!local.empty()){
+            std::lock_guard<std::mutex> lock(droppedMutex);
+            dropped.insert(dropped.end(), local.begin(), local.end());
+        }
+    });
+    for(uint32_t edge : dropped){
+        edgeFreeList.push_back(edge);
+        markWritten(TimelineStream::Edges, edge);
+    }
+    if(!dropped.empty()){
+        dirtyFlags.edges = true;
+    }
+
+    for(uint32_t i = 0; i < texts.size(); i++){
+        if(texts[i].alive && texts[i].anchor != NO_TEXT_ANCHOR && gone(texts[i].anchor)) deleteText(i);
+    }
+}
+
+uint32_t ThING::API::addText(std::string_view text, glm::vec2 position, float size, glm::vec4 color, glm::vec2 pivot){
+    TextData data{};
+    data.position = position;
+    data.size = size;
+    data.color = color;
+    return placeText(std::move(data), text, pivot);
+}
+
+uint32_t ThING::API::addLabel(const Entity circle, std::string_view text, float size, glm::vec4 color, glm::vec2 offset, glm::vec2 pivot){
+    if(circle.type != InstanceType::Circle || !exists(circle)){
+        return INVALID_TEXT;
+    }
+    TextData data{};
+    data.position = offset;
+    data.size = size;
+    data.color = color;
+    data.anchor = circle.index;
+    return placeText(std::move(data), text, pivot);
+}
+
+uint32_t ThING::API::placeText(TextData&& text, std::string_view string, glm::vec2 pivot){
+    uint32_t index;
+    if(textFreeList.empty()){
+        if(texts.size() >= MAX_TEXTS){
+            return INVALID_TEXT;
+        }
+        index = static_cast<uint32_t>(texts.size());
+        texts.push_back(text);
+        textStrings.emplace_back(string);
+        textRuns.push_back({});
+    } else {
+        index = textFreeList.back();
+        textFreeList.pop_back();
+        texts[index] = text;
+        textStrings[index] = string;
+    }
+    textRuns[index].pivot = pivot;
+    layoutGlyphs(index);
+    dirtyFlags.texts = true;
+    return index;
+}
+
+bool ThING::API::setText(uint32_t text, std::string_view string){
+    if(text >= texts.size() || !texts[text].alive){
+        return false;
+    }
+    textStrings[text] = string;
+    layoutGlyphs(text);
+    return true;
+}
+
+const std::string& ThING::API::getTextString(uint32_t text){
+    assert(text < textStrings.size() && "Invalid text passed to getTextString");
+    return textStrings[text];
+}
+
+bool ThING::API::deleteText(uint32_t text){
+    if(text >= texts.size() || !texts[text].alive){
+        return false;
+    }
+    texts[text].alive = 0;
+    textStrings[text].clear();
+    wasteGlyphs(text);
+    textFreeList.push_back(text);
+    dirtyFlags.texts = true;
+    if(glyphWaste > TEXT_COMPACT_GLYPHS && glyphWaste > glyphs.size() / 2){
+        compactGlyphs();
+    }
+    return true;
+}
+
+TextData& ThING::API::getText(uint32_t text){
+    assert(text < texts.size() && "Invalid text passed to getText");
+    dirtyFlags.texts = true;
+    return texts[text];
+}
+
+void ThING::API::clearTexts(){
+    texts.clear();
+    glyphs.clear();
+    textStrings.clear();
+    textRuns.clear();
+    textFreeList.clear();
+    glyphWaste = 0;
+    dirtyFlags.texts = true;
+    dirtyFlags.glyphs = true;
+}
+
+// Rewrites the run in place when the string still fits, a shorter string leaves DEAD_GLYPH behind for the next
+// one to grow into
+void ThING::API::layoutGlyphs(uint32_t text){
+    TextRun& run = textRuns[text];
+    const uint32_t count = countGlyphs(textStrings[text]);
+    if(count > run.capacity){
+        wasteGlyphs(text);
+        run.first = static_cast<uint32_t>(glyphs.size());
+        run.capacity = count;
+        glyphs.resize(glyphs.size() + count);
+    }
+    const std::span<GlyphData> dst(glyphs.data() + run.first, run.capacity);
+    run.count = layoutText(textStrings[text], run.pivot, text, dst);
+    std::fill(dst.begin() + run.count, dst.end(), GlyphData{{0.0f, 0.0f}, 0, DEAD_GLYPH});
+    dirtyFlags.glyphs = true;
+    if(glyphWaste > TEXT_COMPACT_GLYPHS && glyphWaste > glyphs.size() / 2){
+        compactGlyphs();
+    }
+}
+
+void ThING::API::wasteGlyphs(uint32_t text){
+    TextRun& run = textRuns[text];
+    std::fill_n(glyphs.begin() + run.first, run.capacity, GlyphData{{0.0f, 0.0f}, 0, DEAD_GLYPH});
+    glyphWaste += run.capacity;
+    run.count = 0;
+    run.capacity = 0;
+    dirtyFlags.glyphs = true;
+}
+
+// Copies the live glyphs of every text next to each other, in text order, runs shrink to what they hold
+void ThING::API::compactGlyphs(){
+    std::vector<GlyphData> packed;
+    packed.reserve(glyphs.size() - std::min(glyphWaste, glyphs.size()));
+    for(uint32_t i = 0; i < texts.size(); i++){
+        TextRun& run = textRuns[i];
+        const uint32_t first = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(), glyphs.begin() + run.first, glyphs.begin() + run.first + run.count);
+        run.first = first;
+        run.capacity = run.count;
+    }
+    glyphs = std::move(packed);
+    glyphWaste = 0;
+    dirtyFlags.glyphs = true;
+}
+
+void ThING::API::releaseOutlines(std::vector<uint32_t>& slots){
+    for(uint32_t slot : slots){
+        app.outlineManager.release(slot);
+    }
+    slots.clear();
+}
+
+std::vector<uint32_t>& ThING::API::outlineSlots(InstanceType type){
+    switch (type) {
+        case InstanceType::Polygon: return polygonOutlineSlots;
+        case InstanceType::Circle: return circleOutlineSlots;
+        case InstanceType::Line: return lineOutlineSlots;
+        case InstanceType::Count: std::unreachable();
+    }
+    std::unreachable();
+}
+
+uint32_t& ThING::API::outlineSlot(const Entity e){
+    std::vector<uint32_t>& slots = outlineSlots(e.type);
+    if(e.index >= slots.size()){
+        slots.resize(e.index + 1, 0);
+    }
+    return slots[e.index];
+}
+
+// After syncOutlines or adoptOutlines every objectID is a slot the manager handed out again
+void ThING::API::trackOutlineSlots(){
+    auto track = [](std::span<const InstanceData> instances, std::vector<uint32_t>& slots){
+        slots.resize(instances.size());
+        for(uint32_t i = 0; i < instances.size(); i++){
+            slots[i] = instances[i].alive ? instances[i].objectID : 0;
+        }
+    };
+    track(circleInstances, circleOutlineSlots);
+    track({reinterpret_cast<const InstanceData*>(lineInstances.data()), lineInstances.size()}, lineOutlineSlots);
+    track(polygonInstances, polygonOutlineSlots);
+}
+
+void ThING::API::releaseTweens(std::span<InstanceData> instances){
+    for(const InstanceData& instance : instances){
+        app.tweenManager.release(instance.tweenSlot);
+    }
+}
+
+// The slot holds the track, the instance already holds the target, so the value to start from has to be read
+// before it gets overwritten. Same fields the vertex shader swaps, lines use them as point1, point2 and thickness
+static glm::vec4 readProperty(const InstanceData& instance, TweenProperty property){
+    switch (property) {
+        case TweenProperty::Position: return {instance.position, 0.0f, 0.0f};
+        case TweenProperty::Scale: return {instance.scale, 0.0f, 0.0f};
+        case TweenProperty::Rotation: return {instance.rotation, 0.0f, 0.0f, 0.0f};
+        case TweenProperty::Color: return instance.color;
+        case TweenProperty::Count: std::unreachable();
+    }
+    std::unreachable();
+}
+
+static void writeProperty(InstanceData& instance, TweenProperty property, glm::vec4 value){
+    switch (property) {
+        case TweenProperty::Position: instance.position = glm::vec2(value); return;
+        case TweenProperty::Scale: instance.scale = glm::vec2(value); return;
+        case TweenProperty::Rotation: instance.rotation = value.x; return;
+        case TweenProperty::Color: instance.color = value; return;
+        case TweenProperty::Count: std::unreachable();
+    }
+}
+
+bool ThING::API::animate(const Entity e, TweenProperty property, glm::vec4 target, float duration, Easing easing){
+    if(!exists(e) || property >= TweenProperty::Count){
+        return false;
+    }
+    InstanceData& instance = getInstance(e);
+    const glm::vec4 current = readProperty(instance, property);
+    writeProperty(instance, property, target);
+    if(duration <= 0.0f){
+        app.tweenManager.stop(instance.tweenSlot, property); // jumps, a running tween of it too
+        return true;
+    }
+    const uint32_t slot = app.tweenManager.start(instance.tweenSlot, e, property, current, target, duration, easing);
+    if(slot == 0){
+        return false; // out of slots, it still jumps to the target
+    }
+    instance.tweenSlot = slot;
+    return true;
+}
+
+bool ThING::API::finishAnimations(const Entity e){
+    if(!exists(e)){
+        return false;
+    }
+    InstanceData& instance = getInstance(e);
+    app.tweenManager.release(instance.tweenSlot);
+    instance.tweenSlot = 0;
+    return true;
+}
+
+// Once per frame, before the instances get recorded. Only touches the instances whose last tween just ended
+void ThING::API::expireTweens(){
+    for(const Entity e : app.tweenManager.expire()){
+        if(!exists(e)){
+            continue;
+        }
+        getInstance(e).tweenSlot = 0;
+    }
+}
+void ThING::API::recordTimeline(){
+    if(!timelineRecorder.isRecording()){
+        return;
+    }
+    timelineRecorder.capture(viewScene(), dirtyFlags.meshes, app.jobSystem);
+}
+
+TimelineScene ThING::API::viewScene(){
+    return {
+        circleInstances,
+        std::span<const InstanceData>(reinterpret_cast<const InstanceData*>(lineInstances.data()), lineInstances.size()),
+        polygonInstances,
+        edges,
+        polygonMeshes,
+        app.vertices,
+        app.indices
+    };
+}
+
+TimelineTarget ThING::API::sceneTarget(){
+    return {circleInstances, lineInstances, polygonInstances, edges, polygonMeshes, app.vertices, app.indices};
+}
+
+bool ThING::API::startRecording(const std::string& path, uint32_t keyframeInterval){
+    return timelineRecorder.start(path, keyframeInterval);
+}
+
+bool ThING::API::openTimeline(const std::string& path){
+    if(!timelinePlayer.open(path)){
+        return false;
+    }
+    // Frame 0 is a keyframe and overwrites everything anyway, clearing first hands the outline and tween slots back
+    clearInstanceVector(InstanceType::Circle);
+    clearInstanceVector(InstanceType::Line);
+    clearInstanceVector(InstanceType::Polygon);
+    clearEdges();
+    return seekTimeline(0);
+}
+
+bool ThING::API::seekTimeline(uint64_t frame){
+    uint32_t touched = 0;
+    const bool seeked = timelinePlayer.seek(frame, sceneTarget(), touched);
+    if(touched == 0){
+        return seeked;
+    }
+    constexpr uint32_t meshStreams = 1u << static_cast<uint32_t>(TimelineStream::Meshes) |
+        1u << static_cast<uint32_t>(TimelineStream::Vertices) | 1u << static_cast<uint32_t>(TimelineStream::Indices);
+    snapshotStore.markAllDirty();
+    adoptScene(touched & meshStreams);
+    return seeked;
+}
+
+bool ThING::API::loadScene(const std::string& path){
+    if(!loadSceneFile(path, sceneTarget(), app.jobSystem)){
+        return false;
+    }
+    app.tweenManager.reset(); // everything came in with slot 0, the old scene's slots have no owner left
+    timelinePlayer.invalidate();
+    snapshotStore.markAllDirty();
+    adoptScene(true);
+    return true;
+}
+
+uint64_t ThING::API::takeSnapshot(){
+    return snapshotStore.take(viewScene(), app.jobSystem);
+}
+
+bool ThING::API::restoreSnapshot(uint64_t snapshot){
+    if(!snapshotStore.restore(snapshot, sceneTarget())){
+        return false;
+    }
+    timelinePlayer.invalidate();
+    // Slots of the snapshot's time are gone or someone else's, every tween lands on its target instead
+    app.tweenManager.reset();
+    auto dropTweens = [this](std::span<InstanceData> instances, InstanceType type){
+        for(uint32_t i = 0; i < instances.size(); i++){
+            if(instances[i].tweenSlot != 0){
+                instances[i].tweenSlot = 0;
+                markWritten({i, type});
+            }
+        }
+    };
+    dropTweens(circleInstances, InstanceType::Circle);
+    dropTweens({reinterpret_cast<InstanceData*>(lineInstances.data()), lineInstances.size()}, InstanceType::Line);
+    dropTweens(polygonInstances, InstanceType::Polygon);
+    adoptScene(true); // can't tell if the meshes differ without comparing them, uploading is cheaper
+    return true;
+}
+
+// The vectors got replaced under the engine (timeline seek, snapshot restore), the outline table, free lists and
+// reserved handles have to follow what is in them now
+void ThING::API::adoptScene(bool meshesChanged){
+    graphLoader.cancel(); // the circles its node numbers point at are gone
+    tileSlots.clear(); // whatever tile circles came with the scene are its own now, the layer starts over
+    tileStreamer.invalidate();
+    if(meshesChanged){
+        dirtyFlags.meshes = true;
+    }
+    std::span<InstanceData> lines(reinterpret_cast<InstanceData*>(lineInstances.data()), lineInstances.size());
+    if(app.adoptOutlines(circleInstances, lines, polygonInstances)){
+        markInstancesWritten();
+    }
+    trackOutlineSlots();
+    rebuildFreeLists();
+    restartReserved(circleReserved, static_cast<uint32_t>(circleInstances.size()));
+    restartReserved(lineReserved, static_cast<uint32_t>(lineInstances.size()));
+    polygonEpoch.fetch_add(1, std::memory_order_relaxed);
+    freedCircles.clear(); // the scene's own edges point at its circles
+    dirtyFlags.circles = true;
+    dirtyFlags.edges = true;
+    spatialStale = true;
+}
+
+void ThING::API::markWritten(const Entity e){
+    switch (e.type) {
+        case InstanceType::Circle: markWritten(TimelineStream::Circles, e.index); return;
+        case InstanceType::Line: markWritten(TimelineStream::Lines, e.index); return;
+        case InstanceType::Polygon: markWritten(TimelineStream::Polygons, e.index); return;
+        case InstanceType::Count: std::unreachable();
+    }
+}
+
+// Every write to the scene goes through here or markAllWritten, a timeline being played can't apply its next delta
+// over a scene someone else changed
+void ThING::API::markWritten(TimelineStream stream, uint32_t index){
+    snapshotStore.markDirty(stream, index);
+    timelinePlayer.invalidate();
+}
+
+void ThING::API::markAllWritten(TimelineStream stream){
+    snapshotStore.markAllDirty(stream);
+    timelinePlayer.invalidate();
+}
+
+// Only the objectIDs changed (outline resync), the played timeline stays valid since every seek resyncs them anyway
+void ThING::API::markInstancesWritten(){
+    snapshotStore.markAllDirty(TimelineStream::Circles);
+    snapshotStore.markAllDirty(TimelineStream::Lines);
+    snapshotStore.markAllDirty(TimelineStream::Polygons);
+}
+
+// Whatever is dead after a seek is free, the lists of the scene before it point at slots that may be alive now
+void ThING::API::rebuildFreeLists(){
+    auto collect = [](std::span<const InstanceData> instances, InstanceType type, std::vector<Entity>& freeList){
+        freeList.clear();
+        for(uint32_t i = 0; i < instances.size(); i++){
+            if(!instances[i].alive){
+                freeList.push_back({i, type});
+            }
+        }
+    };
+    collect(circleInstances, InstanceType::Circle, circleFreeList);
+    collect(viewInstanceVector(InstanceType::Line), InstanceType::Line, lineFreeList); // a mutable one would count as a write
+    collect(polygonInstances, InstanceType::Polygon, polygonFreeList);
+    edgeFreeList.clear();
+    for(uint32_t i = 0; i < edges.size(); i++){
+        if(edges[i].from == DEAD_EDGE_NODE){
+            edgeFreeList.push_back(i);
+        }
+    }
+}
+
+// The index is only reserved once the queue took the edit, a full queue can't leave a slot nobody fills
+Entity ThING::API::queueCircle(glm::vec2 pos, float size, glm::vec4 color){
+    Entity e = INVALID_ENTITY;
+    editQueue.pushWith([&](InstanceEdit& edit){
+        edit.type = EditType::Add;
+        edit.data = InstanceData{};
+        edit.data.position = pos;
+        edit.data.scale = {size, size};
+        edit.data.type = InstanceType::Circle;
+        edit.data.color = color;
+        e = {reserveIndices(circleReserved, 1, &edit.epoch), InstanceType::Circle};
+        edit.entity = e;
+    });
+    return e;
+}
+
+Entity ThING::API::queueLine(glm::vec2 point1, glm::vec2 point2, float width){
+    LineData line;
+    line.point1 = point1;
+    line.point2 = point2;
+    line.thickness = width;
+    line.type = InstanceType::Line;
+    line.color = {1,1,0,1};
+    Entity e = INVALID_ENTITY;
+    editQueue.pushWith([&](InstanceEdit& edit){
+        edit.type = EditType::Add;
+        edit.data = *reinterpret_cast<InstanceData*>(&line);
+        e = {reserveIndices(lineReserved, 1, &edit.epoch), InstanceType::Line};
+        edit.entity = e;
+    });
+    return e;
+}
+
+bool ThING::API::queueDelete(const Entity e){
+    return editQueue.push({EditType::Delete, e, editEpoch(e.type), {}});
+}
+
+bool ThING::API::queueColor(const Entity e, glm::vec4 color){
+    InstanceEdit edit{EditType::SetColor, e, editEpoch(e.type), {}};
+    edit.data.color = color;
+    return editQueue.push(edit);
+}
+
+bool ThING::API::queuePosition(const Entity e, glm::vec2 pos){
+    InstanceEdit edit{EditType::SetPosition, e, editEpoch(e.type), {}};
+    edit.data.position = pos;
+    return editQueue.push(edit);
+}
+
+bool ThING::API::queueInstance(const Entity e, const InstanceData& data){
+    return editQueue.push({EditType::SetInstance, e, editEpoch(e.type), data});
+}
+
+uint32_t ThING::API::editEpoch(InstanceType type) const{
+    switch (type) {
+        case InstanceType::Circle: return static_cast<uint32_t>(circleReserved.load(std::memory_order_relaxed) >> 32);
+        case InstanceType::Line: return static_cast<uint32_t>(lineReserved.load(std::memory_order_relaxed) >> 32);
+        case InstanceType::Polygon: return polygonEpoch.load(std::memory_order_relaxed);
+        case InstanceType::Count: break;
+    }
+    return 0; // INVALID_ENTITY and the like, exists() turns them away
+}
+
+// Bounded to one queue worth of edits per frame so busy producers can't stall the frame
+void ThING::API::drainEdits(){
+    InstanceEdit edit;
+    for(size_t i = 0; i < MAX_QUEUED_EDITS && editQueue.pop(edit); i++){
+        applyEdit(edit);
+    }
+}
+
+bool ThING::API::loadGraph(const std::string& nodesPath, const std::string& edgesPath, const GraphLoadSettings& settings){
+    graphNodes.clear();
+    graphSettings = settings;
+    return graphLoader.start(nodesPath, edgesPath, settings);
+}
+
+// Every batch ready this frame goes in. Its nodes take one run of circle slots past everything reserved, so a batch
+// is a resize plus a parallel fill instead of an addCircle per node. The circles only get what the instance buffer
+// has left next to the lines and polygons, a batch past that is cut there and the load stops as truncated
+void ThING::API::ingestGraph(){
+    while(graphLoader.takeBatch(graphBatch)){
+        const uint64_t used = std::max<uint64_t>(circleInstances.size(), static_cast<uint32_t>(circleReserved.load(std::memory_order_relaxed)))
+            + lineInstances.size() + polygonInstances.size();
+        const size_t room = used < MAX_PHYSICS_BODIES ? MAX_PHYSICS_BODIES - used : 0;
+        const bool truncated = graphBatch.nodes.size() > room;
+        uint64_t droppedNodes = 0;
+        uint64_t droppedEdges = 0;
+        if(truncated){
+            droppedNodes = graphBatch.nodes.size() - room;
+            graphBatch.nodes.resize(room);
+            const size_t kept = graphNodes.size() + room;
+            droppedEdges = std::erase_if(graphBatch.edges, [kept](const std::pair<uint32_t, uint32_t>& link){
+                return link.first >= kept || link.second >= kept;
+            });
+        }
+
+        const std::span<const GraphLoader::Node> nodes = graphBatch.nodes;
+        if(!nodes.empty()){
+            const uint32_t base = reserveIndices(circleReserved, static_cast<uint32_t>(nodes.size()));
+            InstanceData circle;
+            circle.type = InstanceType::Circle;
+            circle.color = graphSettings.nodeColor;
+            circle.alive = 0;
+            circle.objectID = 0;
+            if(circleInstances.size() < base){
+                circleInstances.resize(base, circle); // queued adds can be reserved but not placed yet
+            }
+            circle.alive = 1;
+            circleInstances.resize(base + nodes.size(), circle);
+            InstanceData* placed = circleInstances.data() + base;
+            app.jobSystem.parallelForRange(nodes.size(), GRAPH_INGEST_GRAIN, [&](size_t begin, size_t end){
+                for(size_t i = begin; i < end; i++){
+                    placed[i].position = nodes[i].position;
+                    placed[i].scale = {nodes[i].size, nodes[i].size};
+                }
+            });
+            const size_t first = graphNodes.size();
+            graphNodes.resize(first + nodes.size());
+            for(size_t i = 0; i < nodes.size(); i++){
+                graphNodes[first + i] = base + static_cast<uint32_t>(i);
+            }
+            markAllWritten(TimelineStream::Circles);
+            dirtyFlags.circles = true;
+            spatialStale = true;
+        }
+
+        const std::span<const std::pair<uint32_t, uint32_t>> links = graphBatch.edges;
+        if(!links.empty()){
+            const size_t first = edges.size();
+            edges.resize(first + links.size());
+            const uint32_t color = glm::packUnorm4x8(graphSettings.edgeColor);
+            const float thickness = graphSettings.edgeThickness;
+            app.jobSystem.parallelForRange(links.size(), GRAPH_INGEST_GRAIN, [&](size_t begin, size_t end){
+                for(size_t i = begin; i < end; i++){
+                    edges[first + i] = {graphNodes[links[i].first], graphNodes[links[i].second], thickness, color};
+                }
+            });
+            markAllWritten(TimelineStream::Edges);
+            dirtyFlags.edges = true;
+        }
+        if(truncated){
+            graphLoader.truncate(droppedNodes, droppedEdges);
+            return;
+        }
+    }
+}
+
+bool ThING::API::openTiles(const std::string& path){
+    closeTiles();
+    return tileStreamer.open(path);
+}
+
+void ThING::API::closeTiles(){
+    tileStreamer.close();
+    for(uint32_t slot : tileSlots){
+        circleInstances[slot].alive = 0;
+        circleFreeList.push_back({slot, InstanceType::Circle});
+    }
+    if(!tileSlots.empty()){
+        tileSlots.clear();
+        markAllWritten(TimelineStream::Circles);
+        dirtyFlags.circles = true;
+        spatialStale = true;
+    }
+}
+
+void ThING::API::storeViewExtent(){
+    const VkExtent2D& extent = app.swapChainManager.getExtent();
+    viewExtent.store((static_cast<uint64_t>(extent.width) << 32) | extent.height, std::memory_order_relaxed);
+    int width = 0;
+    int height = 0;
+    glfwGetWindowSize(app.windowManager.getWindow(), &width, &height);
+    windowSize.store((static_cast<uint64_t>(width) << 32) | static_cast<uint32_t>(height), std::memory_order_relaxed);
+}
+
+// Only does something when the view moved onto other tiles or some finished loading. The layer keeps exactly as many
+// circles as it draws: more come off the free list or the end, surplus goes back on the free list dead
+void ThING::API::streamTiles(){
+    if(!tileStreamer.isOpen()){
+        return;
+    }
+    const uint64_t extent = viewExtent.load(std::memory_order_relaxed);
+    const float zoom = view.zoom == 0.0f ? 0.001f : view.zoom; // same guard the projection has
+    const glm::vec2 half = glm::vec2(static_cast<float>(extent >> 32), static_cast<float>(extent & 0xFFFFFFFF)) * 0.5f / zoom;
+    if(!tileStreamer.update(view.offset - half, view.offset + half, zoom)){
+        return;
+    }
+
+    const std::vector<TileStreamer::Tile>& tiles = tileStreamer.getVisible();
+    // The layer can't grow past what the instance buffer has left next to the rest of the scene, points past it aren't drawn
+    const uint64_t used = std::max<uint64_t>(circleInstances.size(), static_cast<uint32_t>(circleReserved.load(std::memory_order_relaxed)))
+        + lineInstances.size() + polygonInstances.size();
+    const size_t room = tileSlots.size() + circleFreeList.size() + (used < MAX_PHYSICS_BODIES ? MAX_PHYSICS_BODIES - used : 0);
+    const size_t total = std::min<size_t>(tileStreamer.getVisiblePoints(), room);
+    while(tileSlots.size() > total){
+        circleInstances[tileSlots.back()].alive = 0;
+        circleFreeList.push_back({tileSlots.back(), InstanceType::Circle});
+        tileSlots.pop_back();
+    }
+    dropCircleLinks();
+    while(tileSlots.size() < total && !circleFreeList.empty()){
+        tileSlots.push_back(circleFreeList.back().index);
+        circleFreeList.pop_back();
+    }
+    if(tileSlots.size() < total){
+        const uint32_t needed = static_cast<uint32_t>(total - tileSlots.size());
+        const uint32_t base = reserveIndices(circleReserved, needed);
+        InstanceData dead;
+        dead.alive = 0;
+        dead.type = InstanceType::Circle;
+        circleInstances.resize(std::max<size_t>(circleInstances.size(), base + needed), dead); // queued adds fill their own slots
+        for(uint32_t i = 0; i < needed; i++){
+            tileSlots.push_back(base + i);
+        }
+    }
+
+    std::vector<size_t> starts(tiles.size());
+    for(size_t t = 1; t < tiles.size(); t++){
+        starts[t] = starts[t - 1] + tiles[t - 1]->size();
+    }
+    app.jobSystem.parallelForRange(tiles.size(), 1, [&](size_t begin, size_t end){
+        for(size_t t = begin; t < end; t++){
+            const std::vector<TilePoint>& points = *tiles[t];
+            const size_t count = std::min(points.size(), total - std::min(starts[t], total));
+            for(size_t i = 0; i < count; i++){
+                InstanceData circle;
+                circle.position = points[i].position;
+                circle.scale = {points[i].size, points[i].size};
+                circle.color = glm::unpackUnorm4x8(points[i].color);
+                circle.type = InstanceType::Circle;
+                circleInstances[tileSlots[starts[t] + i]] = circle;
+            }
+        }
+    });
+    markAllWritten(TimelineStream::Circles);
+    dirtyFlags.circles = true;
+    spatialStale = true;
+}
+
+void ThING::API::applyEdit(const InstanceEdit& edit){
+    if(edit.epoch != editEpoch(edit.entity.type)){
+        return; // queued against the vector before a clear or a scene swap, its index means something else now
+    }
+    markSpatial(edit.entity);
+    if(edit.type == EditType::Add){
+        switch (edit.entity.type) {
+            case InstanceType::Circle:
+                placeInstance(circleInstances, edit.entity.index, edit.data);
+                markWritten(edit.entity);
+                dirtyFlags.circles = true;
+                return;
+            case InstanceType::Line:
+                placeInstance(lineInstances, edit.entity.index, *reinterpret_cast<const LineData*>(&edit.data));
+                markWritten(edit.entity);
+                return;
+            default:
+                return;
+        }
+    }
+    if(!exists(edit.entity)){
+        return;
+    }
+    InstanceData& instance = getInstance(edit.entity);
+    switch (edit.type) {
+        case EditType::Delete:
+            deleteInstance(edit.entity);
+            break;
+        case EditType::SetColor:
+            instance.color = edit.data.color;
+            break;
+        case EditType::SetPosition:
+            if(edit.entity.type == InstanceType::Line){
+                LineData& line = getLine(edit.entity);
+                line.point2 += edit.data.position - line.point1;
+                line.point1 = edit.data.position;
+            } else {
+                instance.position = edit.data.position;
+            }
+            break;
+        case EditType::SetInstance: {
+            uint32_t objectID = instance.objectID; // the outline and tween slots belong to the engine
+            uint32_t tweenSlot = instance.tweenSlot;
+            instance = edit.data;
+            instance.objectID = objectID;
+            instance.tweenSlot = tweenSlot;
+            instance.alive = 1;
+            break;
+        }
+        case EditType::Add: std::unreachable();
+    }
+}
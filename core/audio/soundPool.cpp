@@ -0,0 +1,158 @@
+#include <ThING/audio/soundPool.h>
+#include <algorithm>
+#include <cstring>
+
+static ma_data_source_vtable VOICE_VTABLE = {};
+
+bool SoundPool::init(ma_engine* engine){
+    uninit();
+    if(ma_sound_group_init(engine, 0, nullptr, &group) != MA_SUCCESS){
+        return false;
+    }
+    this->engine = engine;
+    VOICE_VTABLE.onRead = readVoice;
+    VOICE_VTABLE.onSeek = seekVoice;
+    VOICE_VTABLE.onGetDataFormat = voiceFormat;
+
+    for(Voice& voice : voices){
+        voice.channels = ma_engine_get_channels(engine);
+        voice.sampleRate = ma_engine_get_sample_rate(engine);
+        ma_data_source_config config = ma_data_source_config_init();
+        config.vtable = &VOICE_VTABLE;
+        if(ma_data_source_init(&config, &voice.base) != MA_SUCCESS){
+            uninit();
+            return false;
+        }
+        if(ma_sound_init_from_data_source(engine, &voice.base, MA_SOUND_FLAG_NO_SPATIALIZATION, &group, &voice.sound) != MA_SUCCESS){
+            ma_data_source_uninit(&voice.base);
+            uninit();
+            return false;
+        }
+        voiceCount++;
+    }
+    return true;
+}
+
+void SoundPool::uninit(){
+    if(engine == nullptr){
+        return;
+    }
+    for(uint32_t i = 0; i < voiceCount; i++){
+        ma_sound_uninit(&voices[i].sound);
+        ma_data_source_uninit(&voices[i].base);
+        voices[i].started = false;
+    }
+    voiceCount = 0;
+    ma_sound_group_uninit(&group);
+    engine = nullptr;
+}
+
+// Decoding happens here, on the caller, the whole file at once
+SoundHandle SoundPool::load(const std::string& path){
+    if(engine == nullptr){
+        return INVALID_SOUND;
+    }
+    if(auto it = handles.find(path); it != handles.end()){
+        return it->second;
+    }
+    if(clipCount == MAX_LOADED_SOUNDS){
+        return INVALID_SOUND;
+    }
+    const uint32_t channels = ma_engine_get_channels(engine);
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, channels, ma_engine_get_sample_rate(engine));
+    ma_uint64 frames = 0;
+    void* pcm = nullptr;
+    if(ma_decode_file(path.c_str(), &config, &frames, &pcm) != MA_SUCCESS){
+        return INVALID_SOUND;
+    }
+    auto clip = std::make_unique<Clip>();
+    clip->frames = frames;
+    clip->samples.resize(frames * channels);
+    std::memcpy(clip->samples.data(), pcm, clip->samples.size() * sizeof(float));
+    ma_free(pcm, nullptr);
+
+    const SoundHandle handle = clipCount++;
+    clips[handle] = std::move(clip);
+    handles.emplace(path, handle);
+    return handle;
+}
+
+bool SoundPool::play(SoundHandle sound, float volume, float pitch){
+    if(engine == nullptr || sound >= clipCount){
+        return false;
+    }
+    Voice& voice = takeVoice();
+    ma_sound_set_volume(&voice.sound, volume);
+    ma_sound_set_pitch(&voice.sound, pitch);
+    voice.clip.store(clips[sound].get(), std::memory_order_relaxed);
+    voice.requested.fetch_add(1, std::memory_order_release);
+    voice.order = ++playCount;
+    if(!voice.started){
+        ma_sound_start(&voice.sound);
+        voice.started = true;
+    }
+    return true;
+}
+
+// A free voice if there is one, the oldest otherwise. Voices that finished get stopped on the way so they stop
+// costing the mixer
+SoundPool::Voice& SoundPool::takeVoice(){
+    Voice* free = nullptr;
+    Voice* oldest = &voices[0];
+    for(uint32_t i = 0; i < voiceCount; i++){
+        Voice& voice = voices[i];
+        const bool done = voice.finished.load(std::memory_order_acquire) == voice.requested.load(std::memory_order_relaxed);
+        if(done && voice.started){
+            ma_sound_stop(&voice.sound);
+            voice.started = false;
+        }
+        if(done && free == nullptr){
+            free = &voice;
+        }
+        if(voice.order < oldest->order){
+            oldest = &voice;
+        }
+    }
+    return free ? *free : *oldest;
+}
+
+// Audio thread. Picks up a new clip at the start of a read, runs the clip and then silence, never MA_AT_END
+ma_result SoundPool::readVoice(ma_data_source* source, void* out, ma_uint64 frameCount, ma_uint64* framesRead){
+    Voice& voice = *reinterpret_cast<Voice*>(source);
+    const uint32_t generation = voice.requested.load(std::memory_order_acquire);
+    if(generation != voice.playingGeneration){
+        voice.playing = voice.clip.load(std::memory_order_relaxed);
+        voice.playingGeneration = generation;
+        voice.cursor = 0;
+    }
+    float* dst = static_cast<float*>(out);
+    ma_uint64 written = 0;
+    if(voice.playing != nullptr && voice.cursor < voice.playing->frames){
+        written = std::min<ma_uint64>(frameCount, voice.playing->frames - voice.cursor);
+        std::memcpy(dst, voice.playing->samples.data() + voice.cursor * voice.channels, written * voice.channels * sizeof(float));
+        voice.cursor += written;
+    }
+    if(voice.playing == nullptr || voice.cursor == voice.playing->frames){
+        voice.finished.store(voice.playingGeneration, std::memory_order_release);
+    }
+    std::fill(dst + written * voice.channels, dst + frameCount * voice.channels, 0.0f);
+    if(framesRead != nullptr){
+        *framesRead = frameCount;
+    }
+    return MA_SUCCESS;
+}
+
+// Voices always start from the top of the clip they get, nothing to seek
+ma_result SoundPool::seekVoice(ma_data_source*, ma_uint64){
+    return MA_SUCCESS;
+}
+
+ma_result SoundPool::voiceFormat(ma_data_source* source, ma_format* format, ma_uint32* channels, ma_uint32* sampleRate,
+    ma_channel* channelMap, size_t channelMapCap){
+    const Voice& voice = *reinterpret_cast<const Voice*>(source);
+    *format = ma_format_f32;
+    *channels = voice.channels;
+    *sampleRate = voice.sampleRate;
+    ma_channel_map_init_standard(ma_standard_channel_map_default, channelMap, channelMapCap, voice.channels);
+    return MA_SUCCESS;
+}
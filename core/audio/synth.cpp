@@ -0,0 +1,162 @@
+#include <ThING/audio/synth.h>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+static ma_data_source_vtable SYNTH_VTABLE = {};
+
+bool Synth::init(ma_engine* engine){
+    uninit();
+    channels = ma_engine_get_channels(engine);
+    sampleRate = ma_engine_get_sample_rate(engine);
+    SYNTH_VTABLE.onRead = readSource;
+    SYNTH_VTABLE.onSeek = seekSource;
+    SYNTH_VTABLE.onGetDataFormat = sourceFormat;
+
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable = &SYNTH_VTABLE;
+    source.synth = this;
+    if(ma_data_source_init(&config, &source.base) != MA_SUCCESS){
+        return false;
+    }
+    // Same format as the engine so nothing gets converted or resampled on the way out
+    if(ma_sound_init_from_data_source(engine, &source.base, MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_NO_PITCH,
+        nullptr, &sound) != MA_SUCCESS){
+        ma_data_source_uninit(&source.base);
+        return false;
+    }
+    this->engine = engine;
+    return true;
+}
+
+void Synth::uninit(){
+    if(engine == nullptr){
+        return;
+    }
+    ma_sound_uninit(&sound);
+    ma_data_source_uninit(&source.base);
+    engine = nullptr;
+    started = false;
+}
+
+// NaN would stick in the phase and the envelope of whatever voice it lands on
+static bool validTone(const ToneEvent& tone){
+    return std::isfinite(tone.frequency) && tone.frequency >= 0.0f && std::isfinite(tone.duration) && tone.duration >= 0.0f &&
+        std::isfinite(tone.volume) && tone.volume >= 0.0f && tone.waveform < Waveform::Count;
+}
+
+bool Synth::play(const ToneEvent& tone){
+    if(engine == nullptr || !validTone(tone) || !queue.push(tone)){
+        return false;
+    }
+    if(!started){
+        ma_sound_start(&sound);
+        started = true;
+    }
+    return true;
+}
+
+void Synth::setVolume(float volume){
+    if(engine != nullptr){
+        ma_sound_set_volume(&sound, volume);
+    }
+}
+
+// Audio thread. A free voice if there is one, the oldest otherwise, which keeps its level and phase and ramps
+// from there
+void Synth::start(const ToneEvent& tone){
+    Voice* voice = &voices[0];
+    for(Voice& candidate : voices){
+        if(!candidate.active){
+            voice = &candidate;
+            break;
+        }
+        if(candidate.order < voice->order){
+            voice = &candidate;
+        }
+    }
+    if(!voice->active){
+        voice->phase = 0.0f;
+        voice->level = 0.0f;
+        voice->active = true;
+        activeVoices++;
+    }
+    const float nyquist = static_cast<float>(sampleRate) * 0.5f;
+    voice->waveform = tone.waveform;
+    voice->step = std::clamp(tone.frequency, 0.0f, nyquist) / static_cast<float>(sampleRate);
+    voice->volume = std::max(tone.volume, 0.0f);
+    voice->hold = static_cast<uint64_t>(std::max(tone.duration, 0.0f) * static_cast<float>(sampleRate));
+    voice->order = ++toneCount;
+}
+
+static float oscillate(Waveform waveform, float phase){
+    switch (waveform) {
+        case Waveform::Sine:     return std::sin(2.0f * std::numbers::pi_v<float> * phase);
+        case Waveform::Triangle: return 1.0f - 4.0f * std::abs(phase - 0.5f);
+        case Waveform::Square:   return phase < 0.5f ? 1.0f : -1.0f;
+        case Waveform::Saw:      return 2.0f * phase - 1.0f;
+        case Waveform::Count:    break;
+    }
+    return 0.0f;
+}
+
+// Voices add up, the sum is only clamped, keep volumes low when a lot of notes overlap. At most a voice worth of
+// notes is taken per read, more would only cut each other off, a burst spreads over the next reads instead
+void Synth::render(float* out, uint64_t frames){
+    ToneEvent tone;
+    for(uint32_t taken = 0; taken < MAX_SYNTH_VOICES && queue.pop(tone); taken++){
+        start(tone);
+    }
+    if(activeVoices == 0){
+        std::fill(out, out + frames * channels, 0.0f);
+        return;
+    }
+    const float attack = 1.0f / (SYNTH_ATTACK_SECONDS * static_cast<float>(sampleRate));
+    const float release = 1.0f / (SYNTH_RELEASE_SECONDS * static_cast<float>(sampleRate));
+    for(uint64_t frame = 0; frame < frames; frame++){
+        float sum = 0.0f;
+        for(Voice& voice : voices){
+            if(!voice.active){
+                continue;
+            }
+            if(voice.hold > 0){
+                voice.hold--;
+                voice.level = std::min(voice.level + attack, 1.0f);
+            } else {
+                voice.level -= release;
+                if(voice.level <= 0.0f){
+                    voice.active = false;
+                    activeVoices--;
+                    continue;
+                }
+            }
+            sum += oscillate(voice.waveform, voice.phase) * voice.level * voice.volume;
+            voice.phase += voice.step;
+            voice.phase -= voice.phase >= 1.0f ? 1.0f : 0.0f;
+        }
+        std::fill_n(out + frame * channels, channels, std::clamp(sum, -1.0f, 1.0f));
+    }
+}
+
+// Never ends, plays silence while no voice is active
+ma_result Synth::readSource(ma_data_source* source, void* out, ma_uint64 frameCount, ma_uint64* framesRead){
+    reinterpret_cast<Source*>(source)->synth->render(static_cast<float*>(out), frameCount);
+    if(framesRead != nullptr){
+        *framesRead = frameCount;
+    }
+    return MA_SUCCESS;
+}
+
+ma_result Synth::seekSource(ma_data_source*, ma_uint64){
+    return MA_SUCCESS;
+}
+
+ma_result Synth::sourceFormat(ma_data_source* source, ma_format* format, ma_uint32* channels, ma_uint32* sampleRate,
+    ma_channel* channelMap, size_t channelMapCap){
+    const Synth& synth = *reinterpret_cast<Source*>(source)->synth;
+    *format = ma_format_f32;
+    *channels = synth.channels;
+    *sampleRate = synth.sampleRate;
+    ma_channel_map_init_standard(ma_standard_channel_map_default, channelMap, channelMapCap, synth.channels);
+    return MA_SUCCESS;
+}
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <unordered_map>
 #include <vulkan/vulkan_core.h>
 
 #include "ThING/graphics/bufferManager.h"
@@ -27,6 +29,7 @@ ProtoThiApp::ProtoThiApp() : windowManager(WIDTH, HEIGHT, TITLE){
     currentFrame = 0;
     worldData.meshes = {};
     worldData.ssboData = {};
+    worldData.ssboDirtySlots = {};
     worldData.polygonOffset = 0;
 }
 
@@ -51,6 +54,7 @@ void ProtoThiApp::initVulkan(VkPresentModeKHR prefferedPresentMode) {
     bufferManager.createBuffers();
     pipelineManager.createDescriptors(bufferManager, swapChainManager);
     commandBufferManager.createCommandBuffers(device, swapChainManager.getSurface());
+    commandBufferManager.createQueryPool(physicalDevice, device, swapChainManager.getSurface());
     swapChainManager.createSyncObjects();
 }
 
@@ -67,10 +71,10 @@ void ProtoThiApp::cleanup() {
     commandBufferManager.cleanUpCommandBuffers(device);
 
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        
         vkDestroySemaphore(device, swapChainManager.getImageAvailableSemaphores()[i], nullptr);
-        vkDestroyFence(device, swapChainManager.getInFlightFences()[i], nullptr);
     }
+    vkDestroySemaphore(device, swapChainManager.getFrameTimeline(), nullptr);
+    commandBufferManager.cleanUpQueryPool(device);
     for(auto& semaphore : swapChainManager.getRenderFinishedSemaphores()){
         vkDestroySemaphore(device, semaphore, nullptr);
     }
@@ -92,65 +96,154 @@ void ProtoThiApp::cleanup() {
 }
 
 void ProtoThiApp::recordWorldData(std::span<InstanceData> circleInstances, std::span<InstanceData> polygonInstances, 
-    std::span<InstanceData> lineInstances, std::span<MeshData> meshes, DirtyFlags dirtyFlags) {
+    std::span<InstanceData> lineInstances, std::span<MeshData> meshes, std::span<const EdgeData> edges, std::span<const TextData> texts, 
+    std::span<const GlyphData> glyphs, DirtyFlags dirtyFlags) {
     worldData.dirtyFlags = dirtyFlags;
     worldData.circleInstances = circleInstances;
     worldData.lineInstances = lineInstances;
     worldData.polygonInstances = polygonInstances;
     worldData.meshes = meshes;
-
-    maxOutlineSize = 0;
-    float fMaxOutlineSize = 0;
+    worldData.edges = edges;
+    worldData.texts = texts;
+    worldData.glyphs = glyphs;
+    worldData.vertices = vertices;
+    worldData.indices = indices;
 
     worldData.polygonOffset = circleInstances.size() + lineInstances.size();
 
     if (dirtyFlags.ssbo) {
+        syncOutlines(circleInstances, lineInstances, polygonInstances);
+        worldData.dirtyFlags.circles = true; // objectIDs got remapped
+    }
 
-        uint32_t maxId = 0;
+    worldData.ssboData = outlineManager.viewSlots();
+    worldData.ssboDirtySlots = outlineManager.viewDirtySlots();
+    worldData.tweenData = tweenManager.viewSlots();
+    worldData.tweenDirtySlots = tweenManager.viewDirtySlots();
+    maxOutlineSize = (outlineManager.getMaxOutlineSize() * zoom);
+}
+
+// ApiFlags_ThreadedUpdate path, the snapshot is owned by the render thread until the next consume so
+// nothing here touches state the update thread writes (outlineManager, tweenManager, vertices, indices)
+void ProtoThiApp::recordSnapshot(SceneSnapshot& snapshot, DirtyFlags dirtyFlags) {
+    worldData.dirtyFlags = dirtyFlags;
+    worldData.circleInstances = snapshot.circleInstances;
+    worldData.lineInstances = std::span(reinterpret_cast<InstanceData*>(snapshot.lineInstances.data()), snapshot.lineInstances.size());
+    worldData.polygonInstances = snapshot.polygonInstances;
+    worldData.meshes = snapshot.polygonMeshes;
+    worldData.edges = snapshot.edges;
+    worldData.texts = snapshot.texts;
+    worldData.glyphs = snapshot.glyphs;
+    worldData.vertices = snapshot.vertices;
+    worldData.indices = snapshot.indices;
+
+    worldData.polygonOffset = snapshot.circleInstances.size() + snapshot.lineInstances.size();
+
+    worldData.ssboData = snapshot.outlines;
+    worldData.ssboDirtySlots = dirtyFlags.ssbo ? std::span<const uint32_t>(snapshot.outlineSlots) : std::span<const uint32_t>();
+    worldData.tweenData = snapshot.tweens;
+    worldData.tweenDirtySlots = dirtyFlags.tweens ? std::span<const uint32_t>(snapshot.tweenSlots) : std::span<const uint32_t>();
+    maxOutlineSize = (snapshot.maxOutlineSize * zoom);
+}
 
-        auto scanMax = [&](std::span<InstanceData> arr) {
-            for (const InstanceData& inst : arr) {
-                if (inst.objectID != 0 && inst.alive) {
-                    if (inst.objectID > maxId) maxId = inst.objectID;
-                }
+// Full resync, only runs when the user asks for it with updateOutlines(), single outline changes go through
+// API::updateOutline. Whatever objectID the instances carry gets remapped to a dense slot, instances that shared
+// an ID keep sharing the slot.
+void ProtoThiApp::syncOutlines(std::span<InstanceData> circleInstances, std::span<InstanceData> lineInstances, 
+    std::span<InstanceData> polygonInstances) {
+    outlineManager.reset();
+    std::unordered_map<uint32_t, uint32_t> remap;
+
+    auto remapSpan = [&](std::span<InstanceData> arr) {
+        for (InstanceData& inst : arr) {
+            if (inst.objectID == 0) continue;
+            if (!inst.alive) {
+                inst.objectID = 0;
+                continue;
             }
-        };
 
-        scanMax(circleInstances);
-        scanMax(lineInstances);
-        scanMax(polygonInstances);
+            auto [it, inserted] = remap.try_emplace(inst.objectID, 0u);
+            if (inserted) {
+                it->second = outlineManager.acquire();
+            } else if (it->second != 0) {
+                outlineManager.retain(it->second);
+            }
+            inst.objectID = it->second;
+            if (inst.objectID == 0) continue;
 
-        worldData.ssboData.clear();
-        worldData.ssboData.resize(maxId + 1);
+            const uint32_t enabled = (inst.outlineSize > 0.0f) ? 1u : 0u;
+            outlineManager.write(inst.objectID, { inst.outlineColor, inst.outlineSize, inst.groupID, enabled });
+        }
+    };
 
-        for (auto& e : worldData.ssboData) e = SSBO{};
+    remapSpan(circleInstances);
+    remapSpan(lineInstances);
+    remapSpan(polygonInstances);
+}
 
-        if (!worldData.ssboData.empty()) {
-            worldData.ssboData[0] = { {0,0,0,0}, 0.0f, 0u, 0u };
+// Rebuilds the outline table around the objectIDs the instances already have, where syncOutlines would remap them.
+// Timeline seeks write recorded instances over resynced ones, both have to keep meaning the same slots.
+// Returns true when an objectID had to be cleared (dead instance or past the table)
+bool ProtoThiApp::adoptOutlines(std::span<InstanceData> circleInstances, std::span<InstanceData> lineInstances, 
+    std::span<InstanceData> polygonInstances) {
+    outlineManager.reset();
+    bool cleared = false;
+
+    auto adoptSpan = [&](std::span<InstanceData> arr) {
+        for (InstanceData& inst : arr) {
+            if (inst.objectID == 0) continue;
+            if (!inst.alive || !outlineManager.claim(inst.objectID)) {
+                inst.objectID = 0;
+                cleared = true;
+                continue;
+            }
+            const uint32_t enabled = (inst.outlineSize > 0.0f) ? 1u : 0u;
+            outlineManager.write(inst.objectID, { inst.outlineColor, inst.outlineSize, inst.groupID, enabled });
         }
+    };
 
-        auto writeSpan = [&](std::span<InstanceData> arr) {
-            for (const InstanceData& inst : arr) {
-                const uint32_t id = inst.objectID;
-                if (id == 0) continue;
+    adoptSpan(circleInstances);
+    adoptSpan(lineInstances);
+    adoptSpan(polygonInstances);
+    outlineManager.fillFreeSlots();
+    return cleared;
+}
 
-                if (id >= worldData.ssboData.size()) continue;
-                fMaxOutlineSize = std::max(inst.outlineSize, fMaxOutlineSize);
-                const uint32_t enabled = (inst.alive && inst.outlineSize > 0.0f) ? 1u : 0u;
-                worldData.ssboData[id] = { inst.outlineColor, inst.outlineSize, inst.groupID, enabled };
-            }
-        };
+void ProtoThiApp::beginFrame() {
+    frameBegin = std::chrono::steady_clock::now();
+}
+
+// Blocks until the GPU is done with the last frame submitted on currentFrame, everything that belongs to
+// that slot (instance, indirect, uniform, ssbo, descriptor sets, command buffer) can be rewritten after this
+void ProtoThiApp::waitForFrameSlot() {
+    using namespace std::chrono;
+    const VkSemaphore timeline = swapChainManager.getFrameTimeline();
+    const uint64_t slotValue = slotTimelineValues[currentFrame];
+
+    const steady_clock::time_point waitStart = steady_clock::now();
+    if (slotValue > 0) {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timeline;
+        waitInfo.pValues = &slotValue;
+        if (vkWaitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+            throw std::runtime_error("failed to wait for frame timeline!");
+        }
+    }
+    const steady_clock::time_point waitEnd = steady_clock::now();
+
+    frameStats.waitTime = duration<float, std::milli>(waitEnd - waitStart).count();
+    vkGetSemaphoreCounterValue(device, timeline, &frameStats.completedFrames);
+    frameStats.framesInFlight = static_cast<uint32_t>(frameTimelineValue - frameStats.completedFrames);
 
-        writeSpan(circleInstances);
-        writeSpan(lineInstances);
-        writeSpan(polygonInstances);
-        maxOutlineSize = (fMaxOutlineSize * zoom);
+    if (slotValue > 0) {
+        frameStats.latency = duration<float, std::milli>(waitEnd - slotBeginTimes[currentFrame]).count();
+        commandBufferManager.readGpuTime(device, currentFrame, frameStats.gpuTime);
     }
 }
 
 void ProtoThiApp::drawFrame() {
-    vkWaitForFences(device, 1, &swapChainManager.getInFlightFences()[currentFrame], VK_TRUE, UINT64_MAX);
-
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(device, swapChainManager.getSwapChain(), UINT64_MAX, swapChainManager.getImageAvailableSemaphores()[currentFrame], VK_NULL_HANDLE, &imageIndex);
 
@@ -161,11 +254,9 @@ void ProtoThiApp::drawFrame() {
         throw std::runtime_error("failed to acquire swap chain image!");
     }
 
-    vkResetFences(device, 1, &swapChainManager.getInFlightFences()[currentFrame]);
-
     vkResetCommandBuffer(commandBufferManager.viewCommandBufferOnFrame(currentFrame), 0);
 
-    RenderContext renderContext = {currentFrame, worldData, bufferManager, indirectCommandCount, maxOutlineSize};
+    RenderContext renderContext = {currentFrame, worldData, bufferManager, indirectCommandCount, maxOutlineSize, physicsFrame, pickFrame, splatCircles, heatmapFrame};
     FrameContext frameContext{imageIndex, clearColor, pipelineManager, swapChainManager};
     pipelineManager.updateDescriptorSets(currentFrame, bufferManager, swapChainManager, imageIndex);
 
@@ -183,13 +274,29 @@ void ProtoThiApp::drawFrame() {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBufferManager.viewCommandBufferOnFrame(currentFrame);
 
-    VkSemaphore signalSemaphores[] = {swapChainManager.getRenderFinishedSemaphores()[imageIndex]};
-    submitInfo.signalSemaphoreCount = 1;
+    const uint64_t signalValue = frameTimelineValue + 1;
+    VkSemaphore signalSemaphores[] = {swapChainManager.getRenderFinishedSemaphores()[imageIndex], swapChainManager.getFrameTimeline()};
+    uint64_t signalValues[] = {0, signalValue}; // binary semaphores ignore the value
+    submitInfo.signalSemaphoreCount = 2;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, swapChainManager.getInFlightFences()[currentFrame]) != VK_SUCCESS) {
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 0;
+    timelineInfo.signalSemaphoreValueCount = 2;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineInfo;
+
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
         throw std::runtime_error("failed to submit draw command buffer!");
     }
+    frameTimelineValue = signalValue;
+    slotTimelineValues[currentFrame] = signalValue;
+    slotBeginTimes[currentFrame] = frameBegin;
+    gpuPhysics.submitted(currentFrame, signalValue, physicsFrame);
+    pickManager.submitted(currentFrame, signalValue);
+    frameStats.submittedFrames = signalValue;
+    frameStats.cpuTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameBegin).count();
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
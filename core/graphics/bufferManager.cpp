@@ -2,9 +2,13 @@
 #include "ThING/types/enums.h"
 #include "ThING/types/renderData.h"
 #include "ThING/types/vertex.h"
+#include "ThING/text/font.h"
 #include "glm/ext/matrix_clip_space.hpp"
 #include "glm/fwd.hpp"
 #include <ThING/graphics/bufferManager.h>
+#include <ThING/extras/streamCopy.h>
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 #include <cstdint>
@@ -19,14 +23,29 @@ BufferManager::BufferManager(VkDevice device, VkPhysicalDevice physicalDevice, V
     ubo = {};
     for(size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
         instancedMapped[i] = nullptr;
+        edgeMapped[i] = nullptr;
+        textMapped[i] = nullptr;
+        glyphMapped[i] = nullptr;
+        indirectMapped[i] = nullptr;
+        ssboMapped[i] = nullptr;
+        physicsReadbackMapped[i] = nullptr;
+        layoutStagingMapped[i] = nullptr;
+        tweenMapped[i] = nullptr;
+        pickReadbackMapped[i] = nullptr;
+        heatmapUniformMapped[i] = nullptr;
     }
-    ssboMapped = nullptr;
 }
 
 void BufferManager::createBuffers(){
     createCustomBuffers();
     createIndirectBuffers();
     createUniformBuffers();
+    createPhysicsBuffers();
+    createLayoutBuffers();
+    createPickBuffers();
+    createSplatBuffer(WIDTH * HEIGHT);
+    createHeatmapBuffers(WIDTH * HEIGHT);
+    createGlyphAtlas();
 }
 
 void BufferManager::uploadBuffer(VkDeviceSize bufferSize, VkBuffer *buffer, void* bufferData){
@@ -124,7 +143,23 @@ const Buffer& BufferManager::viewBuffer(BufferType type, size_t index) const{
         case BufferType::QuadIndex:     return quadIndexBuffer;
         case BufferType::Uniform:       return uniformBuffers[index];
         case BufferType::Indirect:      return indirectBuffers[index];
-        case BufferType::SSBO:          return ssbo;
+        case BufferType::SSBO:          return ssboBuffers[index];
+        case BufferType::PhysicsPositions: return physicsPositionBuffer;
+        case BufferType::PhysicsBodies: return physicsBodyBuffer;
+        case BufferType::PhysicsGrid:   return physicsGridBuffer;
+        case BufferType::PhysicsReadback: return physicsReadbackBuffers[index];
+        case BufferType::PickReadback:  return pickReadbackBuffers[index];
+        case BufferType::Splat:         return splatBuffer;
+        case BufferType::HeatmapGrid:   return heatmapGridBuffer;
+        case BufferType::HeatmapUniform: return heatmapUniformBuffers[index];
+        case BufferType::Edge:          return edgeBuffers[index];
+        case BufferType::LayoutAccum:   return layoutAccumBuffer;
+        case BufferType::LayoutTree:    return layoutTreeBuffer;
+        case BufferType::LayoutAdjacency: return layoutAdjacencyBuffer;
+        case BufferType::LayoutStaging: return layoutStagingBuffers[index];
+        case BufferType::Tween:         return tweenBuffers[index];
+        case BufferType::Text:          return textBuffers[index];
+        case BufferType::Glyph:         return glyphBuffers[index];
         case BufferType::Count:         std::unreachable();
     }
     std::unreachable();
@@ -139,7 +174,23 @@ std::span<const Buffer, MAX_FRAMES_IN_FLIGHT> BufferManager::viewBuffers(BufferT
         case BufferType::QuadIndex:     std::unreachable();
         case BufferType::Uniform:       return uniformBuffers;
         case BufferType::Indirect:      return indirectBuffers;
-        case BufferType::SSBO:          std::unreachable();
+        case BufferType::SSBO:          return ssboBuffers;
+        case BufferType::PhysicsPositions: std::unreachable();
+        case BufferType::PhysicsBodies: std::unreachable();
+        case BufferType::PhysicsGrid:   std::unreachable();
+        case BufferType::PhysicsReadback: return physicsReadbackBuffers;
+        case BufferType::PickReadback:  return pickReadbackBuffers;
+        case BufferType::Splat:         std::unreachable();
+        case BufferType::HeatmapGrid:   std::unreachable();
+        case BufferType::HeatmapUniform: return heatmapUniformBuffers;
+        case BufferType::Edge:          return edgeBuffers;
+        case BufferType::LayoutAccum:   std::unreachable();
+        case BufferType::LayoutTree:    std::unreachable();
+        case BufferType::LayoutAdjacency: std::unreachable();
+        case BufferType::LayoutStaging: return layoutStagingBuffers;
+        case BufferType::Tween:         return tweenBuffers;
+        case BufferType::Text:          return textBuffers;
+        case BufferType::Glyph:         return glyphBuffers;
         case BufferType::Count:         std::unreachable();
     }
     std::unreachable();
@@ -154,7 +205,23 @@ Buffer& BufferManager::getBuffer(BufferType type, size_t index){
         case BufferType::QuadIndex:     return quadIndexBuffer;
         case BufferType::Uniform:       return uniformBuffers[index];
         case BufferType::Indirect:      return indirectBuffers[index];
-        case BufferType::SSBO:          return ssbo;
+        case BufferType::SSBO:          return ssboBuffers[index];
+        case BufferType::PhysicsPositions: return physicsPositionBuffer;
+        case BufferType::PhysicsBodies: return physicsBodyBuffer;
+        case BufferType::PhysicsGrid:   return physicsGridBuffer;
+        case BufferType::PhysicsReadback: return physicsReadbackBuffers[index];
+        case BufferType::PickReadback:  return pickReadbackBuffers[index];
+        case BufferType::Splat:         return splatBuffer;
+        case BufferType::HeatmapGrid:   return heatmapGridBuffer;
+        case BufferType::HeatmapUniform: return heatmapUniformBuffers[index];
+        case BufferType::Edge:          return edgeBuffers[index];
+        case BufferType::LayoutAccum:   return layoutAccumBuffer;
+        case BufferType::LayoutTree:    return layoutTreeBuffer;
+        case BufferType::LayoutAdjacency: return layoutAdjacencyBuffer;
+        case BufferType::LayoutStaging: return layoutStagingBuffers[index];
+        case BufferType::Tween:         return tweenBuffers[index];
+        case BufferType::Text:          return textBuffers[index];
+        case BufferType::Glyph:         return glyphBuffers[index];
         case BufferType::Count:         std::unreachable();
     }
     std::unreachable();
@@ -169,7 +236,23 @@ std::array<Buffer, MAX_FRAMES_IN_FLIGHT>& BufferManager::getBuffers(BufferType t
         case BufferType::QuadIndex:     std::unreachable();
         case BufferType::Uniform:       return uniformBuffers;
         case BufferType::Indirect:      return indirectBuffers;
-        case BufferType::SSBO:          std::unreachable();
+        case BufferType::SSBO:          return ssboBuffers;
+        case BufferType::PhysicsPositions: std::unreachable();
+        case BufferType::PhysicsBodies: std::unreachable();
+        case BufferType::PhysicsGrid:   std::unreachable();
+        case BufferType::PhysicsReadback: return physicsReadbackBuffers;
+        case BufferType::PickReadback:  return pickReadbackBuffers;
+        case BufferType::Splat:         std::unreachable();
+        case BufferType::HeatmapGrid:   std::unreachable();
+        case BufferType::HeatmapUniform: return heatmapUniformBuffers;
+        case BufferType::Edge:          return edgeBuffers;
+        case BufferType::LayoutAccum:   std::unreachable();
+        case BufferType::LayoutTree:    std::unreachable();
+        case BufferType::LayoutAdjacency: std::unreachable();
+        case BufferType::LayoutStaging: return layoutStagingBuffers;
+        case BufferType::Tween:         return tweenBuffers;
+        case BufferType::Text:          return textBuffers;
+        case BufferType::Glyph:         return glyphBuffers;
         case BufferType::Count:         std::unreachable();
     }
     std::unreachable();
@@ -188,8 +271,28 @@ uint32_t BufferManager::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlag
     throw std::runtime_error("failed to find suitable memory type!");
 }
 
-void BufferManager::updateBuffer(VkFence& inFlightFences, 
-    const void* data, 
+bool BufferManager::hasMemoryType(VkMemoryPropertyFlags properties){
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if ((memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The CPU reads these back, cached memory makes that a normal memcpy instead of uncached reads
+VkMemoryPropertyFlags BufferManager::readbackMemoryFlags(){
+    VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    if (!hasMemoryType(flags)) {
+        flags &= ~VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    }
+    return flags;
+}
+
+void BufferManager::updateBuffer(const void* data, 
     VkDeviceSize newBufferSize, 
     uint32_t frameIndex,
     VkBufferUsageFlags usage,
@@ -208,11 +311,8 @@ void BufferManager::updateBuffer(VkFence& inFlightFences,
     if (stagingBuffers[id].bufferSizes[frameIndex] < newBufferSize){
         stagingBuffers[id].bufferSizes[frameIndex] = newBufferSize + BUFFER_PADDING;
         if(passedBuffer.buffer){
-            vkWaitForFences(device, 1, &inFlightFences, VK_TRUE, UINT64_MAX);
-            if (passedBuffer.buffer) {
-                vkWaitForFences(device, 1, &inFlightFences, VK_TRUE, UINT64_MAX);
-                passedBuffer.destroy();
-            }
+            // Safe without waiting, frameIndex buffers are only used by frameIndex and its slot is already free
+            passedBuffer.destroy();
             passedBuffer.device = device;
         }    
         createBuffer(stagingBuffers[id].bufferSizes[frameIndex], 
@@ -257,7 +357,8 @@ void BufferManager::createUniformBuffers(){
     }
 }
 
-void BufferManager::updateUniformBuffers(const VkExtent2D& swapChainExtent, float zoom, glm::vec2 offset, uint32_t frameIndex){
+void BufferManager::updateUniformBuffers(const VkExtent2D& swapChainExtent, float zoom, glm::vec2 offset, uint32_t physicsBodyCount, 
+    float splatThreshold, float circleAlpha, float time, uint32_t frameIndex){
     const VkDeviceSize bufferSize = sizeof(UniformBufferObject);
     static void* mappedData[MAX_FRAMES_IN_FLIGHT] = {nullptr};
 
@@ -278,6 +379,10 @@ void BufferManager::updateUniformBuffers(const VkExtent2D& swapChainExtent, floa
         -1.0f, 1.0f
     );
     ubo.viewportSize = {swapChainExtent.width, swapChainExtent.height};
+    ubo.physicsBodyCount = physicsBodyCount;
+    ubo.splatRadius = splatThreshold / zoom; // one world unit is zoom pixels
+    ubo.circleAlpha = circleAlpha;
+    ubo.time = time;
     if(!mappedData[frameIndex]){
         vkMapMemory(device, uniformBuffers[frameIndex].memory, 0, bufferSize, 0, &mappedData[frameIndex]);
     }
@@ -288,20 +393,240 @@ void BufferManager::updateUniformBuffers(const VkExtent2D& swapChainExtent, floa
 void BufferManager::createIndirectBuffers() {
     VkDeviceSize maxCommands = sizeof(VkDrawIndexedIndirectCommand) * MAX_INDIRECT_COMMANDS;
 
+    // Host visible so the per frame upload is a plain memcpy instead of a staging copy + queue wait
     for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
         indirectBuffers[i].device = device;
-        VkBufferUsageFlags flags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        VkMemoryPropertyFlags propertys = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        VkBufferUsageFlags flags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        VkMemoryPropertyFlags propertys = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         createBuffer(maxCommands, flags, propertys, indirectBuffers[i].buffer, indirectBuffers[i].memory);
+        vkMapMemory(device, indirectBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &indirectMapped[i]);
+    }
+}
+
+uint32_t BufferManager::updateIndirectBuffers(std::span<const VkDrawIndexedIndirectCommand> commands, uint32_t frameIndex) {
+    const size_t count = std::min(commands.size(), MAX_INDIRECT_COMMANDS);
+    if (count == 0) return 0;
+    memcpy(indirectMapped[frameIndex], commands.data(), count * sizeof(VkDrawIndexedIndirectCommand));
+    return static_cast<uint32_t>(count);
+}
+
+void BufferManager::createPhysicsBuffers(){
+    VkBufferUsageFlags storageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+    physicsPositionBuffer.device = device;
+    createBuffer(MAX_PHYSICS_BODIES * sizeof(glm::vec2), storageFlags | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicsPositionBuffer.buffer, physicsPositionBuffer.memory);
+
+    physicsBodyBuffer.device = device;
+    createBuffer(MAX_PHYSICS_BODIES * PHYSICS_BODY_SIZE, storageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 
+        physicsBodyBuffer.buffer, physicsBodyBuffer.memory);
+
+    physicsGridBuffer.device = device;
+    createBuffer(PHYSICS_HASH_CELLS * (PHYSICS_CELL_CAPACITY + 1) * sizeof(uint32_t), storageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 
+        physicsGridBuffer.buffer, physicsGridBuffer.memory);
+
+    VkMemoryPropertyFlags readbackFlags = readbackMemoryFlags();
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        physicsReadbackBuffers[i].device = device;
+        createBuffer(MAX_PHYSICS_BODIES * sizeof(glm::vec2), VK_BUFFER_USAGE_TRANSFER_DST_BIT, readbackFlags, 
+            physicsReadbackBuffers[i].buffer, physicsReadbackBuffers[i].memory);
+        vkMapMemory(device, physicsReadbackBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &physicsReadbackMapped[i]);
+    }
+}
+
+// Device local like the physics buffers. The adjacency only changes with the graph, so it goes through a
+// per frame staging buffer that the frame copies from before its layout passes
+void BufferManager::createLayoutBuffers(){
+    VkBufferUsageFlags storageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+    layoutAccumBuffer.device = device;
+    createBuffer((LAYOUT_ACCUM_HEADER + 3 * static_cast<VkDeviceSize>(LAYOUT_FINEST_CELLS)) * sizeof(uint32_t), storageFlags,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, layoutAccumBuffer.buffer, layoutAccumBuffer.memory);
+
+    layoutTreeBuffer.device = device;
+    createBuffer(static_cast<VkDeviceSize>(LAYOUT_TREE_CELLS) * sizeof(glm::vec4), storageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        layoutTreeBuffer.buffer, layoutTreeBuffer.memory);
+
+    layoutAdjacencyBuffer.device = device;
+    createBuffer(static_cast<VkDeviceSize>(LAYOUT_ADJACENCY_SIZE) * sizeof(uint32_t), storageFlags | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, layoutAdjacencyBuffer.buffer, layoutAdjacencyBuffer.memory);
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        layoutStagingBuffers[i].device = device;
+        createBuffer(static_cast<VkDeviceSize>(LAYOUT_ADJACENCY_SIZE) * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            layoutStagingBuffers[i].buffer, layoutStagingBuffers[i].memory);
+        vkMapMemory(device, layoutStagingBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &layoutStagingMapped[i]);
+    }
+}
+
+void BufferManager::createPickBuffers(){
+    VkMemoryPropertyFlags readbackFlags = readbackMemoryFlags();
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        pickReadbackBuffers[i].device = device;
+        createBuffer(static_cast<VkDeviceSize>(MAX_PICK_TEXELS) * PICK_TEXEL_SIZE, VK_BUFFER_USAGE_TRANSFER_DST_BIT, readbackFlags, 
+            pickReadbackBuffers[i].buffer, pickReadbackBuffers[i].memory);
+        vkMapMemory(device, pickReadbackBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &pickReadbackMapped[i]);
+    }
+}
+
+// Device local and shared by every frame like the physics buffers, cleared by the splat pass itself
+void BufferManager::createSplatBuffer(uint32_t pixels){
+    splatBuffer.device = device;
+    createBuffer(static_cast<VkDeviceSize>(pixels) * SPLAT_TEXEL_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, splatBuffer.buffer, splatBuffer.memory);
+    splatCapacity = pixels;
+}
+
+void BufferManager::reserveSplatBuffer(const VkExtent2D& extent){
+    const uint32_t pixels = extent.width * extent.height;
+    if (pixels <= splatCapacity) {
+        return;
     }
+    // Every frame in flight may still use it, only happens when the window grows past its biggest size so far
+    vkDeviceWaitIdle(device);
+    splatBuffer.destroy();
+    createSplatBuffer(pixels);
 }
 
-void BufferManager::updateIndirectBuffers(std::span<const VkDrawIndexedIndirectCommand> commands, std::vector<VkFence>& inFlightFences, uint32_t frameIndex) {
-    VkDeviceSize size = commands.size() * sizeof(VkDrawIndexedIndirectCommand);
+void BufferManager::createHeatmapGridBuffer(uint32_t cells){
+    heatmapGridBuffer.device = device;
+    createBuffer((HEATMAP_GRID_HEADER * sizeof(uint32_t)) + static_cast<VkDeviceSize>(cells) * HEATMAP_CELL_SIZE, 
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 
+        heatmapGridBuffer.buffer, heatmapGridBuffer.memory);
+    heatmapCapacity = cells;
+}
+
+void BufferManager::createHeatmapBuffers(uint32_t cells){
+    createHeatmapGridBuffer(cells);
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        heatmapUniformBuffers[i].device = device;
+        createBuffer(sizeof(HeatmapUniform), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 
+            heatmapUniformBuffers[i].buffer, heatmapUniformBuffers[i].memory);
+        vkMapMemory(device, heatmapUniformBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &heatmapUniformMapped[i]);
+    }
+}
 
-    if (size == 0) return;
-    VkBufferUsageFlags flags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-    updateBuffer(inFlightFences[frameIndex], commands.data(), size, frameIndex, flags, BufferType::Indirect);
+// Same rule as the splat buffer, only grows and waits for the device when it does
+void BufferManager::reserveHeatmapGrid(uint32_t cells){
+    if (cells <= heatmapCapacity) {
+        return;
+    }
+    vkDeviceWaitIdle(device);
+    heatmapGridBuffer.destroy();
+    createHeatmapGridBuffer(cells);
+}
+
+void BufferManager::updateHeatmapUniform(const HeatmapUniform& uniform, uint32_t frameIndex){
+    memcpy(heatmapUniformMapped[frameIndex], &uniform, sizeof(HeatmapUniform));
+}
+
+// The distance field is built on the CPU (a few ms) and copied once, text.frag samples it with a linear sampler
+void BufferManager::createGlyphAtlas(){
+    std::vector<uint8_t> pixels = buildGlyphAtlas();
+    glyphAtlas.format = VK_FORMAT_R8_UNORM;
+    glyphAtlas.extent = {FONT_ATLAS_WIDTH, FONT_ATLAS_HEIGHT};
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = glyphAtlas.format;
+    imageInfo.extent = {glyphAtlas.extent.width, glyphAtlas.extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateImage(device, &imageInfo, nullptr, &glyphAtlas.image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create glyph atlas image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, glyphAtlas.image, &memRequirements);
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &glyphAtlas.Memory) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate glyph atlas memory!");
+    }
+    vkBindImageMemory(device, glyphAtlas.image, glyphAtlas.Memory, 0);
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    createBuffer(pixels.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    void* data;
+    vkMapMemory(device, stagingBufferMemory, 0, pixels.size(), 0, &data);
+        memcpy(data, pixels.data(), pixels.size());
+    vkUnmapMemory(device, stagingBufferMemory);
+
+    VkCommandBufferAllocateInfo commandInfo{};
+    commandInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandInfo.commandPool = commandPool;
+    commandInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer;
+    vkAllocateCommandBuffers(device, &commandInfo, &commandBuffer);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = glyphAtlas.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = imageInfo.extent;
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, glyphAtlas.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    VkFence fence;
+    VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    vkCreateFence(device, &fenceInfo, nullptr, &fence);
+
+    vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence);
+    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+
+    vkDestroyFence(device, fence, nullptr);
+    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+    vkDestroyBuffer(device, stagingBuffer, nullptr);
+    vkFreeMemory(device, stagingBufferMemory, nullptr);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = glyphAtlas.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = glyphAtlas.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (vkCreateImageView(device, &viewInfo, nullptr, &glyphAtlas.view) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create glyph atlas image view!");
+    }
 }
 
 void BufferManager::createCustomBuffers(){
@@ -309,7 +634,7 @@ void BufferManager::createCustomBuffers(){
 
     VkBufferUsageFlags indexFlags = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
-    VkBufferUsageFlags instanceFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    VkBufferUsageFlags instanceFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; // storage for the physics sync pass
 
     VkMemoryPropertyFlags memoryFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
@@ -341,42 +666,179 @@ void BufferManager::createCustomBuffers(){
         createBuffer(MAX_INSTANCED_OBJECTS, instanceFlags, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, instanceBuffers[i].buffer, instanceBuffers[i].memory);
         vkMapMemory(device, instanceBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &instancedMapped[i]);
     }
-        ssbo.device = device;
-        createBuffer(MAX_SSBO_OBJECTS, ssboFlags, ssboMemoryFlags, ssbo.buffer, ssbo.memory);
-        vkMapMemory(device, ssbo.memory, 0, VK_WHOLE_SIZE, 0, &ssboMapped);
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        edgeBuffers[i].device = device;
+        createBuffer(static_cast<VkDeviceSize>(MAX_EDGES) * sizeof(EdgeData), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, edgeBuffers[i].buffer, edgeBuffers[i].memory);
+        vkMapMemory(device, edgeBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &edgeMapped[i]);
+    }
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        textBuffers[i].device = device;
+        createBuffer(static_cast<VkDeviceSize>(MAX_TEXTS) * sizeof(TextData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, textBuffers[i].buffer, textBuffers[i].memory);
+        vkMapMemory(device, textBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &textMapped[i]);
+
+        glyphBuffers[i].device = device;
+        createBuffer(static_cast<VkDeviceSize>(MAX_GLYPHS) * sizeof(GlyphData), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, glyphBuffers[i].buffer, glyphBuffers[i].memory);
+        vkMapMemory(device, glyphBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &glyphMapped[i]);
+    }
+    VkMemoryRequirements instanceRequirements;
+    vkGetBufferMemoryRequirements(device, instanceBuffers[0].buffer, &instanceRequirements);
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+    uint32_t instanceMemoryType = findMemoryType(instanceRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    instanceWriteCombined = !(memProperties.memoryTypes[instanceMemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        ssboBuffers[i].device = device;
+        createBuffer(MAX_SSBO_OBJECTS, ssboFlags, ssboMemoryFlags, ssboBuffers[i].buffer, ssboBuffers[i].memory);
+        vkMapMemory(device, ssboBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &ssboMapped[i]);
+    }
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        tweenBuffers[i].device = device;
+        createBuffer(static_cast<VkDeviceSize>(MAX_TWEENS) * sizeof(TweenData), ssboFlags, ssboMemoryFlags, tweenBuffers[i].buffer, tweenBuffers[i].memory);
+        vkMapMemory(device, tweenBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &tweenMapped[i]);
+    }
 }
 
 
-void BufferManager::updateCustomBuffers(std::span<Vertex> vertices, std::span<uint16_t> indices, WorldData& worldData, std::span<VkFence> inFlightFences, uint32_t frameIndex){
+void BufferManager::updateCustomBuffers(std::span<Vertex> vertices, std::span<uint16_t> indices, WorldData& worldData, uint32_t frameIndex, JobSystem& jobs){
     static std::array<bool, MAX_FRAMES_IN_FLIGHT> pendingMeshes = {};
     if (worldData.dirtyFlags.meshes) {
         for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) pendingMeshes[i] = true;
     }
+    if (worldData.dirtyFlags.circles || !worldData.gpuPhysics) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) pendingCircles[i] = true;
+    }
+    if (worldData.dirtyFlags.texts) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) pendingTexts[i] = true;
+    }
+    if (worldData.dirtyFlags.glyphs) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) pendingGlyphs[i] = true;
+    }
+    if (worldData.dirtyFlags.edges) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) pendingEdges[i] = true;
+    }
 
     VkDeviceSize vertexSize = vertices.size() * sizeof(Vertex);
     VkDeviceSize indexSize = indices.size() * sizeof(uint16_t);
-    VkDeviceSize instanceSize = (worldData.polygonOffset + worldData.polygonInstances.size()) * sizeof(InstanceData);
-    VkDeviceSize ssboSize = worldData.ssboData.size() * sizeof(SSBO);
+    constexpr size_t instanceCapacity = MAX_INSTANCED_OBJECTS / sizeof(InstanceData);
+    VkDeviceSize instanceSize = std::min<size_t>(worldData.polygonOffset + worldData.polygonInstances.size(), instanceCapacity) * sizeof(InstanceData);
 
     VkBufferUsageFlags vertexFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
     VkBufferUsageFlags indexFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
     VkBufferUsageFlags instanceFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
     if(pendingMeshes[frameIndex]){
-        updateBuffer(inFlightFences[frameIndex], vertices.data(), vertexSize, frameIndex, vertexFlags, BufferType::Vertex);
-        updateBuffer(inFlightFences[frameIndex], indices.data(), indexSize, frameIndex, indexFlags, BufferType::Index);
+        updateBuffer(vertices.data(), vertexSize, frameIndex, vertexFlags, BufferType::Vertex);
+        updateBuffer(indices.data(), indexSize, frameIndex, indexFlags, BufferType::Index);
         pendingMeshes[frameIndex] = false;
     }//updateBuffer(inFlightFences[frameIndex], instanceData.data(), instanceSize, frameIndex, instanceFlags, BufferType::Instance);
+    const auto uploadStart = std::chrono::steady_clock::now();
+    uploadBytes = instanceSize;
     if(instanceSize > 0){
         InstanceData* dst = reinterpret_cast<InstanceData*>(instancedMapped[frameIndex]);
-        memcpy(dst, worldData.circleInstances.data(), worldData.circleInstances.size() * sizeof(InstanceData));
-        dst += worldData.circleInstances.size();
-        memcpy(dst, worldData.lineInstances.data(), worldData.lineInstances.size() * sizeof(InstanceData));
-        dst += worldData.lineInstances.size();
-        memcpy(dst, worldData.polygonInstances.data(), worldData.polygonInstances.size() * sizeof(InstanceData));
+        // Whatever doesn't fit the buffer anymore is left out, the API keeps the scene under it
+        size_t room = instanceCapacity;
+        auto fit = [&room](std::span<const InstanceData> instances){
+            instances = instances.first(std::min(instances.size(), room));
+            room -= instances.size();
+            return instances;
+        };
+        const std::span<const InstanceData> circles = fit(worldData.circleInstances);
+        const std::span<const InstanceData> lines = fit(worldData.lineInstances);
+        const std::span<const InstanceData> polygons = fit(worldData.polygonInstances);
+        // With GPU physics nothing on the CPU moves the circles, this slot still has them unless they changed
+        if(pendingCircles[frameIndex]){
+            uploadInstances(dst, circles, jobs);
+            pendingCircles[frameIndex] = false;
+        } else {
+            uploadBytes -= circles.size_bytes();
+        }
+        dst += circles.size();
+        uploadInstances(dst, lines, jobs);
+        dst += lines.size();
+        uploadInstances(dst, polygons, jobs);
+    }
+    // Edges and texts only when something changed, an edge or a label that follows its circle doesn't
+    if(pendingEdges[frameIndex]){
+        const std::span<const EdgeData> edges = worldData.edges.first(std::min<size_t>(worldData.edges.size(), MAX_EDGES));
+        uploadRecords(edgeMapped[frameIndex], edges, jobs);
+        uploadBytes += edges.size_bytes();
+        pendingEdges[frameIndex] = false;
     }
-    if(ssboSize > 0 && worldData.dirtyFlags.ssbo){
-        memcpy(ssboMapped, worldData.ssboData.data(), ssboSize);
+    if(pendingTexts[frameIndex]){
+        const std::span<const TextData> texts = worldData.texts.first(std::min<size_t>(worldData.texts.size(), MAX_TEXTS));
+        uploadRecords(textMapped[frameIndex], texts, jobs);
+        uploadBytes += texts.size_bytes();
+        pendingTexts[frameIndex] = false;
     }
+    if(pendingGlyphs[frameIndex]){
+        const std::span<const GlyphData> glyphs = worldData.glyphs.first(std::min<size_t>(worldData.glyphs.size(), MAX_GLYPHS));
+        uploadRecords(glyphMapped[frameIndex], glyphs, jobs);
+        uploadBytes += glyphs.size_bytes();
+        pendingGlyphs[frameIndex] = false;
+    }
+    uploadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+    // Only the outline slots touched since the last upload get written, every frame copy catches up
+    // on its own turn with the current value of the slot
+    for(uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        pendingSsboSlots[i].insert(pendingSsboSlots[i].end(), worldData.ssboDirtySlots.begin(), worldData.ssboDirtySlots.end());
+    }
+    SSBO* ssboDst = reinterpret_cast<SSBO*>(ssboMapped[frameIndex]);
+    for(uint32_t slot : pendingSsboSlots[frameIndex]){
+        if(slot >= worldData.ssboData.size()) continue; // slot went away with a full resync
+        ssboDst[slot] = worldData.ssboData[slot];
+    }
+    pendingSsboSlots[frameIndex].clear();
+
+    // Tween slots the same way, a slot only gets written when a tween starts or ends
+    for(uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        pendingTweenSlots[i].insert(pendingTweenSlots[i].end(), worldData.tweenDirtySlots.begin(), worldData.tweenDirtySlots.end());
+    }
+    TweenData* tweenDst = reinterpret_cast<TweenData*>(tweenMapped[frameIndex]);
+    for(uint32_t slot : pendingTweenSlots[frameIndex]){
+        if(slot >= worldData.tweenData.size()) continue;
+        tweenDst[slot] = worldData.tweenData[slot];
+    }
+    pendingTweenSlots[frameIndex].clear();
+}
+
+// Split on bytes rather than instances: every job boundary is a 64 byte aligned address of dst, so no two jobs write
+// the same cache line. Job 0 also takes the bytes before the first boundary
+void BufferManager::uploadInstances(InstanceData* dst, std::span<const InstanceData> src, JobSystem& jobs){
+    constexpr size_t LINE = 64;
+    const size_t bytes = src.size_bytes();
+    if(bytes == 0){
+        return;
+    }
+    std::byte* out = reinterpret_cast<std::byte*>(dst);
+    const std::byte* in = reinterpret_cast<const std::byte*>(src.data());
+    const size_t head = std::min(bytes, (LINE - reinterpret_cast<uintptr_t>(out) % LINE) % LINE);
+    const size_t lines = std::max<size_t>((bytes - head + LINE - 1) / LINE, 1);
+    const bool stream = instanceWriteCombined;
+    jobs.parallelForRange(lines, INSTANCE_COPY_GRAIN * sizeof(InstanceData) / LINE, [out, in, bytes, head, stream](size_t begin, size_t end){
+        const size_t first = begin == 0 ? 0 : head + begin * LINE;
+        const size_t last = std::min(head + end * LINE, bytes);
+        if(stream){
+            streamCopy(out + first, in + first, last - first);
+        } else {
+            memcpy(out + first, in + first, last - first);
+        }
+    });
+}
+
+// Edges, texts and glyphs, small records straight into a mapped buffer
+template <typename T>
+void BufferManager::uploadRecords(void* mapped, std::span<const T> src, JobSystem& jobs){
+    T* dst = static_cast<T*>(mapped);
+    const bool stream = instanceWriteCombined;
+    jobs.parallelForRange(src.size(), INSTANCE_COPY_GRAIN, [dst, src, stream](size_t begin, size_t end){
+        if(stream){
+            streamCopy(dst + begin, src.data() + begin, (end - begin) * sizeof(T));
+        } else {
+            memcpy(dst + begin, src.data() + begin, (end - begin) * sizeof(T));
+        }
+    });
 }
 
 void BufferManager::cleanUp(){
@@ -388,9 +850,31 @@ void BufferManager::cleanUp(){
         indexBuffers[i].destroy();
         uniformBuffers[i].destroy();
         instanceBuffers[i].destroy();
+        edgeBuffers[i].destroy();
+        textBuffers[i].destroy();
+        glyphBuffers[i].destroy();
         indirectBuffers[i].destroy();
+        ssboBuffers[i].destroy();
+        tweenBuffers[i].destroy();
+        physicsReadbackBuffers[i].destroy();
+        layoutStagingBuffers[i].destroy();
+        pickReadbackBuffers[i].destroy();
+        heatmapUniformBuffers[i].destroy();
+    }
+    physicsPositionBuffer.destroy();
+    physicsBodyBuffer.destroy();
+    physicsGridBuffer.destroy();
+    layoutAccumBuffer.destroy();
+    layoutTreeBuffer.destroy();
+    layoutAdjacencyBuffer.destroy();
+    splatBuffer.destroy();
+    heatmapGridBuffer.destroy();
+    if (glyphAtlas.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, glyphAtlas.view, nullptr);
+        vkDestroyImage(device, glyphAtlas.image, nullptr);
+        vkFreeMemory(device, glyphAtlas.Memory, nullptr);
+        glyphAtlas = {};
     }
-    ssbo.destroy();
 
     for (auto& dyn : stagingBuffers) {
         if (dyn.isMapped) {
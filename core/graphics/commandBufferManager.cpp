@@ -1,5 +1,6 @@
 #include <ThING/extras/vulkanSupport.h>
 #include <ThING/graphics/commandBufferManager.h>
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -13,6 +14,7 @@
 #include "ThING/types/enums.h"
 #include "ThING/types/renderData.h"
 #include "ThING/types/renderImage.h"
+#include "ThING/types/splat.h"
 #include "backends/imgui_impl_vulkan.h"
 
 CommandBufferManager::CommandBufferManager() {
@@ -44,6 +46,56 @@ void CommandBufferManager::createCommandBuffers(VkDevice& device, VkSurfaceKHR&
     }
 }
 
+void CommandBufferManager::createQueryPool(VkPhysicalDevice& physicalDevice, VkDevice& device, VkSurfaceKHR& surface) {
+    QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice, surface);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    const uint32_t validBits = queueFamilies[queueFamilyIndices.graphicsFamily.value()].timestampValidBits;
+    if (validBits == 0) {
+        return;
+    }
+    timestampMask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    timestampPeriod = properties.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo queryInfo{};
+    queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryInfo.queryCount = MAX_FRAMES_IN_FLIGHT * 2;
+
+    if (vkCreateQueryPool(device, &queryInfo, nullptr, &timestampPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+}
+
+bool CommandBufferManager::readGpuTime(VkDevice& device, uint32_t currentFrame, float& gpuTime) {
+    if (timestampPool == VK_NULL_HANDLE) {
+        return false;
+    }
+    std::array<uint64_t, 2> timestamps{};
+    VkResult result = vkGetQueryPoolResults(device, timestampPool, currentFrame * 2, 2, sizeof(timestamps), 
+        timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return false;
+    }
+    const uint64_t ticks = (timestamps[1] - timestamps[0]) & timestampMask;
+    gpuTime = static_cast<float>(static_cast<double>(ticks) * timestampPeriod * 1e-6);
+    return true;
+}
+
+void CommandBufferManager::cleanUpQueryPool(VkDevice& device){
+    if (timestampPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, timestampPool, nullptr);
+        timestampPool = VK_NULL_HANDLE;
+    }
+}
+
 void CommandBufferManager::cleanUpCommandBuffers(VkDevice& device){
     vkFreeCommandBuffers(device, commandPool,
         static_cast<uint32_t>(commandBuffers.size()),
@@ -179,8 +231,9 @@ void CommandBufferManager::recordInstanceDraw(VkCommandBuffer& commandBuffer, co
 }
 
 void CommandBufferManager::recordIndirectDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, uint32_t commandCount){
+    if (commandCount == 0) return;
     VkBuffer vb[] = {
-        renderContext.bufferManager.viewBuffer(BufferType::Vertex, 0).buffer,
+        renderContext.bufferManager.viewBuffer(BufferType::Vertex, renderContext.currentFrame).buffer,
         renderContext.bufferManager.viewBuffer(BufferType::Instance, renderContext.currentFrame).buffer
     };
 
@@ -188,7 +241,7 @@ void CommandBufferManager::recordIndirectDraw(VkCommandBuffer& commandBuffer, co
 
     vkCmdBindVertexBuffers(commandBuffer, 0, 2, vb, offsets);
 
-    VkBuffer ib = renderContext.bufferManager.viewBuffer(BufferType::Index, 0).buffer;
+    VkBuffer ib = renderContext.bufferManager.viewBuffer(BufferType::Index, renderContext.currentFrame).buffer;
 
     vkCmdBindIndexBuffer(commandBuffer, ib, 0, VK_INDEX_TYPE_UINT16);
 
@@ -197,6 +250,51 @@ void CommandBufferManager::recordIndirectDraw(VkCommandBuffer& commandBuffer, co
     vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, 0, commandCount, sizeof(VkDrawIndexedIndirectCommand));
 }
 
+// Edges go before the circles, at a lower draw index than both their circles, so the circles blend over their ends
+void CommandBufferManager::recordEdgeDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext){
+    const uint32_t edgeCount = static_cast<uint32_t>(std::min<size_t>(renderContext.worldData.edges.size(), MAX_EDGES));
+    if (edgeCount == 0 || renderContext.heatmap.circlesHidden) return;
+    commandBindPipeline(commandBuffer, renderContext.currentFrame, frameContext, PipelineType::Edge);
+
+    const EdgePushConstants constants{static_cast<uint32_t>(renderContext.worldData.circleInstances.size())};
+    vkCmdPushConstants(commandBuffer, frameContext.pipelineManager.viewLayouts()[toIndex(PipelineType::Edge)], 
+        VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(EdgePushConstants), &constants);
+
+    VkBuffer vb[] = {
+        renderContext.bufferManager.viewBuffer(BufferType::QuadVertex, 0).buffer,
+        renderContext.bufferManager.viewBuffer(BufferType::Edge, renderContext.currentFrame).buffer
+    };
+    VkDeviceSize offsets[] = {0, 0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 2, vb, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, renderContext.bufferManager.viewBuffer(BufferType::QuadIndex, 0).buffer, 0, VK_INDEX_TYPE_UINT16);
+
+    vkCmdDrawIndexed(commandBuffer, QUAD_INDICES.size(), edgeCount, 0, 0, 0);
+}
+
+// Last in the base pass so labels sit over everything with their draw index, splatted circles included
+void CommandBufferManager::recordTextDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext){
+    const uint32_t glyphCount = static_cast<uint32_t>(std::min<size_t>(renderContext.worldData.glyphs.size(), MAX_GLYPHS));
+    if (glyphCount == 0) return;
+    commandBindPipeline(commandBuffer, renderContext.currentFrame, frameContext, PipelineType::Text);
+
+    const TextPushConstants constants{
+        static_cast<uint32_t>(renderContext.worldData.circleInstances.size()),
+        static_cast<uint32_t>(std::min<size_t>(renderContext.worldData.texts.size(), MAX_TEXTS))
+    };
+    vkCmdPushConstants(commandBuffer, frameContext.pipelineManager.viewLayouts()[toIndex(PipelineType::Text)], 
+        VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(TextPushConstants), &constants);
+
+    VkBuffer vb[] = {
+        renderContext.bufferManager.viewBuffer(BufferType::QuadVertex, 0).buffer,
+        renderContext.bufferManager.viewBuffer(BufferType::Glyph, renderContext.currentFrame).buffer
+    };
+    VkDeviceSize offsets[] = {0, 0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 2, vb, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, renderContext.bufferManager.viewBuffer(BufferType::QuadIndex, 0).buffer, 0, VK_INDEX_TYPE_UINT16);
+
+    vkCmdDrawIndexed(commandBuffer, QUAD_INDICES.size(), glyphCount, 0, 0, 0);
+}
+
 void CommandBufferManager::cmdPipelineBarrier(VkCommandBuffer& commandBuffer, VkPipelineStageFlags srcStage, 
     VkPipelineStageFlags dstStage, VkImageMemoryBarrier& barrier){
     vkCmdPipelineBarrier(
@@ -213,6 +311,273 @@ void CommandBufferManager::cmdPipelineBarrier(VkCommandBuffer& commandBuffer, Vk
     );
 }
 
+void CommandBufferManager::cmdMemoryBarrier(VkCommandBuffer& commandBuffer, VkPipelineStageFlags srcStage, 
+    VkPipelineStageFlags dstStage, VkAccessFlags srcAccess, VkAccessFlags dstAccess){
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        srcStage,
+        dstStage,
+        0,
+        1, 
+        &barrier,
+        0, 
+        nullptr,
+        0, 
+        nullptr
+    );
+}
+
+// Sync, then substeps of integrate -> clear grid -> fill grid -> collide -> apply, all on the device local
+// physics buffers. Every pass reads what the one before wrote, so there is a barrier after each dispatch
+void CommandBufferManager::recordPhysicsPass(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext) {
+    const PhysicsFrame& physics = renderContext.physics;
+    const uint32_t bodyCount = physics.constants.bodyCount;
+    if (!physics.enabled || bodyCount == 0) {
+        return;
+    }
+    const VkPipelineLayout layout = frameContext.pipelineManager.viewLayouts()[toIndex(PipelineType::Physics)];
+    const VkDescriptorSet ds = frameContext.pipelineManager.viewPhysicsDescriptorSets()[renderContext.currentFrame];
+
+    // Last frame's vertex shader and readback copy have to be done with the positions before they move
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    if (physics.layout) {
+        recordLayoutPasses(commandBuffer, renderContext, frameContext);
+    } else {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, frameContext.pipelineManager.viewPipelines()[toIndex(PipelineType::Physics)]);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &ds, 0, nullptr);
+
+        PhysicsPushConstants constants = physics.constants;
+        auto dispatch = [&](PhysicsPass pass, uint32_t count) {
+            constexpr uint32_t LOCAL = 256;
+            constants.pass = static_cast<uint32_t>(pass);
+            vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PhysicsPushConstants), &constants);
+            vkCmdDispatch(commandBuffer, (count + LOCAL - 1) / LOCAL, 1, 1);
+            cmdMemoryBarrier(commandBuffer,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_ACCESS_SHADER_WRITE_BIT,
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        };
+
+        dispatch(PhysicsPass::Sync, bodyCount);
+        for (uint32_t s = 0; s < physics.substeps; s++) {
+            dispatch(PhysicsPass::Integrate, bodyCount);
+            dispatch(PhysicsPass::ClearGrid, PHYSICS_HASH_CELLS);
+            dispatch(PhysicsPass::FillGrid, bodyCount);
+            dispatch(PhysicsPass::Collide, bodyCount);
+            dispatch(PhysicsPass::Apply, bodyCount);
+        }
+    }
+
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+
+    if (!physics.readback) {
+        return;
+    }
+    VkBufferCopy region{};
+    region.size = bodyCount * sizeof(glm::vec2);
+    vkCmdCopyBuffer(commandBuffer, 
+        renderContext.bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer,
+        renderContext.bufferManager.viewBuffer(BufferType::PhysicsReadback, renderContext.currentFrame).buffer,
+        1, &region);
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_HOST_READ_BIT);
+}
+
+// Same positions and bodies as the physics passes, called from recordPhysicsPass once the last frame let go of them.
+// A changed graph first copies its staged CSR in, then every iteration rebuilds the grid pyramid bottom up before the forces
+void CommandBufferManager::recordLayoutPasses(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext) {
+    const PhysicsFrame& physics = renderContext.physics;
+    const uint32_t bodyCount = physics.layoutConstants.bodyCount;
+    const VkPipelineLayout layout = frameContext.pipelineManager.viewLayouts()[toIndex(PipelineType::Layout)];
+    const VkDescriptorSet ds = frameContext.pipelineManager.viewLayoutDescriptorSets()[renderContext.currentFrame];
+
+    if (physics.adjacencySize > 0) {
+        // Earlier frames may still read the old adjacency
+        cmdMemoryBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            VK_ACCESS_TRANSFER_WRITE_BIT);
+        VkBufferCopy region{};
+        region.size = static_cast<VkDeviceSize>(physics.adjacencySize) * sizeof(uint32_t);
+        vkCmdCopyBuffer(commandBuffer,
+            renderContext.bufferManager.viewBuffer(BufferType::LayoutStaging, renderContext.currentFrame).buffer,
+            renderContext.bufferManager.viewBuffer(BufferType::LayoutAdjacency, 0).buffer,
+            1, &region);
+        cmdMemoryBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, frameContext.pipelineManager.viewPipelines()[toIndex(PipelineType::Layout)]);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &ds, 0, nullptr);
+
+    LayoutPushConstants constants = physics.layoutConstants;
+    auto dispatch = [&](LayoutPass pass, uint32_t count) {
+        constexpr uint32_t LOCAL = 256;
+        constants.pass = static_cast<uint32_t>(pass);
+        vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(LayoutPushConstants), &constants);
+        vkCmdDispatch(commandBuffer, (count + LOCAL - 1) / LOCAL, 1, 1);
+        cmdMemoryBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    };
+
+    dispatch(LayoutPass::Sync, bodyCount);
+    dispatch(LayoutPass::Place, bodyCount);
+    float temperature = physics.temperature;
+    for (uint32_t i = 0; i < physics.iterations; i++) {
+        constants.maxStep = temperature * constants.springLength;
+        dispatch(LayoutPass::Clear, LAYOUT_FINEST_CELLS);
+        dispatch(LayoutPass::Bounds, bodyCount);
+        dispatch(LayoutPass::Fill, bodyCount);
+        dispatch(LayoutPass::Reduce, LAYOUT_FINEST_CELLS);
+        for (uint32_t level = LAYOUT_GRID_LEVELS; level-- > 0;) {
+            constants.level = level;
+            dispatch(LayoutPass::Downsample, 1u << (2 * level));
+        }
+        dispatch(LayoutPass::Force, bodyCount);
+        dispatch(LayoutPass::Apply, bodyCount);
+        temperature = std::max(temperature * physics.cooling, LAYOUT_MIN_TEMPERATURE); // same steps GpuPhysics took
+    }
+}
+
+// Depth race then claim over every circle, both write the splat buffer with atomics so a pixel ends up with the
+// topmost small circle on it. The resolve draw inside the base pass turns that into color, id and seed
+void CommandBufferManager::recordSplatPass(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext) {
+    if (renderContext.splatCircles == 0) {
+        return;
+    }
+    const VkPipelineLayout layout = frameContext.pipelineManager.viewLayouts()[toIndex(PipelineType::Splat)];
+    const VkDescriptorSet ds = frameContext.pipelineManager.viewSplatDescriptorSets()[renderContext.currentFrame];
+    const VkExtent2D extent = frameContext.swapChainManager.getExtent();
+    const Buffer& splat = renderContext.bufferManager.viewBuffer(BufferType::Splat, 0);
+
+    // Last frame's resolve has to be done reading before the clear
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdFillBuffer(commandBuffer, splat.buffer, 0, static_cast<VkDeviceSize>(extent.width) * extent.height * SPLAT_TEXEL_SIZE, 0);
+    // Physics may have just moved the circles too
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, frameContext.pipelineManager.viewPipelines()[toIndex(PipelineType::Splat)]);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &ds, 0, nullptr);
+
+    constexpr uint32_t LOCAL = 256;
+    SplatPushConstants constants{renderContext.splatCircles, 0};
+    for (uint32_t pass = 0; pass < static_cast<uint32_t>(SplatPass::Count); pass++) {
+        constants.pass = pass;
+        vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SplatPushConstants), &constants);
+        vkCmdDispatch(commandBuffer, (renderContext.splatCircles + LOCAL - 1) / LOCAL, 1, 1);
+        cmdMemoryBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    }
+}
+
+// Bins every alive circle into the grid, the post pass maps it through the colormap
+void CommandBufferManager::recordHeatmapPass(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext) {
+    const HeatmapFrame& heatmap = renderContext.heatmap;
+    if (heatmap.circleCount == 0) {
+        return;
+    }
+    const VkPipelineLayout layout = frameContext.pipelineManager.viewLayouts()[toIndex(PipelineType::HeatmapGrid)];
+    const VkDescriptorSet ds = frameContext.pipelineManager.viewHeatmapGridDescriptorSets()[renderContext.currentFrame];
+    const Buffer& grid = renderContext.bufferManager.viewBuffer(BufferType::HeatmapGrid, 0);
+
+    // Last frame's post pass has to be done reading before the clear
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdFillBuffer(commandBuffer, grid.buffer, 0, HEATMAP_GRID_HEADER * sizeof(uint32_t) + static_cast<VkDeviceSize>(heatmap.cells) * HEATMAP_CELL_SIZE, 0);
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, frameContext.pipelineManager.viewPipelines()[toIndex(PipelineType::HeatmapGrid)]);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &ds, 0, nullptr);
+
+    constexpr uint32_t LOCAL = 256;
+    const HeatmapPushConstants constants{heatmap.circleCount};
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HeatmapPushConstants), &constants);
+    vkCmdDispatch(commandBuffer, (heatmap.circleCount + LOCAL - 1) / LOCAL, 1, 1);
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT);
+}
+
+// The id image leaves the base pass in GENERAL, the JFA pass only reads it so the copy can go first
+void CommandBufferManager::recordPickCopy(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext) {
+    const PickFrame& picks = renderContext.picks;
+    if (picks.count == 0) {
+        return;
+    }
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT);
+
+    std::array<VkBufferImageCopy, MAX_PICKS_PER_FRAME> regions{};
+    for (uint32_t i = 0; i < picks.count; i++) {
+        const PickRegion& pick = picks.regions[i];
+        regions[i].bufferOffset = static_cast<VkDeviceSize>(pick.bufferOffset) * PICK_TEXEL_SIZE;
+        regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        regions[i].imageSubresource.layerCount = 1;
+        regions[i].imageOffset = {pick.offset.x, pick.offset.y, 0};
+        regions[i].imageExtent = {pick.extent.width, pick.extent.height, 1};
+    }
+    vkCmdCopyImageToBuffer(commandBuffer,
+        frameContext.swapChainManager.viewIdImages().image,
+        VK_IMAGE_LAYOUT_GENERAL,
+        renderContext.bufferManager.viewBuffer(BufferType::PickReadback, renderContext.currentFrame).buffer,
+        picks.count, regions.data());
+
+    // The next base pass must not overwrite the id image before the copy read it
+    cmdMemoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_HOST_READ_BIT);
+}
+
 void CommandBufferManager::cmdBindComputePipeline(VkCommandBuffer& commandBuffer, const FrameContext& frameContext, uint32_t currentFrame) {
     vkCmdBindPipeline(
         commandBuffer,
@@ -461,15 +826,21 @@ void CommandBufferManager::transitionImageToGeneral(VkCommandBuffer commandBuffe
 }
 
 void CommandBufferManager::recordCommandBuffer(uint32_t currentFrame, const RenderContext& renderContext, const FrameContext& frameContext) {
+    // Circles fully faded into the heatmap are left out, lines come right after them
+    const uint32_t firstQuad = renderContext.heatmap.circlesHidden ? static_cast<uint32_t>(renderContext.worldData.circleInstances.size()) : 0;
     DrawBatch quadBatch = {
         .vertexBuffer = BufferType::QuadVertex,
         .indexBuffer = BufferType::QuadIndex,
         .indexCount = QUAD_INDICES.size(),
         .indexOffset = 0,
-        .instanceCount = static_cast<uint32_t>(renderContext.worldData.polygonOffset),
-        .instanceOffset = 0,
+        .instanceCount = static_cast<uint32_t>(renderContext.worldData.polygonOffset) - firstQuad,
+        .instanceOffset = firstQuad,
     };
     cmdSetBufferBeginInfo(commandBuffers[currentFrame]);
+    if (timestampPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffers[currentFrame], timestampPool, currentFrame * 2, 2);
+        vkCmdWriteTimestamp(commandBuffers[currentFrame], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool, currentFrame * 2);
+    }
     static int layoutsInitialized[MAX_FRAMES_IN_FLIGHT] = {};
     if (!layoutsInitialized[currentFrame]) {
         transitionImageToGeneral(commandBuffers[currentFrame], frameContext.swapChainManager.viewIdImages(), frameContext);
@@ -478,17 +849,37 @@ void CommandBufferManager::recordCommandBuffer(uint32_t currentFrame, const Rend
         transitionImageToGeneral(commandBuffers[currentFrame], frameContext.swapChainManager.viewJFAPongImages(), frameContext);
         layoutsInitialized[currentFrame] = true;
     }
+    recordPhysicsPass(commandBuffers[currentFrame], renderContext, frameContext);
+    recordSplatPass(commandBuffers[currentFrame], renderContext, frameContext);
+    recordHeatmapPass(commandBuffers[currentFrame], renderContext, frameContext);
+
     cmdInitRenderPass(commandBuffers[currentFrame], frameContext, RenderPassType::Base);
         
+        recordEdgeDraw(commandBuffers[currentFrame], renderContext, frameContext);
+
         commandBindPipeline(commandBuffers[currentFrame], currentFrame, frameContext, PipelineType::Base);
         recordInstanceDraw(commandBuffers[currentFrame], renderContext, quadBatch);
         recordIndirectDraw(commandBuffers[currentFrame], renderContext, renderContext.indirectCmdCount);
 
+        if (renderContext.splatCircles > 0) {
+            commandBindPipeline(commandBuffers[currentFrame], currentFrame, frameContext, PipelineType::SplatResolve);
+            vkCmdDraw(commandBuffers[currentFrame], 3, 1, 0, 0);
+        }
+
+        recordTextDraw(commandBuffers[currentFrame], renderContext, frameContext);
+
     vkCmdEndRenderPass(commandBuffers[currentFrame]);
+
+    recordPickCopy(commandBuffers[currentFrame], renderContext, frameContext);
     
     recordJFAPass(commandBuffers[currentFrame], frameContext, currentFrame, renderContext.maxOutlineSize);
 
     cmdInitRenderPass(commandBuffers[currentFrame], frameContext, RenderPassType::Post);
+
+        if (renderContext.heatmap.circleCount > 0) {
+            commandBindPipeline(commandBuffers[currentFrame], currentFrame, frameContext, PipelineType::Heatmap);
+            vkCmdDraw(commandBuffers[currentFrame], 3, 1, 0, 0);
+        }
         
         commandBindPipeline(commandBuffers[currentFrame], currentFrame, frameContext, PipelineType::Post);
         vkCmdDraw(commandBuffers[currentFrame],3, 1, 0, 0);
@@ -501,6 +892,9 @@ void CommandBufferManager::recordCommandBuffer(uint32_t currentFrame, const Rend
 
     vkCmdEndRenderPass(commandBuffers[currentFrame]);
 
+    if (timestampPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(commandBuffers[currentFrame], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, currentFrame * 2 + 1);
+    }
     cmdEndConfiguration(commandBuffers[currentFrame]);
 }
 
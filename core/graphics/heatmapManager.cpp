@@ -0,0 +1,73 @@
+#include <ThING/graphics/heatmapManager.h>
+#include <algorithm>
+#include <span>
+
+// Inferno-like, dark and see-through for sparse cells up to a bright yellow for the densest
+static const std::array<glm::vec4, 5> DEFAULT_COLORMAP = {{
+    {0.05f, 0.03f, 0.20f, 0.55f},
+    {0.42f, 0.09f, 0.43f, 0.80f},
+    {0.87f, 0.32f, 0.23f, 0.90f},
+    {0.99f, 0.73f, 0.16f, 1.00f},
+    {0.99f, 1.00f, 0.64f, 1.00f}
+}};
+
+void HeatmapManager::setSettings(const HeatmapSettings& settings){
+    std::lock_guard<std::mutex> lock(mutex);
+    this->settings = settings;
+    this->settings.cellSize = std::max(settings.cellSize, 1u);
+    lutBuilt = false;
+}
+
+HeatmapSettings HeatmapManager::getSettings(){
+    std::lock_guard<std::mutex> lock(mutex);
+    return settings;
+}
+
+HeatmapFrame HeatmapManager::frame(float zoom, VkExtent2D extent, uint32_t circleCount, HeatmapUniform& uniform){
+    std::lock_guard<std::mutex> lock(mutex);
+    HeatmapFrame frame;
+    if(!settings.enabled || circleCount == 0){
+        return frame;
+    }
+    float weight;
+    if(settings.circleZoom > settings.heatmapZoom){
+        weight = 1.0f - glm::smoothstep(settings.heatmapZoom, settings.circleZoom, zoom);
+    } else {
+        weight = zoom <= settings.heatmapZoom ? 1.0f : 0.0f;
+    }
+    if(weight <= 0.0f){
+        return frame;
+    }
+    if(!lutBuilt){
+        buildLut();
+    }
+
+    const uint32_t cellSize = settings.cellSize;
+    uniform.gridSize = {(extent.width + cellSize - 1) / cellSize, (extent.height + cellSize - 1) / cellSize};
+    uniform.cellSize = cellSize;
+    uniform.mode = static_cast<uint32_t>(settings.mode);
+    uniform.opacity = weight;
+    uniform.maxDensity = settings.maxDensity;
+    uniform.lut = lut;
+
+    frame.circleCount = circleCount;
+    frame.cells = uniform.gridSize.x * uniform.gridSize.y;
+    frame.circleAlpha = 1.0f - weight;
+    frame.circlesHidden = weight >= 1.0f;
+    return frame;
+}
+
+// Stops are evenly spaced, the LUT samples them linearly so any stop count works the same in the shader
+void HeatmapManager::buildLut(){
+    std::span<const glm::vec4> stops = settings.colormap.empty() ? std::span<const glm::vec4>(DEFAULT_COLORMAP) : std::span<const glm::vec4>(settings.colormap);
+    for(uint32_t i = 0; i < HEATMAP_LUT_SIZE; i++){
+        if(stops.size() == 1){
+            lut[i] = stops[0];
+            continue;
+        }
+        const float t = static_cast<float>(i) / (HEATMAP_LUT_SIZE - 1) * (stops.size() - 1);
+        const size_t lo = std::min(static_cast<size_t>(t), stops.size() - 2);
+        lut[i] = glm::mix(stops[lo], stops[lo + 1], t - static_cast<float>(lo));
+    }
+    lutBuilt = true;
+}
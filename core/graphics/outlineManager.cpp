@@ -0,0 +1,138 @@
+#include "ThING/consts.h"
+#include "ThING/types/renderData.h"
+#include <ThING/graphics/outlineManager.h>
+#include <cassert>
+#include <cstdint>
+
+inline constexpr uint32_t MAX_OUTLINE_SLOTS = MAX_SSBO_OBJECTS / sizeof(SSBO);
+
+OutlineManager::OutlineManager(){
+    reset();
+}
+
+void OutlineManager::reset(){
+    slots.clear();
+    slotRefs.clear();
+    freeSlots.clear();
+    dirtyMarks.clear();
+    dirtySlots.clear();
+    sizeCounts.clear();
+
+    slots.push_back(SSBO{{0,0,0,0}, 0.0f, 0u, 0u});
+    slotRefs.push_back(1); // slot 0 is never handed out
+    dirtyMarks.push_back(0);
+    markDirty(0);
+}
+
+uint32_t OutlineManager::acquire(){
+    uint32_t slot;
+    if(freeSlots.empty()){
+        if(slots.size() >= MAX_OUTLINE_SLOTS){
+            return 0;
+        }
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back(SSBO{{0,0,0,0}, 0.0f, 0u, 0u});
+        slotRefs.push_back(0);
+        dirtyMarks.push_back(0);
+    } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    slotRefs[slot] = 1;
+    return slot;
+}
+
+void OutlineManager::retain(uint32_t slot){
+    assert(isLive(slot) && "retain called on a free outline slot");
+    slotRefs[slot]++;
+}
+
+void OutlineManager::release(uint32_t slot){
+    if(slot == 0 || !isLive(slot)){
+        return;
+    }
+    if(--slotRefs[slot] > 0){
+        return;
+    }
+    write(slot, SSBO{{0,0,0,0}, 0.0f, 0u, 0u});
+    freeSlots.push_back(slot);
+}
+
+bool OutlineManager::claim(uint32_t slot){
+    if(slot == 0 || slot >= MAX_OUTLINE_SLOTS){
+        return false;
+    }
+    if(slot >= slots.size()){
+        slots.resize(slot + 1, SSBO{{0,0,0,0}, 0.0f, 0u, 0u});
+        slotRefs.resize(slot + 1, 0);
+        dirtyMarks.resize(slot + 1, 0);
+    }
+    slotRefs[slot]++;
+    return true;
+}
+
+void OutlineManager::fillFreeSlots(){
+    freeSlots.clear();
+    for(uint32_t slot = static_cast<uint32_t>(slots.size()) - 1; slot > 0; slot--){
+        if(slotRefs[slot] == 0){
+            freeSlots.push_back(slot); // lowest on top, acquire keeps the table dense
+        }
+    }
+}
+
+void OutlineManager::write(uint32_t slot, const SSBO& data){
+    if(slot == 0 || slot >= slots.size()){
+        return;
+    }
+    trackSize(slots[slot], -1);
+    slots[slot] = data;
+    trackSize(slots[slot], 1);
+    markDirty(slot);
+}
+
+bool OutlineManager::isLive(uint32_t slot) const{
+    return slot != 0 && slot < slotRefs.size() && slotRefs[slot] > 0;
+}
+
+bool OutlineManager::isShared(uint32_t slot) const{
+    return isLive(slot) && slotRefs[slot] > 1;
+}
+
+float OutlineManager::getMaxOutlineSize() const{
+    if(sizeCounts.empty()){
+        return 0.0f;
+    }
+    return sizeCounts.rbegin()->first;
+}
+
+void OutlineManager::clearDirty(){
+    for(uint32_t slot : dirtySlots){
+        dirtyMarks[slot] = 0;
+    }
+    dirtySlots.clear();
+}
+
+void OutlineManager::markDirty(uint32_t slot){
+    if(dirtyMarks[slot]){
+        return;
+    }
+    dirtyMarks[slot] = 1;
+    dirtySlots.push_back(slot);
+}
+
+void OutlineManager::trackSize(const SSBO& data, int32_t delta){
+    if(!data.alive || data.outlineSize <= 0.0f){
+        return;
+    }
+    if(delta > 0){
+        sizeCounts[data.outlineSize]++;
+        return;
+    }
+    auto it = sizeCounts.find(data.outlineSize);
+    if(it == sizeCounts.end()){
+        return;
+    }
+    if(--it->second == 0){
+        sizeCounts.erase(it);
+    }
+}
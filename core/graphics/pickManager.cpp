@@ -0,0 +1,152 @@
+#include <ThING/graphics/pickManager.h>
+#include <ThING/graphics/bufferManager.h>
+#include <algorithm>
+
+inline constexpr float MAX_PICK_COORD = 65536.0f; // past any image size, keeps the float -> int conversion defined
+
+uint64_t PickManager::request(glm::vec2 min, glm::vec2 max){
+    std::lock_guard<std::mutex> lock(mutex);
+    if(pending.size() >= MAX_PENDING_PICKS){
+        return 0;
+    }
+    glm::vec2 lo = glm::clamp(glm::floor(glm::min(min, max) * scale), 0.0f, MAX_PICK_COORD);
+    glm::vec2 hi = glm::clamp(glm::ceil(glm::max(min, max) * scale), 0.0f, MAX_PICK_COORD);
+    hi = glm::max(hi, lo + 1.0f); // a point still covers its texel
+
+    PickRegion region;
+    region.offset = {static_cast<int32_t>(lo.x), static_cast<int32_t>(lo.y)};
+    region.extent = {static_cast<uint32_t>(hi.x - lo.x), static_cast<uint32_t>(hi.y - lo.y)};
+    const bool onScreen = extent.width == 0 || clampRegion(region); // no frame yet, frame() clamps it later
+    if(static_cast<uint64_t>(region.extent.width) * region.extent.height > MAX_PICK_TEXELS){
+        return 0;
+    }
+    region.ticket = nextTicket++;
+    if(!onScreen){
+        finish(region.ticket, {});
+        return region.ticket;
+    }
+    pending.push_back(region);
+    return region.ticket;
+}
+
+// Finished slots get decoded here too, so a result doesn't have to wait for the render thread to reuse the slot
+bool PickManager::read(uint64_t ticket, VkDevice device, VkSemaphore frameTimeline, const BufferManager& bufferManager, std::vector<Entity>& out){
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ready.find(ticket);
+    if(it == ready.end()){
+        uint64_t completed = 0;
+        vkGetSemaphoreCounterValue(device, frameTimeline, &completed);
+        for(uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+            const Slot& slot = slots[i];
+            if(slot.picks.count > 0 && slot.timelineValue != 0 && slot.timelineValue <= completed){
+                harvest(i, bufferManager);
+            }
+        }
+        it = ready.find(ticket);
+        if(it == ready.end()){
+            return false;
+        }
+    }
+    out = std::move(it->second);
+    ready.erase(it);
+    return true;
+}
+
+PickFrame PickManager::frame(uint32_t frameIndex, glm::vec2 framebufferScale, VkExtent2D imageExtent, const WorldData& worldData, const BufferManager& bufferManager){
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot& slot = slots[frameIndex];
+    if(slot.picks.count > 0){
+        if(slot.timelineValue == 0){
+            // The last frame on this slot never got submitted (swapchain out of date), ask again
+            for(uint32_t i = slot.picks.count; i-- > 0;){
+                pending.push_front(slot.picks.regions[i]);
+            }
+        } else {
+            harvest(frameIndex, bufferManager);
+        }
+    }
+    slot = {};
+    scale = framebufferScale;
+    extent = imageExtent;
+
+    uint32_t texels = 0;
+    while(!pending.empty() && slot.picks.count < MAX_PICKS_PER_FRAME){
+        PickRegion region = pending.front();
+        if(!clampRegion(region)){
+            pending.pop_front(); // the window shrank under it
+            finish(region.ticket, {});
+            continue;
+        }
+        const uint32_t size = region.extent.width * region.extent.height;
+        if(texels + size > MAX_PICK_TEXELS){
+            break;
+        }
+        pending.pop_front();
+        region.bufferOffset = texels;
+        texels += size;
+        slot.picks.regions[slot.picks.count++] = region;
+    }
+    slot.circleCount = static_cast<uint32_t>(worldData.circleInstances.size());
+    slot.polygonOffset = worldData.polygonOffset;
+    return slot.picks;
+}
+
+void PickManager::submitted(uint32_t frameIndex, uint64_t timelineValue){
+    std::lock_guard<std::mutex> lock(mutex);
+    if(slots[frameIndex].picks.count > 0){
+        slots[frameIndex].timelineValue = timelineValue;
+    }
+}
+
+bool PickManager::clampRegion(PickRegion& region) const{
+    const uint32_t x = static_cast<uint32_t>(region.offset.x);
+    const uint32_t y = static_cast<uint32_t>(region.offset.y);
+    if(x >= extent.width || y >= extent.height){
+        return false;
+    }
+    region.extent.width = std::min(region.extent.width, extent.width - x);
+    region.extent.height = std::min(region.extent.height, extent.height - y);
+    return true;
+}
+
+// Called with the lock held once the slot's frame finished. Pick ids are instance buffer indices + 1,
+// circles come first, then lines, then polygons
+void PickManager::harvest(uint32_t frameIndex, const BufferManager& bufferManager){
+    Slot& slot = slots[frameIndex];
+    const int32_t* texels = bufferManager.viewPickReadback(frameIndex);
+    for(uint32_t r = 0; r < slot.picks.count; r++){
+        const PickRegion& region = slot.picks.regions[r];
+        const uint32_t size = region.extent.width * region.extent.height;
+        std::vector<Entity> hits;
+        for(uint32_t t = region.bufferOffset; t < region.bufferOffset + size; t++){
+            const int32_t id = texels[t * 4 + 2];
+            if(id <= 0){
+                continue;
+            }
+            const uint32_t instance = static_cast<uint32_t>(id) - 1;
+            if(instance < slot.circleCount){
+                hits.push_back({instance, InstanceType::Circle});
+            } else if(instance < slot.polygonOffset){
+                hits.push_back({instance - slot.circleCount, InstanceType::Line});
+            } else {
+                hits.push_back({instance - slot.polygonOffset, InstanceType::Polygon});
+            }
+        }
+        std::sort(hits.begin(), hits.end(), [](const Entity& a, const Entity& b){
+            return a.type != b.type ? a.type < b.type : a.index < b.index;
+        });
+        hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+        finish(region.ticket, std::move(hits));
+    }
+    slot.picks.count = 0;
+}
+
+void PickManager::finish(uint64_t ticket, std::vector<Entity>&& hits){
+    ready[ticket] = std::move(hits);
+    readyOrder.push_back(ticket);
+    // Nobody came for these, drop the oldest
+    while(readyOrder.size() > MAX_READY_PICKS){
+        ready.erase(readyOrder.front());
+        readyOrder.pop_front();
+    }
+}
@@ -15,12 +15,14 @@ void PipelineManager::init(VkDevice device, const VkFormat &format) {
     createPostRenderPass(format);
     createImGuiRenderPass(format);
     createIdSampler();
+    createAtlasSampler();
 }
 
 PipelineManager::PipelineManager(){
     device = VK_NULL_HANDLE;
     descriptorPool = VK_NULL_HANDLE;
     idSampler = VK_NULL_HANDLE;
+    atlasSampler = VK_NULL_HANDLE;
 }
 
 PipelineManager::~PipelineManager(){
@@ -50,6 +52,10 @@ void PipelineManager::cleanUp(){
         vkDestroySampler(device, idSampler, nullptr);
         idSampler = VK_NULL_HANDLE;
     }
+    if (atlasSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, atlasSampler, nullptr);
+        atlasSampler = VK_NULL_HANDLE;
+    }
     for (size_t i = 0; i < toIndex(PipelineType::Count); i++) {
         vkDestroyDescriptorSetLayout(device, descriptorSetLayouts[i], nullptr);
     }
@@ -131,6 +137,30 @@ void PipelineManager::createDescriptorSets(BufferManager& bufferManager, SwapCha
             createJFADescriptorSets(swapChainManager);
             continue;
         }
+        if(static_cast<PipelineType>(i) == PipelineType::Physics){
+            createPhysicsDescriptorSets(bufferManager);
+            continue;
+        }
+        if(static_cast<PipelineType>(i) == PipelineType::Layout){
+            createLayoutDescriptorSets(bufferManager);
+            continue;
+        }
+        if(static_cast<PipelineType>(i) == PipelineType::Splat){
+            createSplatDescriptorSets(bufferManager);
+            continue;
+        }
+        if(static_cast<PipelineType>(i) == PipelineType::Heatmap){
+            createHeatmapDescriptorSets(bufferManager);
+            continue;
+        }
+        if(static_cast<PipelineType>(i) == PipelineType::HeatmapGrid){
+            createHeatmapGridDescriptorSets(bufferManager);
+            continue;
+        }
+        if(static_cast<PipelineType>(i) == PipelineType::Text){
+            createTextDescriptorSets(bufferManager);
+            continue;
+        }
         createDescriptorSet(bufferManager, swapChainManager, static_cast<PipelineType>(i));
     }
 }
@@ -205,8 +235,274 @@ void PipelineManager::createJFADescriptorSets(SwapChainManager& swapChainManager
 
 
 
+// The physics buffers never get recreated, so unlike the other sets these are written once here
+void PipelineManager::createPhysicsDescriptorSets(BufferManager& bufferManager) {
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayouts[toIndex(PipelineType::Physics)]);
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = descriptorPool;
+    alloc.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    alloc.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc, physicsDescriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate physics descriptor sets");
+    }
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        const std::array<VkDescriptorBufferInfo, 4> infos = {{
+            {bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::PhysicsBodies, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::PhysicsGrid, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::Instance, i).buffer, 0, VK_WHOLE_SIZE}
+        }};
+
+        std::array<VkWriteDescriptorSet, 4> writes{};
+        for (size_t b = 0; b < writes.size(); b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = physicsDescriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &infos[b];
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void PipelineManager::createLayoutDescriptorSets(BufferManager& bufferManager) {
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayouts[toIndex(PipelineType::Layout)]);
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = descriptorPool;
+    alloc.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    alloc.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc, layoutDescriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate layout descriptor sets");
+    }
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        const std::array<VkDescriptorBufferInfo, 6> infos = {{
+            {bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::PhysicsBodies, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::Instance, i).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::LayoutAdjacency, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::LayoutAccum, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::LayoutTree, 0).buffer, 0, VK_WHOLE_SIZE}
+        }};
+
+        std::array<VkWriteDescriptorSet, 6> writes{};
+        for (size_t b = 0; b < writes.size(); b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = layoutDescriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &infos[b];
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void PipelineManager::createSplatDescriptorSets(BufferManager& bufferManager) {
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayouts[toIndex(PipelineType::Splat)]);
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = descriptorPool;
+    alloc.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    alloc.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc, splatDescriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate splat descriptor sets");
+    }
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        const std::array<VkDescriptorBufferInfo, 4> infos = {{
+            {bufferManager.viewBuffer(BufferType::Uniform, i).buffer, 0, sizeof(UniformBufferObject)},
+            {bufferManager.viewBuffer(BufferType::Instance, i).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::Splat, 0).buffer, 0, VK_WHOLE_SIZE}
+        }};
+
+        std::array<VkWriteDescriptorSet, 4> writes{};
+        for (size_t b = 0; b < writes.size(); b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = splatDescriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = (b == 0) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &infos[b];
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+// The splat buffer grows with the window, the rest of the set never changes
+void PipelineManager::updateSplatDescriptorSet(uint32_t currentFrame, BufferManager& bufferManager) {
+    VkDescriptorBufferInfo splatInfo{};
+    splatInfo.buffer = bufferManager.viewBuffer(BufferType::Splat, 0).buffer;
+    splatInfo.offset = 0;
+    splatInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = splatDescriptorSets[currentFrame];
+    write.dstBinding = 3;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &splatInfo;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+// Lives with the other graphics sets so commandBindPipeline works, but its uniform is the heatmap one
+void PipelineManager::createHeatmapDescriptorSets(BufferManager& bufferManager) {
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayouts[toIndex(PipelineType::Heatmap)]);
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = descriptorPool;
+    alloc.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    alloc.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc, graphicsDescriptorSets[toIndex(PipelineType::Heatmap)].data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate heatmap descriptor sets");
+    }
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        const std::array<VkDescriptorBufferInfo, 2> infos = {{
+            {bufferManager.viewBuffer(BufferType::HeatmapUniform, i).buffer, 0, sizeof(HeatmapUniform)},
+            {bufferManager.viewBuffer(BufferType::HeatmapGrid, 0).buffer, 0, VK_WHOLE_SIZE}
+        }};
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (size_t b = 0; b < writes.size(); b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = graphicsDescriptorSets[toIndex(PipelineType::Heatmap)][i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = (b == 0) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &infos[b];
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void PipelineManager::createHeatmapGridDescriptorSets(BufferManager& bufferManager) {
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayouts[toIndex(PipelineType::HeatmapGrid)]);
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = descriptorPool;
+    alloc.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    alloc.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc, heatmapGridDescriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate heatmap grid descriptor sets");
+    }
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        const std::array<VkDescriptorBufferInfo, 5> infos = {{
+            {bufferManager.viewBuffer(BufferType::Uniform, i).buffer, 0, sizeof(UniformBufferObject)},
+            {bufferManager.viewBuffer(BufferType::Instance, i).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::HeatmapGrid, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::HeatmapUniform, i).buffer, 0, sizeof(HeatmapUniform)}
+        }};
+
+        std::array<VkWriteDescriptorSet, 5> writes{};
+        for (size_t b = 0; b < writes.size(); b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = heatmapGridDescriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = (b == 0 || b == 4) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &infos[b];
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+// Only the grid can be recreated, when the window grows
+void PipelineManager::updateHeatmapDescriptorSets(uint32_t currentFrame, BufferManager& bufferManager) {
+    VkDescriptorBufferInfo gridInfo{};
+    gridInfo.buffer = bufferManager.viewBuffer(BufferType::HeatmapGrid, 0).buffer;
+    gridInfo.offset = 0;
+    gridInfo.range = VK_WHOLE_SIZE;
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[0].dstSet = graphicsDescriptorSets[toIndex(PipelineType::Heatmap)][currentFrame];
+    writes[0].dstBinding = 1;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[0].pBufferInfo = &gridInfo;
+
+    writes[1] = writes[0];
+    writes[1].dstSet = heatmapGridDescriptorSets[currentFrame];
+    writes[1].dstBinding = 3;
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+// Every binding is a per frame buffer or the atlas, none of them is recreated on resize so they are written once
+void PipelineManager::createTextDescriptorSets(BufferManager& bufferManager) {
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayouts[toIndex(PipelineType::Text)]);
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = descriptorPool;
+    alloc.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    alloc.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc, graphicsDescriptorSets[toIndex(PipelineType::Text)].data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate text descriptor sets");
+    }
+
+    VkDescriptorImageInfo atlasInfo{};
+    atlasInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    atlasInfo.imageView = bufferManager.viewGlyphAtlas().view;
+    atlasInfo.sampler = atlasSampler;
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        const std::array<VkDescriptorBufferInfo, 5> infos = {{
+            {bufferManager.viewBuffer(BufferType::Uniform, i).buffer, 0, sizeof(UniformBufferObject)},
+            {bufferManager.viewBuffer(BufferType::Text, i).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::Instance, i).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer, 0, VK_WHOLE_SIZE},
+            {bufferManager.viewBuffer(BufferType::Tween, i).buffer, 0, VK_WHOLE_SIZE}
+        }};
+
+        std::array<VkWriteDescriptorSet, 6> writes{};
+        for (size_t b = 0; b < writes.size(); b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = graphicsDescriptorSets[toIndex(PipelineType::Text)][i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            if (b == infos.size()) {
+                writes[b].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                writes[b].pImageInfo = &atlasInfo;
+            } else {
+                writes[b].descriptorType = (b == 0) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[b].pBufferInfo = &infos[b];
+            }
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
 void PipelineManager::createDescriptorSet(BufferManager& bufferManager, SwapChainManager& swapChainManager, PipelineType type){
-    if (type == PipelineType::JFA){
+    if (type == PipelineType::JFA || type == PipelineType::Physics || type == PipelineType::Layout || type == PipelineType::Splat || 
+        type == PipelineType::Heatmap || type == PipelineType::HeatmapGrid || type == PipelineType::Text){
         return;
     }
 
@@ -233,6 +529,26 @@ void PipelineManager::createDescriptorSet(BufferManager& bufferManager, SwapChai
         ssboBufferInfo.offset = 0;
         ssboBufferInfo.range = VK_WHOLE_SIZE;
 
+        VkDescriptorBufferInfo positionsBufferInfo{};
+        positionsBufferInfo.buffer = bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer;
+        positionsBufferInfo.offset = 0;
+        positionsBufferInfo.range = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo tweenBufferInfo{};
+        tweenBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Tween, i).buffer;
+        tweenBufferInfo.offset = 0;
+        tweenBufferInfo.range = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo splatBufferInfo{};
+        splatBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Splat, 0).buffer;
+        splatBufferInfo.offset = 0;
+        splatBufferInfo.range = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo instanceBufferInfo{};
+        instanceBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Instance, i).buffer;
+        instanceBufferInfo.offset = 0;
+        instanceBufferInfo.range = VK_WHOLE_SIZE;
+
         VkDescriptorImageInfo idImageInfo{};
         idImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
         idImageInfo.imageView = swapChainManager.viewIdImages().view;
@@ -273,7 +589,15 @@ void PipelineManager::createDescriptorSet(BufferManager& bufferManager, SwapChai
                     break;
                 case DescriptorType::StorageBuffer:
                     writes.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                    writes.pBufferInfo = &ssboBufferInfo;
+                    if(type == PipelineType::SplatResolve){
+                        writes.pBufferInfo = (binding.binding == 1) ? &splatBufferInfo : &instanceBufferInfo;
+                    } else if(type == PipelineType::Edge){
+                        writes.pBufferInfo = (binding.binding == 1) ? &instanceBufferInfo : (binding.binding == 2) ? &positionsBufferInfo : &tweenBufferInfo;
+                    } else if(type == PipelineType::Base){
+                        writes.pBufferInfo = (binding.binding == 3) ? &positionsBufferInfo : &tweenBufferInfo;
+                    } else {
+                        writes.pBufferInfo = &ssboBufferInfo;
+                    }
                     break;
                 case DescriptorType::Count: std::unreachable();
                 default: std::unreachable(); 
@@ -314,6 +638,25 @@ void PipelineManager::createIdSampler() {
     }
 }
 
+void PipelineManager::createAtlasSampler() {
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &atlasSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create atlas sampler!");
+    }
+}
+
 void PipelineManager::createDescriptorSetLayouts(){
     for(size_t i = 0; i < toIndex(PipelineType::Count); i++){
         createDescriptorSetLayout(static_cast<PipelineType>(i));
@@ -324,7 +667,15 @@ void PipelineManager::createPipelines(){
     createDescriptorSetLayouts();
     createBaseGraphicsPipeline();
     createJFAPipeline();
+    createPhysicsPipeline();
+    createLayoutPipeline();
+    createSplatPipeline();
     createPostGraphicsPipeline();
+    createSplatResolvePipeline();
+    createHeatmapPipeline();
+    createHeatmapGridPipeline();
+    createEdgePipeline();
+    createTextPipeline();
 }
 
 void PipelineManager::createBaseRenderPass(const VkFormat& swapChainImageFormat) {
@@ -343,7 +694,7 @@ void PipelineManager::createBaseRenderPass(const VkFormat& swapChainImageFormat)
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     VkAttachmentDescription idAttachment{};
-    idAttachment.format = VK_FORMAT_R32G32_SINT;
+    idAttachment.format = ID_IMAGE_FORMAT;
     idAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     idAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     idAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
@@ -506,10 +857,17 @@ void PipelineManager::updateDescriptorSets(uint32_t currentFrame, BufferManager&
     //     updateJFADescriptorSet(currentFrame, swapChainManager); // Use this if more Compute shaders are added
     // }
     updateJFADescriptorSet(currentFrame, swapChainManager);
-
+    updateSplatDescriptorSet(currentFrame, bufferManager);
+    updateHeatmapDescriptorSets(currentFrame, bufferManager);
 }
 
 void PipelineManager::updateDescriptorSet(uint32_t currentFrame, BufferManager& bufferManager, SwapChainManager& swapChainManager, uint32_t imageIndex, PipelineType type) {
+    if (type == PipelineType::Heatmap) {
+        return; // updateHeatmapDescriptorSets
+    }
+    if (type == PipelineType::Text) {
+        return; // written once in createTextDescriptorSets
+    }
     VkDescriptorBufferInfo uniformBufferInfo{};
     uniformBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Uniform, currentFrame).buffer;
     uniformBufferInfo.offset = 0;
@@ -520,6 +878,26 @@ void PipelineManager::updateDescriptorSet(uint32_t currentFrame, BufferManager&
     ssboBufferInfo.offset = 0;
     ssboBufferInfo.range = VK_WHOLE_SIZE;
 
+    VkDescriptorBufferInfo positionsBufferInfo{};
+    positionsBufferInfo.buffer = bufferManager.viewBuffer(BufferType::PhysicsPositions, 0).buffer;
+    positionsBufferInfo.offset = 0;
+    positionsBufferInfo.range = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo tweenBufferInfo{};
+    tweenBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Tween, currentFrame).buffer;
+    tweenBufferInfo.offset = 0;
+    tweenBufferInfo.range = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo splatBufferInfo{};
+    splatBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Splat, 0).buffer;
+    splatBufferInfo.offset = 0;
+    splatBufferInfo.range = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo instanceBufferInfo{};
+    instanceBufferInfo.buffer = bufferManager.viewBuffer(BufferType::Instance, currentFrame).buffer;
+    instanceBufferInfo.offset = 0;
+    instanceBufferInfo.range = VK_WHOLE_SIZE;
+
     VkDescriptorImageInfo imageInfo{};
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
     imageInfo.imageView = swapChainManager.viewIdImages().view;
@@ -559,7 +937,15 @@ void PipelineManager::updateDescriptorSet(uint32_t currentFrame, BufferManager&
                 break;
             case DescriptorType::StorageBuffer:
                 write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                write.pBufferInfo = &ssboBufferInfo;
+                if (type == PipelineType::SplatResolve) {
+                    write.pBufferInfo = (binding.binding == 1) ? &splatBufferInfo : &instanceBufferInfo;
+                } else if (type == PipelineType::Edge) {
+                    write.pBufferInfo = (binding.binding == 1) ? &instanceBufferInfo : (binding.binding == 2) ? &positionsBufferInfo : &tweenBufferInfo;
+                } else if (type == PipelineType::Base) {
+                    write.pBufferInfo = (binding.binding == 3) ? &positionsBufferInfo : &tweenBufferInfo;
+                } else {
+                    write.pBufferInfo = &ssboBufferInfo;
+                }
                 break;
             case DescriptorType::Count:
             default:
@@ -76,7 +76,7 @@ void PipelineManager::createBaseGraphicsPipeline(){
     basicMultisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
     VkPipelineColorBlendAttachmentState idColorBlendAttachment{};
-    idColorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+    idColorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_B_BIT; // objectID, pick id
     idColorBlendAttachment.blendEnable = VK_FALSE;
 
     VkPipelineColorBlendAttachmentState seedColorBlendAttachment{};
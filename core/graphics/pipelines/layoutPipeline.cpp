@@ -0,0 +1,49 @@
+#include "layoutComp_spv.h"
+#include "ThING/types/enums.h"
+#include "ThING/types/gpuPhysics.h"
+#include <ThING/graphics/pipelineManager.h>
+
+void PipelineManager::createLayoutPipeline() {
+    VkShaderModule compShaderModule = createShaderModule(ThING::shaders::layoutCompSpv);
+
+    VkPipelineShaderStageCreateInfo shaderStage{};
+    shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    shaderStage.module = compShaderModule;
+    shaderStage.pName = "main";
+
+    VkPushConstantRange pc{};
+    pc.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pc.offset = 0;
+    pc.size = sizeof(LayoutPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &descriptorSetLayouts[toIndex(PipelineType::Layout)];
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pc;
+
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayouts[toIndex(PipelineType::Layout)])
+        != VK_SUCCESS){
+        throw std::runtime_error("failed to create layout pipeline layout");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = shaderStage;
+    pipelineInfo.layout = pipelineLayouts[toIndex(PipelineType::Layout)];
+
+    if (vkCreateComputePipelines(
+            device,
+            VK_NULL_HANDLE,
+            1,
+            &pipelineInfo,
+            nullptr,
+            &pipelines[toIndex(PipelineType::Layout)]
+        ) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create layout compute pipeline");
+    }
+
+    vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
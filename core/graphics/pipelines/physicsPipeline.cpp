@@ -0,0 +1,49 @@
+#include "physicsComp_spv.h"
+#include "ThING/types/enums.h"
+#include "ThING/types/gpuPhysics.h"
+#include <ThING/graphics/pipelineManager.h>
+
+void PipelineManager::createPhysicsPipeline() {
+    VkShaderModule compShaderModule = createShaderModule(ThING::shaders::physicsCompSpv);
+
+    VkPipelineShaderStageCreateInfo shaderStage{};
+    shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    shaderStage.module = compShaderModule;
+    shaderStage.pName = "main";
+
+    VkPushConstantRange pc{};
+    pc.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pc.offset = 0;
+    pc.size = sizeof(PhysicsPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &descriptorSetLayouts[toIndex(PipelineType::Physics)];
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pc;
+
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayouts[toIndex(PipelineType::Physics)])
+        != VK_SUCCESS){
+        throw std::runtime_error("failed to create physics pipeline layout");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = shaderStage;
+    pipelineInfo.layout = pipelineLayouts[toIndex(PipelineType::Physics)];
+
+    if (vkCreateComputePipelines(
+            device,
+            VK_NULL_HANDLE,
+            1,
+            &pipelineInfo,
+            nullptr,
+            &pipelines[toIndex(PipelineType::Physics)]
+        ) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create physics compute pipeline");
+    }
+
+    vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
@@ -0,0 +1,49 @@
+#include "splatComp_spv.h"
+#include "ThING/types/enums.h"
+#include "ThING/types/splat.h"
+#include <ThING/graphics/pipelineManager.h>
+
+void PipelineManager::createSplatPipeline() {
+    VkShaderModule compShaderModule = createShaderModule(ThING::shaders::splatCompSpv);
+
+    VkPipelineShaderStageCreateInfo shaderStage{};
+    shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    shaderStage.module = compShaderModule;
+    shaderStage.pName = "main";
+
+    VkPushConstantRange pc{};
+    pc.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pc.offset = 0;
+    pc.size = sizeof(SplatPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &descriptorSetLayouts[toIndex(PipelineType::Splat)];
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pc;
+
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayouts[toIndex(PipelineType::Splat)])
+        != VK_SUCCESS){
+        throw std::runtime_error("failed to create splat pipeline layout");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = shaderStage;
+    pipelineInfo.layout = pipelineLayouts[toIndex(PipelineType::Splat)];
+
+    if (vkCreateComputePipelines(
+            device,
+            VK_NULL_HANDLE,
+            1,
+            &pipelineInfo,
+            nullptr,
+            &pipelines[toIndex(PipelineType::Splat)]
+        ) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create splat compute pipeline");
+    }
+
+    vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
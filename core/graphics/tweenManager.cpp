@@ -0,0 +1,123 @@
+#include "ThING/consts.h"
+#include <ThING/graphics/tweenManager.h>
+#include <algorithm>
+#include <functional>
+
+TweenManager::TweenManager() : epoch(std::chrono::steady_clock::now()){
+    reset();
+}
+
+void TweenManager::reset(){
+    slots.clear();
+    owners.clear();
+    ends.clear();
+    live.clear();
+    freeSlots.clear();
+    expiries.clear();
+    expired.clear();
+    dirtyMarks.clear();
+    dirtySlots.clear();
+
+    slots.push_back({});
+    owners.push_back(INVALID_ENTITY);
+    ends.push_back(0.0f);
+    live.push_back(0); // slot 0 is never handed out
+    dirtyMarks.push_back(0);
+    markDirty(0);
+}
+
+float TweenManager::now() const{
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+uint32_t TweenManager::start(uint32_t slot, Entity owner, TweenProperty property, glm::vec4 current, glm::vec4 target, float duration, Easing easing){
+    const float time = now();
+    if(!isLive(slot)){
+        if(freeSlots.empty()){
+            if(slots.size() >= MAX_TWEENS){
+                return 0;
+            }
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({});
+            owners.push_back(owner);
+            ends.push_back(0.0f);
+            live.push_back(0);
+            dirtyMarks.push_back(0);
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        slots[slot] = {};
+        owners[slot] = owner;
+        ends[slot] = 0.0f;
+        live[slot] = 1;
+    }
+
+    TweenTrack& track = slots[slot].tracks[toIndex(property)];
+    if(track.duration > 0.0f && time < track.start + track.duration){
+        current = sampleTrack(track, time); // retargeted halfway, no jump back to the old value
+    }
+    track = {current, target, time, duration, static_cast<uint32_t>(easing), 0u};
+
+    const float end = time + duration;
+    if(end > ends[slot]){
+        ends[slot] = end;
+        expiries.emplace_back(end, slot);
+        std::push_heap(expiries.begin(), expiries.end(), std::greater<>());
+    }
+    markDirty(slot);
+    return slot;
+}
+
+void TweenManager::stop(uint32_t slot, TweenProperty property){
+    if(!isLive(slot)){
+        return;
+    }
+    slots[slot].tracks[toIndex(property)].duration = 0.0f;
+    markDirty(slot); // the slot itself goes back once its other tracks are done too
+}
+
+void TweenManager::release(uint32_t slot){
+    if(!isLive(slot)){
+        return;
+    }
+    slots[slot] = {};
+    owners[slot] = INVALID_ENTITY;
+    live[slot] = 0;
+    freeSlots.push_back(slot);
+    markDirty(slot);
+}
+
+std::span<const Entity> TweenManager::expire(){
+    expired.clear();
+    const float time = now();
+    while(!expiries.empty() && expiries.front().first <= time){
+        const uint32_t slot = expiries.front().second;
+        std::pop_heap(expiries.begin(), expiries.end(), std::greater<>());
+        expiries.pop_back();
+        if(isLive(slot) && ends[slot] <= time){
+            expired.push_back(owners[slot]);
+            release(slot);
+        }
+    }
+    return expired;
+}
+
+bool TweenManager::isLive(uint32_t slot) const{
+    return slot != 0 && slot < live.size() && live[slot];
+}
+
+void TweenManager::clearDirty(){
+    for(uint32_t slot : dirtySlots){
+        dirtyMarks[slot] = 0;
+    }
+    dirtySlots.clear();
+}
+
+void TweenManager::markDirty(uint32_t slot){
+    if(dirtyMarks[slot]){
+        return;
+    }
+    dirtyMarks[slot] = 1;
+    dirtySlots.push_back(slot);
+}
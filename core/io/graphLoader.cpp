@@ -0,0 +1,268 @@
+#include "ThING/consts.h"
+#include <ThING/io/graphLoader.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+inline constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+static bool isSeparator(char c){
+    return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+template <typename T>
+static bool field(const char*& p, const char* end, T& out){
+    while(p < end && isSeparator(*p)){
+        p++;
+    }
+    const auto [next, error] = std::from_chars(p, end, out);
+    if(error != std::errc()){
+        return false;
+    }
+    p = next;
+    return true;
+}
+
+// Index right after the line break at or after pos
+static size_t lineEnd(std::span<const char> text, size_t pos){
+    if(pos >= text.size()){
+        return text.size();
+    }
+    const void* found = std::memchr(text.data() + pos, '\n', text.size() - pos);
+    return found ? static_cast<size_t>(static_cast<const char*>(found) - text.data()) + 1 : text.size();
+}
+
+// Calls row(begin, end) for every line with something on it, the line break isn't part of it
+template <typename RowFn>
+static void forEachLine(const char* p, const char* end, RowFn&& row){
+    while(p < end){
+        const void* found = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        const char* next = found ? static_cast<const char*>(found) : end;
+        const char* first = p;
+        while(first < next && isSeparator(*first)){
+            first++;
+        }
+        if(first < next){
+            row(first, next);
+        }
+        p = next + 1;
+    }
+}
+
+bool GraphLoader::start(const std::string& nodesPath, const std::string& edgesPath, const GraphLoadSettings& loadSettings){
+    cancel();
+    if((!nodesPath.empty() && !nodesFile.open(nodesPath)) || (!edgesPath.empty() && !edgesFile.open(edgesPath))){
+        nodesFile.close();
+        edgesFile.close();
+        return false;
+    }
+    settings = loadSettings;
+    if(!jobs){
+        jobs = std::make_unique<JobSystem>();
+    }
+    bytesTotal = nodesFile.view().size() + edgesFile.view().size();
+    bytesParsed = 0;
+    skippedRows = 0;
+    nodesTaken = 0;
+    edgesTaken = 0;
+    truncated = false;
+    nodeCount = 0;
+    cancelled = false;
+    driverRunning = true;
+    driver = std::thread(&GraphLoader::run, this);
+    return true;
+}
+
+void GraphLoader::cancel(){
+    cancelled = true;
+    batchCondition.notify_all();
+    if(driver.joinable()){
+        driver.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        ready.clear();
+    }
+    driverRunning = false;
+    slices = {};
+    denseIds = {};
+    sparseIds = {};
+    nodesFile.close();
+    edgesFile.close();
+}
+
+void GraphLoader::truncate(uint64_t droppedNodes, uint64_t droppedEdges){
+    cancel();
+    std::lock_guard<std::mutex> lock(batchMutex);
+    nodesTaken -= droppedNodes;
+    edgesTaken -= droppedEdges;
+    truncated = true;
+}
+
+bool GraphLoader::takeBatch(Batch& out){
+    {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        if(ready.empty()){
+            return false;
+        }
+        out = std::move(ready.front());
+        ready.pop_front();
+        nodesTaken += out.nodes.size();
+        edgesTaken += out.edges.size();
+    }
+    batchCondition.notify_all(); // the driver can be waiting for room
+    return true;
+}
+
+GraphLoadProgress GraphLoader::getProgress() const{
+    std::lock_guard<std::mutex> lock(batchMutex);
+    GraphLoadProgress progress;
+    progress.bytesParsed = bytesParsed.load(std::memory_order_relaxed);
+    progress.bytesTotal = bytesTotal;
+    progress.nodes = nodesTaken;
+    progress.edges = edgesTaken;
+    progress.skippedRows = skippedRows.load(std::memory_order_relaxed);
+    progress.running = driverRunning || !ready.empty();
+    progress.truncated = truncated;
+    return progress;
+}
+
+void GraphLoader::run(){
+    const std::span<const std::byte> nodes = nodesFile.view();
+    const std::span<const std::byte> edges = edgesFile.view();
+
+    parseBlocks({reinterpret_cast<const char*>(nodes.data()), nodes.size()}, [](const char* begin, const char* end, Slice& slice){
+        forEachLine(begin, end, [&slice](const char* p, const char* line){
+            NodeRow row{0, {{0.0f, 0.0f}, 0.0f}, false};
+            if(!field(p, line, row.id)){
+                slice.skipped++; // header or comment
+                return;
+            }
+            if(field(p, line, row.node.position.x) && field(p, line, row.node.position.y)){
+                row.positioned = true;
+                field(p, line, row.node.size);
+            }
+            slice.nodes.push_back(row);
+        });
+    }, false);
+
+    parseBlocks({reinterpret_cast<const char*>(edges.data()), edges.size()}, [](const char* begin, const char* end, Slice& slice){
+        forEachLine(begin, end, [&slice](const char* p, const char* line){
+            uint64_t from;
+            uint64_t to;
+            if(!field(p, line, from) || !field(p, line, to)){
+                slice.skipped++;
+                return;
+            }
+            slice.edges.emplace_back(from, to);
+        });
+    }, true);
+
+    {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        driverRunning = false;
+    }
+}
+
+template <typename ParseFn>
+void GraphLoader::parseBlocks(std::span<const char> text, ParseFn&& parse, bool edgeFile){
+    std::vector<size_t> bounds;
+    size_t blockBegin = 0;
+    while(blockBegin < text.size() && !cancelled){
+        const size_t blockEnd = lineEnd(text, blockBegin + GRAPH_BLOCK_BYTES);
+        bounds.assign(1, blockBegin);
+        while(bounds.back() < blockEnd){
+            bounds.push_back(std::min(lineEnd(text, bounds.back() + GRAPH_SLICE_BYTES), blockEnd));
+        }
+        const size_t sliceCount = bounds.size() - 1;
+        if(slices.size() < sliceCount){
+            slices.resize(sliceCount);
+        }
+        jobs->parallelForRange(sliceCount, 1, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; i++){
+                Slice& slice = slices[i];
+                slice.nodes.clear();
+                slice.edges.clear();
+                slice.skipped = 0;
+                parse(text.data() + bounds[i], text.data() + bounds[i + 1], slice);
+            }
+        });
+
+        // Numbering stays on this thread and in file order, the same file always gives the same scene
+        Batch batch;
+        uint64_t skipped = 0;
+        for(size_t i = 0; i < sliceCount; i++){
+            const Slice& slice = slices[i];
+            skipped += slice.skipped;
+            bool created;
+            if(edgeFile){
+                batch.edges.reserve(batch.edges.size() + slice.edges.size());
+                for(const auto& [from, to] : slice.edges){
+                    const uint32_t a = number(from, batch, created);
+                    const uint32_t b = number(to, batch, created);
+                    batch.edges.emplace_back(a, b);
+                }
+                continue;
+            }
+            for(const NodeRow& row : slice.nodes){
+                number(row.id, batch, created);
+                if(!created){
+                    skipped++; // same id twice, the first row wins
+                    continue;
+                }
+                Node& node = batch.nodes.back();
+                if(row.positioned){
+                    node.position = row.node.position;
+                }
+                if(row.node.size > 0.0f){
+                    node.size = row.node.size;
+                }
+            }
+        }
+        skippedRows += skipped;
+        bytesParsed += blockEnd - blockBegin;
+        if(!push(std::move(batch))){
+            return;
+        }
+        blockBegin = blockEnd;
+    }
+}
+
+uint32_t GraphLoader::number(uint64_t id, Batch& batch, bool& created){
+    uint32_t* slot;
+    if(id < GRAPH_DENSE_IDS){
+        if(id >= denseIds.size()){
+            denseIds.resize(std::min<uint64_t>(std::max<uint64_t>(id + 1, denseIds.size() * 2), GRAPH_DENSE_IDS), NO_NODE);
+        }
+        slot = &denseIds[id];
+    } else {
+        slot = &sparseIds.try_emplace(id, NO_NODE).first->second;
+    }
+    created = *slot == NO_NODE;
+    if(created){
+        *slot = nodeCount++;
+        batch.nodes.push_back({scatter(*slot), settings.nodeSize});
+    }
+    return *slot;
+}
+
+// Same spot for the same node every load, no shared rng between the threads
+glm::vec2 GraphLoader::scatter(uint32_t node) const{
+    uint64_t z = node + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    const glm::vec2 unit = glm::vec2(static_cast<float>(z & 0xFFFFFF), static_cast<float>((z >> 32) & 0xFFFFFF)) / float(0x1000000);
+    return settings.center + (unit - 0.5f) * settings.spread;
+}
+
+bool GraphLoader::push(Batch&& batch){
+    std::unique_lock<std::mutex> lock(batchMutex);
+    batchCondition.wait(lock, [this]{return ready.size() < GRAPH_MAX_READY_BATCHES || cancelled;});
+    if(cancelled){
+        return false;
+    }
+    ready.push_back(std::move(batch));
+    return true;
+}
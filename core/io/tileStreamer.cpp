@@ -0,0 +1,265 @@
+#include "ThING/consts.h"
+#include <ThING/io/tileStreamer.h>
+#include <algorithm>
+#include <cmath>
+
+bool TileStreamer::open(const std::string& path){
+    close();
+    file.open(path, std::ios::binary | std::ios::ate);
+    if(!file){
+        return false;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    auto fail = [this]{
+        file.close();
+        directory.clear();
+        return false;
+    };
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != TILE_PYRAMID_MAGIC ||
+        header.version != TILE_PYRAMID_VERSION || header.levels == 0 || header.levels > TILE_MAX_LEVELS || !(header.size > 0.0f)){
+        return fail();
+    }
+    if(header.directoryOffset > fileSize || header.tileCount > (fileSize - header.directoryOffset) / sizeof(TileEntry)){
+        return fail();
+    }
+    directory.resize(header.tileCount);
+    file.seekg(static_cast<std::streamoff>(header.directoryOffset));
+    if(!file.read(reinterpret_cast<char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(TileEntry)))){
+        return fail();
+    }
+    for(const TileEntry& entry : directory){
+        if(entry.offset > fileSize || entry.count > (fileSize - entry.offset) / sizeof(TilePoint) || tileLevel(entry.key) >= header.levels){
+            return fail(); // cut short, a tile would read past the end
+        }
+    }
+    if(!std::is_sorted(directory.begin(), directory.end(), [](const TileEntry& a, const TileEntry& b){return a.key < b.key;})){
+        return fail();
+    }
+
+    if(find(tileKey(0, 0, 0))){
+        requests.push_back(tileKey(0, 0, 0)); // the root stands in for everything, load it before anything asks
+    }
+    stopping = false;
+    ioThread = std::thread(&TileStreamer::ioLoop, this);
+    return true;
+}
+
+void TileStreamer::close(){
+    if(ioThread.joinable()){
+        {
+            std::lock_guard<std::mutex> lock(ioMutex);
+            stopping = true;
+        }
+        ioCondition.notify_all();
+        ioThread.join();
+    }
+    file.close();
+    directory.clear();
+    requests.clear();
+    loaded.clear();
+    reading = UINT64_MAX;
+    cache.clear();
+    lru.clear();
+    cacheBytes = 0;
+    visibleKeys.clear();
+    visible.clear();
+    visiblePoints = 0;
+    level = 0;
+}
+
+const TileEntry* TileStreamer::find(uint64_t key) const{
+    const auto it = std::lower_bound(directory.begin(), directory.end(), key, [](const TileEntry& entry, uint64_t k){return entry.key < k;});
+    return it != directory.end() && it->key == key ? &*it : nullptr;
+}
+
+// Tiles of a level the view touches, as an inclusive range. False when the view misses the pyramid
+static bool tileRange(const TilePyramidHeader& header, uint32_t level, glm::vec2 viewMin, glm::vec2 viewMax, glm::ivec2& first, glm::ivec2& last){
+    const float tileSize = header.size / static_cast<float>(1u << level);
+    const glm::vec2 low = (viewMin - header.origin) / tileSize;
+    const glm::vec2 high = (viewMax - header.origin) / tileSize;
+    const int tiles = static_cast<int>(1u << level);
+    if(high.x < 0.0f || high.y < 0.0f || low.x >= tiles || low.y >= tiles){
+        return false;
+    }
+    first = glm::clamp(glm::ivec2(glm::floor(low)), 0, tiles - 1);
+    last = glm::clamp(glm::ivec2(glm::floor(high)), 0, tiles - 1);
+    return true;
+}
+
+uint32_t TileStreamer::chooseLevel(glm::vec2 viewMin, glm::vec2 viewMax, float zoom) const{
+    const float across = header.size * zoom / (TILE_GRID * TILE_POINT_PIXELS); // level 0 tiles that would fit
+    uint32_t wanted = across <= 1.0f ? 0 : static_cast<uint32_t>(std::ceil(std::log2(across)));
+    wanted = std::min(wanted, header.levels - 1);
+    glm::ivec2 first;
+    glm::ivec2 last;
+    while(wanted > 0 && tileRange(header, wanted, viewMin, viewMax, first, last)){
+        const uint64_t tiles = static_cast<uint64_t>(last.x - first.x + 1) * static_cast<uint64_t>(last.y - first.y + 1);
+        if(tiles * TILE_CAPACITY <= TILE_MAX_VISIBLE_POINTS){
+            break;
+        }
+        wanted--;
+    }
+    return wanted;
+}
+
+void TileStreamer::use(CacheEntry& entry){
+    entry.usedFrame = frame;
+    lru.splice(lru.begin(), lru, entry.lru);
+}
+
+bool TileStreamer::collect(uint32_t viewLevel, glm::vec2 viewMin, glm::vec2 viewMax, std::vector<uint64_t>& missing){
+    std::vector<uint64_t> keys;
+    glm::ivec2 first;
+    glm::ivec2 last;
+    if(tileRange(header, viewLevel, viewMin, viewMax, first, last)){
+        for(int y = first.y; y <= last.y; y++){
+            for(int x = first.x; x <= last.x; x++){
+                // The tile itself, the leaf it's under, or nothing when the first ancestor found has children but not this one
+                uint64_t key = tileKey(viewLevel, static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+                const TileEntry* entry = find(key);
+                while(!entry && tileLevel(key) > 0){
+                    key = tileParent(key);
+                    entry = find(key);
+                }
+                if(!entry || (tileLevel(key) < viewLevel && !entry->leaf)){
+                    continue;
+                }
+                if(cache.contains(key)){
+                    keys.push_back(key);
+                    continue;
+                }
+                missing.push_back(key);
+                while(tileLevel(key) > 0){ // closest cached ancestor until it arrives
+                    key = tileParent(key);
+                    if(cache.contains(key)){
+                        keys.push_back(key);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Leaves and stand-ins can repeat, and a stand-in covers whatever was loaded under it
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    std::erase_if(keys, [&keys](uint64_t key){
+        while(tileLevel(key) > 0){
+            key = tileParent(key);
+            if(std::binary_search(keys.begin(), keys.end(), key)){
+                return true;
+            }
+        }
+        return false;
+    });
+    for(uint64_t key : keys){
+        use(cache.at(key));
+    }
+    if(keys == visibleKeys){
+        return false;
+    }
+    visibleKeys = std::move(keys);
+    visible.clear();
+    visiblePoints = 0;
+    for(uint64_t key : visibleKeys){
+        visible.push_back(cache.at(key).tile);
+        visiblePoints += visible.back()->size();
+    }
+    return true;
+}
+
+bool TileStreamer::update(glm::vec2 viewMin, glm::vec2 viewMax, float zoom){
+    if(!isOpen()){
+        return false;
+    }
+    frame++;
+    uint64_t busy;
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        for(auto& [key, tile] : loaded){
+            if(cache.contains(key)){
+                continue;
+            }
+            lru.push_front(key);
+            cacheBytes += tile->size() * sizeof(TilePoint);
+            cache.emplace(key, CacheEntry{std::move(tile), lru.begin(), frame});
+        }
+        loaded.clear();
+        busy = reading;
+    }
+
+    level = chooseLevel(viewMin, viewMax, zoom);
+    std::vector<uint64_t> missing;
+    const bool changed = collect(level, viewMin, viewMax, missing);
+
+    // Nearest to the middle of the view at the back, that's where the I/O thread takes from
+    const float tileSize = header.size / static_cast<float>(1u << level);
+    const glm::vec2 middle = ((viewMin + viewMax) * 0.5f - header.origin) / tileSize;
+    auto distance = [this, middle](uint64_t key){ // in tiles of the view level, leaves can be coarser
+        const float scale = std::ldexp(1.0f, static_cast<int>(level) - static_cast<int>(tileLevel(key)));
+        const glm::vec2 center(static_cast<float>(key & 0xFFFFFFF) + 0.5f, static_cast<float>((key >> 28) & 0xFFFFFFF) + 0.5f);
+        const glm::vec2 d = center * scale - middle;
+        return d.x * d.x + d.y * d.y;
+    };
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    std::erase(missing, busy);
+    std::sort(missing.begin(), missing.end(), [&distance](uint64_t a, uint64_t b){return distance(a) > distance(b);});
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        requests = std::move(missing); // whatever the last view wanted and didn't get doesn't matter anymore
+    }
+    ioCondition.notify_one();
+    evict();
+    return changed;
+}
+
+void TileStreamer::evict(){
+    while(cacheBytes > cacheBudget && !lru.empty()){
+        const auto it = cache.find(lru.back());
+        if(it->second.usedFrame == frame){
+            break; // on screen, and so is everything in front of it
+        }
+        cacheBytes -= it->second.tile->size() * sizeof(TilePoint);
+        cache.erase(it);
+        lru.pop_back();
+    }
+}
+
+TileStreamStats TileStreamer::getStats() const{
+    TileStreamStats stats;
+    stats.level = level;
+    stats.visibleTiles = static_cast<uint32_t>(visible.size());
+    stats.visiblePoints = visiblePoints;
+    stats.cacheBytes = cacheBytes;
+    std::lock_guard<std::mutex> lock(ioMutex);
+    stats.pendingTiles = static_cast<uint32_t>(requests.size()) + (reading != UINT64_MAX ? 1 : 0);
+    return stats;
+}
+
+// The directory doesn't change while this runs, only the file position is this thread's
+void TileStreamer::ioLoop(){
+    std::unique_lock<std::mutex> lock(ioMutex);
+    while(true){
+        ioCondition.wait(lock, [this]{return stopping || !requests.empty();});
+        if(stopping){
+            return;
+        }
+        reading = requests.back();
+        requests.pop_back();
+        lock.unlock();
+
+        const TileEntry* entry = find(reading);
+        auto points = std::make_shared<std::vector<TilePoint>>(entry->count);
+        file.seekg(static_cast<std::streamoff>(entry->offset));
+        const bool read = static_cast<bool>(file.read(reinterpret_cast<char*>(points->data()), static_cast<std::streamsize>(points->size() * sizeof(TilePoint))));
+        file.clear();
+
+        lock.lock();
+        if(read){
+            loaded.emplace_back(reading, std::move(points));
+        }
+        reading = UINT64_MAX;
+    }
+}
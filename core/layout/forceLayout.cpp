@@ -0,0 +1,320 @@
+#include <ThING/layout/forceLayout.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+inline constexpr size_t NODE_GRAIN = 0x400; // a node walks the tree, way heavier than a verlet body
+inline constexpr size_t COPY_GRAIN = 0x4000;
+inline constexpr uint32_t LEAF_SIZE = 8;
+inline constexpr uint32_t MAX_TREE_DEPTH = 24; // stacked nodes end up in one leaf instead of splitting forever
+inline constexpr uint32_t NO_CHILD = UINT32_MAX;
+inline constexpr float MIN_DIST2 = 1e-3f;
+inline constexpr float MIN_TEMPERATURE = 0.002f;
+inline constexpr float REHEAT_TEMPERATURE = 0.3f; // enough for new nodes to find their place, the rest barely moves
+inline constexpr float SPAWN_SPREAD = 0.25f; // in spring lengths, also splits nodes that spawn on the same spot
+inline constexpr float GOLDEN_ANGLE = 2.39996323f;
+
+uint32_t ForceLayout::step(std::span<InstanceData> circles, std::span<const EdgeData> edges, JobSystem& jobs){
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const std::chrono::duration<float, std::milli> budget(timeBudget);
+
+    syncNodes(circles, edges);
+    if(order.empty()){
+        return 0;
+    }
+
+    // Always one iteration, then only start another one if the last one still fits
+    uint32_t iterations = 0;
+    Clock::duration lastIteration{};
+    while(!isSettled() && (iterations == 0 || Clock::now() - start + lastIteration < budget)){
+        const Clock::time_point iterationStart = Clock::now();
+        iterate(jobs);
+        temperature = std::max(temperature * cooling, MIN_TEMPERATURE);
+        iterations++;
+        lastIteration = Clock::now() - iterationStart;
+    }
+
+    jobs.parallelForRange(order.size(), COPY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t k = begin; k < end; k++){
+            circles[order[k]].position = position[order[k]];
+        }
+    });
+    return iterations;
+}
+
+void ForceLayout::teleport(uint32_t index, glm::vec2 pos){
+    if(index >= position.size()){
+        return;
+    }
+    position[index] = pos;
+}
+
+void ForceLayout::reheat(float temperature){
+    this->temperature = std::max(this->temperature, temperature);
+}
+
+void ForceLayout::clear(){
+    temperature = 0.0f;
+    edgeHash = 0;
+    position.clear();
+    displacement.clear();
+    active.clear();
+    newcomers.clear();
+    adjacencyStart.clear();
+    adjacency.clear();
+    order.clear();
+    sortedPosition.clear();
+    nodes.clear();
+}
+
+// Every alive circle becomes a placed node where it is, so the next step only has to build the adjacency
+void ForceLayout::adopt(std::span<const InstanceData> circles){
+    clear();
+    position.resize(circles.size());
+    displacement.resize(circles.size());
+    active.resize(circles.size(), 0);
+    for(uint32_t i = 0; i < circles.size(); i++){
+        if(!circles[i].alive) continue;
+        position[i] = circles[i].position;
+        active[i] = 1;
+        order.push_back(i);
+    }
+    reheat();
+}
+
+bool ForceLayout::isSettled() const{
+    return temperature <= MIN_TEMPERATURE;
+}
+
+// Wakes up new circles, puts dead ones to sleep and rebuilds the adjacency when the graph changed.
+// Newcomers get placed in the order they show up, so a chain added in one frame unrolls from its placed end
+void ForceLayout::syncNodes(std::span<const InstanceData> circles, std::span<const EdgeData> edges){
+    const size_t count = circles.size();
+    bool nodesChanged = count != position.size();
+    position.resize(count);
+    displacement.resize(count);
+    active.resize(count, 0);
+
+    newcomers.clear();
+    for(uint32_t i = 0; i < count; i++){
+        if(!circles[i].alive){
+            nodesChanged |= active[i] != 0;
+            active[i] = 0;
+        } else if(!active[i]){
+            newcomers.push_back(i);
+        }
+    }
+    nodesChanged |= !newcomers.empty();
+
+    uint64_t hash = 0xcbf29ce484222325ull ^ edges.size();
+    for(const EdgeData& edge : edges){
+        hash = (hash ^ ((static_cast<uint64_t>(edge.from) << 32) | edge.to)) * 0x100000001b3ull;
+    }
+    const bool edgesChanged = hash != edgeHash;
+    edgeHash = hash;
+    if(!nodesChanged && !edgesChanged){
+        return;
+    }
+    buildAdjacency(circles, edges);
+
+    for(uint32_t i : newcomers){
+        glm::vec2 sum = {0.0f, 0.0f};
+        uint32_t placed = 0;
+        for(uint32_t a = adjacencyStart[i]; a < adjacencyStart[i + 1]; a++){
+            const uint32_t j = adjacency[a];
+            if(active[j]){
+                sum += position[j];
+                placed++;
+            }
+        }
+        const float angle = static_cast<float>(i) * GOLDEN_ANGLE;
+        const glm::vec2 spread = glm::vec2(std::cos(angle), std::sin(angle)) * (springLength * SPAWN_SPREAD);
+        position[i] = (placed > 0 ? sum / static_cast<float>(placed) : circles[i].position) + spread;
+        active[i] = 1;
+    }
+
+    const bool fresh = order.empty();
+    order.clear();
+    for(uint32_t i = 0; i < count; i++){
+        if(active[i]){
+            order.push_back(i);
+        }
+    }
+    reheat(fresh ? 1.0f : REHEAT_TEMPERATURE);
+}
+
+void ForceLayout::buildAdjacency(std::span<const InstanceData> circles, std::span<const EdgeData> edges){
+    const size_t count = circles.size();
+    auto linked = [&](const EdgeData& edge){
+        return edge.from < count && edge.to < count && edge.from != edge.to && circles[edge.from].alive && circles[edge.to].alive;
+    };
+
+    // Counting sort: degree, exclusive scan, scatter. Every edge shows up on both of its ends
+    adjacencyStart.assign(count + 1, 0);
+    for(const EdgeData& edge : edges){
+        if(!linked(edge)) continue;
+        adjacencyStart[edge.from]++;
+        adjacencyStart[edge.to]++;
+    }
+    uint32_t sum = 0;
+    for(size_t i = 0; i <= count; i++){
+        const uint32_t degree = adjacencyStart[i];
+        adjacencyStart[i] = sum;
+        sum += degree;
+    }
+    adjacency.resize(sum);
+    std::vector<uint32_t> cursor(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for(const EdgeData& edge : edges){
+        if(!linked(edge)) continue;
+        adjacency[cursor[edge.from]++] = edge.to;
+        adjacency[cursor[edge.to]++] = edge.from;
+    }
+}
+
+// Fruchterman-Reingold forces: k^2 / d apart, d^2 / k along edges, so a lone pair rests at springLength.
+// The step is capped by the temperature, which is what makes it converge
+void ForceLayout::iterate(JobSystem& jobs){
+    buildTree(jobs);
+    const float maxStep = temperature * springLength;
+    jobs.parallelForRange(order.size(), NODE_GRAIN, [&](size_t begin, size_t end){
+        for(size_t k = begin; k < end; k++){
+            const uint32_t i = order[k];
+            glm::vec2 force = repulse(static_cast<uint32_t>(k)) + attract(i) + (center - position[i]) * gravity;
+            const float length = glm::length(force);
+            if(length > maxStep){
+                force *= maxStep / length;
+            }
+            displacement[i] = force;
+        }
+    });
+    jobs.parallelForRange(order.size(), COPY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t k = begin; k < end; k++){
+            position[order[k]] += displacement[order[k]];
+        }
+    });
+}
+
+void ForceLayout::buildTree(JobSystem& jobs){
+    glm::vec2 lo = glm::vec2(std::numeric_limits<float>::max());
+    glm::vec2 hi = glm::vec2(std::numeric_limits<float>::lowest());
+    std::mutex boundsMutex;
+    jobs.parallelForRange(order.size(), COPY_GRAIN, [&](size_t begin, size_t end){
+        glm::vec2 localLo = glm::vec2(std::numeric_limits<float>::max());
+        glm::vec2 localHi = glm::vec2(std::numeric_limits<float>::lowest());
+        for(size_t k = begin; k < end; k++){
+            localLo = glm::min(localLo, position[order[k]]);
+            localHi = glm::max(localHi, position[order[k]]);
+        }
+        std::lock_guard<std::mutex> lock(boundsMutex);
+        lo = glm::min(lo, localLo);
+        hi = glm::max(hi, localHi);
+    });
+
+    // Square root cell, a bit bigger than the bounds so the max corner still falls inside
+    const glm::vec2 extent = hi - lo;
+    const float size = std::max(extent.x, extent.y) * 1.001f + 1.0f;
+    nodes.clear();
+    nodes.push_back({});
+    buildNode(0, 0, static_cast<uint32_t>(order.size()), lo, size, 0);
+
+    sortedPosition.resize(order.size());
+    jobs.parallelForRange(order.size(), COPY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t k = begin; k < end; k++){
+            sortedPosition[k] = position[order[k]];
+        }
+    });
+}
+
+// Splits order[begin, end) into quadrants in place, children get stored before recursing so they stay contiguous.
+// order is kept between iterations, nodes barely move so the partitions have little to do
+void ForceLayout::buildNode(uint32_t node, uint32_t begin, uint32_t end, glm::vec2 min, float size, uint32_t depth){
+    nodes[node].size = size;
+    nodes[node].begin = begin;
+    nodes[node].end = end;
+    if(end - begin <= LEAF_SIZE || depth == MAX_TREE_DEPTH){
+        glm::vec2 sum = {0.0f, 0.0f};
+        for(uint32_t k = begin; k < end; k++){
+            sum += position[order[k]];
+        }
+        nodes[node].mass = static_cast<float>(end - begin);
+        nodes[node].centerOfMass = end > begin ? sum / nodes[node].mass : min + size * 0.5f;
+        nodes[node].firstChild = NO_CHILD;
+        return;
+    }
+
+    const float half = size * 0.5f;
+    const glm::vec2 mid = min + half;
+    uint32_t* first = order.data() + begin;
+    uint32_t* last = order.data() + end;
+    uint32_t* splitY = std::partition(first, last, [&](uint32_t i){return position[i].y < mid.y;});
+    uint32_t* splitTop = std::partition(first, splitY, [&](uint32_t i){return position[i].x < mid.x;});
+    uint32_t* splitBottom = std::partition(splitY, last, [&](uint32_t i){return position[i].x < mid.x;});
+    const std::array<uint32_t, 5> bounds = {
+        begin,
+        static_cast<uint32_t>(splitTop - order.data()),
+        static_cast<uint32_t>(splitY - order.data()),
+        static_cast<uint32_t>(splitBottom - order.data()),
+        end
+    };
+    const std::array<glm::vec2, 4> offsets = {glm::vec2{0.0f, 0.0f}, {half, 0.0f}, {0.0f, half}, {half, half}};
+
+    const uint32_t child = static_cast<uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + 4);
+    nodes[node].firstChild = child;
+
+    glm::vec2 sum = {0.0f, 0.0f};
+    float mass = 0.0f;
+    for(uint32_t c = 0; c < 4; c++){
+        buildNode(child + c, bounds[c], bounds[c + 1], min + offsets[c], half, depth + 1);
+        sum += nodes[child + c].centerOfMass * nodes[child + c].mass;
+        mass += nodes[child + c].mass;
+    }
+    nodes[node].mass = mass;
+    nodes[node].centerOfMass = sum / mass;
+}
+
+glm::vec2 ForceLayout::repulse(uint32_t slot) const{
+    const glm::vec2 p = sortedPosition[slot];
+    const float theta2 = theta * theta;
+    glm::vec2 force = {0.0f, 0.0f};
+
+    std::array<uint32_t, MAX_TREE_DEPTH * 3 + 4> stack;
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while(top > 0){
+        const QuadNode& node = nodes[stack[--top]];
+        if(node.mass == 0.0f) continue;
+        if(node.firstChild == NO_CHILD){
+            for(uint32_t k = node.begin; k < node.end; k++){
+                if(k == slot) continue;
+                const glm::vec2 delta = p - sortedPosition[k];
+                force += delta / (glm::dot(delta, delta) + MIN_DIST2);
+            }
+            continue;
+        }
+        const glm::vec2 delta = p - node.centerOfMass;
+        const float dist2 = glm::dot(delta, delta);
+        if(node.size * node.size < theta2 * dist2){
+            force += delta * (node.mass / (dist2 + MIN_DIST2));
+            continue;
+        }
+        for(uint32_t c = 0; c < 4; c++){
+            stack[top++] = node.firstChild + c;
+        }
+    }
+    return force * (repulsion * springLength * springLength);
+}
+
+glm::vec2 ForceLayout::attract(uint32_t index) const{
+    const glm::vec2 p = position[index];
+    glm::vec2 force = {0.0f, 0.0f};
+    for(uint32_t a = adjacencyStart[index]; a < adjacencyStart[index + 1]; a++){
+        const glm::vec2 delta = position[adjacency[a]] - p;
+        force += delta * glm::length(delta);
+    }
+    return force * (springStiffness / springLength);
+}
@@ -1,30 +1,97 @@
 #include "ThING/types/renderData.h"
+#include "ThING/types/tween.h"
 #include <ThING/core.h>
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <mutex>
+#include <span>
 #include <vector>
 
+// A scale tween is drawn anywhere between its ends (the easings don't overshoot), so those count as well
+static float smallestAliveRadius(std::span<const InstanceData> circles, std::span<const TweenData> tweens, JobSystem& jobs){
+    float smallest = std::numeric_limits<float>::infinity();
+    std::mutex smallestMutex;
+    jobs.parallelForRange(circles.size(), INSTANCE_COPY_GRAIN, [&](size_t begin, size_t end){
+        float local = std::numeric_limits<float>::infinity();
+        for (size_t i = begin; i < end; i++) {
+            if (!circles[i].alive) continue;
+            local = std::min(local, circles[i].scale.x);
+            const uint32_t slot = circles[i].tweenSlot;
+            if (slot != 0 && slot < tweens.size()) {
+                const TweenTrack& scale = tweens[slot].tracks[toIndex(TweenProperty::Scale)];
+                if (scale.duration > 0.0f) local = std::min({local, scale.from.x, scale.to.x});
+            }
+        }
+        std::lock_guard<std::mutex> lock(smallestMutex);
+        smallest = std::min(smallest, local);
+    });
+    return smallest;
+}
+
 //PASS THIS THING TO A RENDERER CLASS LATER
 void ProtoThiApp::renderFrame(){
-    std::vector<VkDrawIndexedIndirectCommand> indirectCommands;
-
-    indirectCommands.reserve(worldData.meshes.size());
-
-    for (const MeshData& mesh : worldData.meshes) {
-        if (worldData.polygonInstances[mesh.instanceIndex].alive == false) continue;
-        indirectCommands.push_back({
-            .indexCount = mesh.indexCount,
-            .instanceCount = 1,
-            .firstIndex = mesh.indexOffset,
-            .vertexOffset = static_cast<int32_t>(mesh.vertexOffset),
-            .firstInstance = mesh.instanceIndex + worldData.polygonOffset
-        });
+    // Everything below writes currentFrame resources, so it has to happen after the GPU let go of the slot
+    waitForFrameSlot();
+
+    // One command per mesh so every job writes its own range, dead polygons just draw 0 instances
+    indirectCommands.resize(worldData.meshes.size());
+    jobSystem.parallelForRange(worldData.meshes.size(), INDIRECT_BUILD_GRAIN, [this](size_t begin, size_t end){
+        for (size_t i = begin; i < end; i++) {
+            const MeshData& mesh = worldData.meshes[i];
+            indirectCommands[i] = {
+                .indexCount = mesh.indexCount,
+                .instanceCount = worldData.polygonInstances[mesh.instanceIndex].alive ? 1u : 0u,
+                .firstIndex = mesh.indexOffset,
+                .vertexOffset = static_cast<int32_t>(mesh.vertexOffset),
+                .firstInstance = mesh.instanceIndex + worldData.polygonOffset
+            };
+        }
+    });
+
+    indirectCommandCount = bufferManager.updateIndirectBuffers(indirectCommands, currentFrame);
+
+    physicsFrame = gpuPhysics.frame(currentFrame, worldData.circleInstances, worldData.dirtyFlags.circles, worldData.edges, bufferManager, jobSystem);
+    worldData.gpuPhysics = physicsFrame.enabled;
+    const uint32_t physicsBodies = physicsFrame.enabled ? physicsFrame.constants.bodyCount : 0;
+
+    // Picks come in window coordinates, the id image is framebuffer sized
+    int windowWidth, windowHeight;
+    glfwGetWindowSize(windowManager.getWindow(), &windowWidth, &windowHeight);
+    const VkExtent2D extent = swapChainManager.getExtent();
+    const glm::vec2 framebufferScale = {
+        extent.width / static_cast<float>(std::max(windowWidth, 1)),
+        extent.height / static_cast<float>(std::max(windowHeight, 1))
+    };
+    pickFrame = pickManager.frame(currentFrame, framebufferScale, extent, worldData, bufferManager);
+
+    const uint32_t circleCount = static_cast<uint32_t>(worldData.circleInstances.size());
+    HeatmapUniform heatmapUniform;
+    heatmapFrame = heatmapManager.frame(zoom, extent, circleCount, heatmapUniform);
+    if (heatmapFrame.circleCount > 0) {
+        bufferManager.reserveHeatmapGrid(heatmapFrame.cells);
+        bufferManager.updateHeatmapUniform(heatmapUniform, currentFrame);
     }
 
-    indirectCommandCount = indirectCommands.size();
+    // Circles under the threshold skip the quad draw, splat.comp puts them on one pixel each. Scales only change on the
+    // CPU or through a tween starting or ending, so the smallest one is rescanned whenever the circles get uploaded
+    // anyway or a tween slot changed, and a frame where no circle is small enough skips the splat pass and its resolve
+    if (worldData.dirtyFlags.circles || !worldData.gpuPhysics || !worldData.tweenDirtySlots.empty()) {
+        smallestCircle = smallestAliveRadius(worldData.circleInstances, worldData.tweenData, jobSystem);
+    }
+    const float splatRadius = splatThreshold / (zoom == 0 ? .001f : zoom); // same as ubo.splatRadius
+    splatCircles = (splatThreshold > 0.0f && !heatmapFrame.circlesHidden && smallestCircle < splatRadius) ? circleCount : 0;
+    if (splatCircles > 0) {
+        bufferManager.reserveSplatBuffer(extent);
+    }
 
-    bufferManager.updateIndirectBuffers(indirectCommands, swapChainManager.getInFlightFences(), currentFrame);
-    bufferManager.updateUniformBuffers(swapChainManager.getExtent(), zoom, offset, currentFrame);
-    bufferManager.updateCustomBuffers(vertices, indices, worldData, swapChainManager.getInFlightFences(), currentFrame);
+    bufferManager.updateUniformBuffers(swapChainManager.getExtent(), zoom, offset, physicsBodies, splatCircles > 0 ? splatThreshold : 0.0f,
+        heatmapFrame.circleAlpha, tweenManager.now(), currentFrame);
+    bufferManager.updateCustomBuffers(worldData.vertices, worldData.indices, worldData, currentFrame, jobSystem);
+    frameStats.uploadBytes = bufferManager.getUploadBytes();
+    frameStats.uploadTime = bufferManager.getUploadTime();
+    frameStats.uploadBandwidth = frameStats.uploadTime > 0.0f ? frameStats.uploadBytes / (frameStats.uploadTime * 1e6f) : 0.0f;
+    worldData.ssboDirtySlots = {};
 
     glfwPollEvents();
     drawFrame();
@@ -0,0 +1,258 @@
+#include <ThING/physics/gpuPhysics.h>
+#include <ThING/graphics/bufferManager.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+inline constexpr size_t RADIUS_SCAN_GRAIN = 0x4000;
+inline constexpr size_t EDGE_SCAN_GRAIN = 0x4000;
+inline constexpr float LAYOUT_REHEAT_TEMPERATURE = 0.3f;
+
+void GpuPhysics::setSettings(const GpuPhysicsSettings& settings){
+    std::lock_guard<std::mutex> lock(mutex);
+    this->settings = settings;
+    this->settings.substeps = std::max(settings.substeps, 1u);
+}
+
+GpuPhysicsSettings GpuPhysics::getSettings(){
+    std::lock_guard<std::mutex> lock(mutex);
+    return settings;
+}
+
+void GpuPhysics::step(float dt){
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingDt = dt;
+}
+
+void GpuPhysics::reseed(){
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingReseed = true;
+}
+
+void GpuPhysics::setLayout(const GpuLayoutSettings& settings){
+    std::lock_guard<std::mutex> lock(mutex);
+    layoutSettings = settings;
+    layoutSettings.springLength = settings.springLength > 0.0f ? settings.springLength : 1.0f;
+}
+
+GpuLayoutSettings GpuPhysics::getLayout(){
+    std::lock_guard<std::mutex> lock(mutex);
+    return layoutSettings;
+}
+
+void GpuPhysics::reheatLayout(float temperature){
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingReheat = std::max(pendingReheat, temperature);
+}
+
+void GpuPhysics::requestReadback(){
+    std::lock_guard<std::mutex> lock(mutex);
+    readbackRequested = true;
+}
+
+// Newest finished copy that wasn't handed out yet. The lock is held during the copy so the render thread
+// can't record a new copy into the same slot while we read it
+bool GpuPhysics::readPositions(VkDevice device, VkSemaphore frameTimeline, const BufferManager& bufferManager, std::vector<glm::vec2>& positions){
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t completed = 0;
+    vkGetSemaphoreCounterValue(device, frameTimeline, &completed);
+
+    int64_t slot = -1;
+    for(uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        const uint64_t value = readbackValues[i];
+        if(value == 0 || value > completed || value <= lastReadValue) continue;
+        if(slot < 0 || value > readbackValues[slot]){
+            slot = i;
+        }
+    }
+    if(slot < 0){
+        return false;
+    }
+    const glm::vec2* data = bufferManager.viewPhysicsReadback(slot);
+    positions.assign(data, data + readbackCounts[slot]);
+    lastReadValue = readbackValues[slot];
+    return true;
+}
+
+PhysicsFrame GpuPhysics::frame(uint32_t frameIndex, std::span<const InstanceData> circles, bool circlesDirty, std::span<const EdgeData> edges,
+    BufferManager& bufferManager, JobSystem& jobs){
+    PhysicsFrame frame;
+    GpuPhysicsSettings current;
+    GpuLayoutSettings layout;
+    float dt;
+    bool reseed;
+    float reheat;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = settings;
+        layout = layoutSettings;
+        if(!current.enabled && !layout.enabled){
+            wasEnabled = false;
+            wasLayout = false;
+            return frame;
+        }
+        dt = pendingDt;
+        reseed = pendingReseed;
+        reheat = pendingReheat;
+        pendingDt = 0.0f;
+        pendingReseed = false;
+        pendingReheat = 0.0f;
+        frame.readback = readbackRequested;
+        if(frame.readback){
+            readbackValues[frameIndex] = 0; // about to be overwritten by this frame
+        }
+    }
+
+    const uint32_t bodyCount = static_cast<uint32_t>(std::min<size_t>(circles.size(), MAX_PHYSICS_BODIES));
+    // Bodies keep their state while disabled or past a shrink, start them over from the CPU side
+    reseed = reseed || !wasEnabled || bodyCount < lastBodyCount;
+    if(circlesDirty || !wasEnabled){
+        cellSize = std::max(findMaxRadius(circles.first(bodyCount), jobs) * 2.0f, 1.0f);
+    }
+    const bool bodiesChanged = bodyCount != lastBodyCount;
+    wasEnabled = true;
+    lastBodyCount = bodyCount;
+
+    frame.enabled = true;
+    frame.substeps = (dt > 0.0f && !layout.enabled) ? current.substeps : 0;
+    frame.constants = {
+        .gravity = current.gravity,
+        .minBound = current.minBound,
+        .maxBound = current.maxBound,
+        .dt = dt / static_cast<float>(current.substeps),
+        .stiffness = current.stiffness,
+        .resistance = current.resistance,
+        .cellSize = cellSize,
+        .bodyCount = bodyCount,
+        .pass = 0,
+        .reseed = reseed ? 1u : 0u
+    };
+    if(layout.enabled){
+        layoutFrame(frame, frameIndex, layout, reheat, bodiesChanged, edges, bufferManager, jobs);
+    }
+    wasLayout = layout.enabled;
+    return frame;
+}
+
+// Temperature schedule and adjacency upload, the CPU never sees a layout position
+void GpuPhysics::layoutFrame(PhysicsFrame& frame, uint32_t frameIndex, const GpuLayoutSettings& layout, float reheat, bool bodiesChanged,
+    std::span<const EdgeData> edges, BufferManager& bufferManager, JobSystem& jobs){
+    const uint32_t bodyCount = frame.constants.bodyCount;
+    const uint64_t hash = hashEdges(edges, jobs);
+    const bool graphChanged = !wasLayout || bodiesChanged || hash != edgeHash;
+    if(graphChanged || adjacencyPending){
+        edgeHash = hash;
+        adjacencyPending = true;
+        frame.adjacencySize = buildAdjacency(bufferManager.getLayoutStaging(frameIndex), bodyCount, edges, jobs);
+    }
+    if(graphChanged){
+        temperature = std::max(temperature, wasLayout ? LAYOUT_REHEAT_TEMPERATURE : 1.0f);
+    }
+    temperature = std::max(temperature, reheat);
+
+    frame.layout = true;
+    frame.iterations = temperature > LAYOUT_MIN_TEMPERATURE ? layout.iterations : 0;
+    frame.temperature = temperature;
+    frame.cooling = layout.cooling;
+    for(uint32_t i = 0; i < frame.iterations; i++){
+        temperature = std::max(temperature * layout.cooling, LAYOUT_MIN_TEMPERATURE);
+    }
+    frame.layoutConstants = {
+        .center = layout.center,
+        .springLength = layout.springLength,
+        .springStiffness = layout.springStiffness,
+        .repulsion = layout.repulsion,
+        .gravity = layout.gravity,
+        .theta = layout.theta,
+        .maxStep = 0.0f, // per iteration
+        .bodyCount = bodyCount,
+        .pass = 0,
+        .level = 0,
+        .reseed = frame.constants.reseed
+    };
+}
+
+void GpuPhysics::submitted(uint32_t frameIndex, uint64_t timelineValue, const PhysicsFrame& frame){
+    if(frame.adjacencySize > 0){
+        adjacencyPending = false;
+    }
+    if(!frame.readback){
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    readbackValues[frameIndex] = timelineValue;
+    readbackCounts[frameIndex] = frame.constants.bodyCount;
+    readbackRequested = false;
+}
+
+// Same integer CAS max as VerletSolver::syncBodies, positive floats keep their order as integers
+float GpuPhysics::findMaxRadius(std::span<const InstanceData> circles, JobSystem& jobs){
+    std::atomic<uint32_t> maxRadiusBits = 0;
+    jobs.parallelForRange(circles.size(), RADIUS_SCAN_GRAIN, [&](size_t begin, size_t end){
+        float localMax = 0.0f;
+        for(size_t i = begin; i < end; i++){
+            if(circles[i].alive){
+                localMax = std::max(localMax, circles[i].scale.x);
+            }
+        }
+        uint32_t bits = std::bit_cast<uint32_t>(localMax);
+        uint32_t seen = maxRadiusBits.load(std::memory_order_relaxed);
+        while(bits > seen && !maxRadiusBits.compare_exchange_weak(seen, bits, std::memory_order_relaxed));
+    });
+    return std::bit_cast<float>(maxRadiusBits.load());
+}
+
+// Order doesn't matter for the forces, so every edge is mixed on its own with its index and the sums get added up
+uint64_t GpuPhysics::hashEdges(std::span<const EdgeData> edges, JobSystem& jobs){
+    std::atomic<uint64_t> hash = edges.size();
+    jobs.parallelForRange(edges.size(), EDGE_SCAN_GRAIN, [&](size_t begin, size_t end){
+        uint64_t local = 0;
+        for(size_t i = begin; i < end; i++){
+            uint64_t x = ((static_cast<uint64_t>(edges[i].from) << 32) | edges[i].to) ^ (i * 0x9E3779B97F4A7C15ull);
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            local += x ^ (x >> 31);
+        }
+        hash.fetch_add(local, std::memory_order_relaxed);
+    });
+    return hash.load();
+}
+
+// CSR in one array: [0..bodyCount] are offsets into the same array, then the neighbour lists. Same counting sort as
+// the Verlet grid, every edge shows up on both of its ends. Dead circles stay in, layout.comp skips them
+uint32_t GpuPhysics::buildAdjacency(uint32_t* staging, uint32_t bodyCount, std::span<const EdgeData> edges, JobSystem& jobs){
+    edges = edges.first(std::min<size_t>(edges.size(), MAX_EDGES));
+    auto linked = [bodyCount](const EdgeData& edge){
+        return edge.from < bodyCount && edge.to < bodyCount && edge.from != edge.to;
+    };
+
+    adjacency.assign(bodyCount + 1, 0);
+    jobs.parallelForRange(edges.size(), EDGE_SCAN_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(!linked(edges[i])) continue;
+            std::atomic_ref<uint32_t>(adjacency[edges[i].from]).fetch_add(1, std::memory_order_relaxed);
+            std::atomic_ref<uint32_t>(adjacency[edges[i].to]).fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    uint32_t sum = bodyCount + 1;
+    for(uint32_t i = 0; i <= bodyCount; i++){
+        const uint32_t degree = adjacency[i];
+        adjacency[i] = sum;
+        sum += degree;
+    }
+    adjacencyCursor.assign(adjacency.begin(), adjacency.end() - 1);
+    adjacency.resize(sum);
+
+    jobs.parallelForRange(edges.size(), EDGE_SCAN_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(!linked(edges[i])) continue;
+            const EdgeData& edge = edges[i];
+            adjacency[std::atomic_ref<uint32_t>(adjacencyCursor[edge.from]).fetch_add(1, std::memory_order_relaxed)] = edge.to;
+            adjacency[std::atomic_ref<uint32_t>(adjacencyCursor[edge.to]).fetch_add(1, std::memory_order_relaxed)] = edge.from;
+        }
+    });
+    std::memcpy(staging, adjacency.data(), adjacency.size() * sizeof(uint32_t));
+    return sum;
+}
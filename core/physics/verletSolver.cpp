@@ -0,0 +1,274 @@
+#include <ThING/physics/verletSolver.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define THING_VERLET_SSE2
+#endif
+
+inline constexpr size_t BODY_GRAIN = 0x2000;
+inline constexpr uint32_t COLLISION_BLOCK = 8; // cells per block side, anything >= 2 keeps same coloured blocks apart
+inline constexpr uint64_t MAX_GRID_CELLS = 0x400000;
+inline constexpr uint32_t NO_CELL = UINT32_MAX;
+inline constexpr float MIN_DIST2 = 1e-3f;
+
+void VerletSolver::step(std::span<InstanceData> circles, float dt, JobSystem& jobs){
+    const float maxRadius = syncBodies(circles, jobs);
+    const float subDt = dt / static_cast<float>(substeps);
+
+    uint32_t collisions = 0;
+    for(uint32_t s = 0; s < substeps; s++){
+        integrate(subDt, jobs);
+        buildGrid(std::max(maxRadius * 2.0f, 1.0f), jobs);
+        collisions = solveCollisions(jobs);
+        applyBounds(circles, jobs);
+    }
+    collisionCount = collisions;
+    std::fill(acceleration.begin(), acceleration.end(), glm::vec2{0.0f, 0.0f});
+}
+
+void VerletSolver::teleport(uint32_t index, glm::vec2 pos){
+    if(index >= current.size()){
+        return;
+    }
+    current[index] = pos;
+    previous[index] = pos;
+}
+
+void VerletSolver::accelerate(uint32_t index, glm::vec2 acc){
+    if(index >= acceleration.size()){
+        return;
+    }
+    acceleration[index] += acc;
+}
+
+void VerletSolver::clear(){
+    current.clear();
+    previous.clear();
+    written.clear();
+    acceleration.clear();
+    radius.clear();
+    active.clear();
+    bodyCell.clear();
+}
+
+// Wakes up new circles, puts dead ones to sleep and returns the biggest radius (grid cell size)
+float VerletSolver::syncBodies(std::span<const InstanceData> circles, JobSystem& jobs){
+    const size_t count = circles.size();
+    current.resize(count);
+    previous.resize(count);
+    written.resize(count);
+    acceleration.resize(count, {0.0f, 0.0f});
+    radius.resize(count);
+    active.resize(count, 0);
+    bodyCell.resize(count);
+
+    // Positive floats keep their order as integers, so the max can be an integer CAS
+    std::atomic<uint32_t> maxRadiusBits = 0;
+    jobs.parallelForRange(count, BODY_GRAIN, [&](size_t begin, size_t end){
+        float localMax = 0.0f;
+        for(size_t i = begin; i < end; i++){
+            if(!circles[i].alive){
+                active[i] = 0;
+                continue;
+            }
+            // applyBounds left every awake circle where it wrote it, anything else is a new circle in a reused slot or
+            // was moved from outside. Checked against that and not the body so teleport isn't undone
+            if(active[i] && circles[i].position != written[i]){
+                active[i] = 0;
+            }
+            if(!active[i]){
+                current[i] = circles[i].position;
+                previous[i] = circles[i].position;
+                written[i] = circles[i].position;
+                acceleration[i] = {0.0f, 0.0f};
+                active[i] = 1;
+            }
+            radius[i] = circles[i].scale.x;
+            localMax = std::max(localMax, radius[i]);
+        }
+        uint32_t bits = std::bit_cast<uint32_t>(localMax);
+        uint32_t seen = maxRadiusBits.load(std::memory_order_relaxed);
+        while(bits > seen && !maxRadiusBits.compare_exchange_weak(seen, bits, std::memory_order_relaxed));
+    });
+    return std::bit_cast<float>(maxRadiusBits.load());
+}
+
+void VerletSolver::integrate(float dt, JobSystem& jobs){
+    jobs.parallelForRange(current.size(), BODY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(!active[i]) continue;
+            const glm::vec2 velocity = current[i] - previous[i];
+            previous[i] = current[i];
+            current[i] += velocity + (gravity + acceleration[i] - velocity * resistance) * dt * dt;
+        }
+    });
+}
+
+void VerletSolver::buildGrid(float minCellSize, JobSystem& jobs){
+    const glm::vec2 extent = glm::max(maxBound - minBound, glm::vec2(1.0f));
+    cellSize = minCellSize;
+    // Tiny circles in a huge box would make a huge mostly empty grid, grow the cells instead
+    while(static_cast<uint64_t>(std::ceil(extent.x / cellSize)) * static_cast<uint64_t>(std::ceil(extent.y / cellSize)) > MAX_GRID_CELLS){
+        cellSize *= 2.0f;
+    }
+    gridWidth = std::max(1u, static_cast<uint32_t>(std::ceil(extent.x / cellSize)));
+    gridHeight = std::max(1u, static_cast<uint32_t>(std::ceil(extent.y / cellSize)));
+    const uint32_t cellCount = gridWidth * gridHeight;
+
+    // Counting sort: count, exclusive scan, scatter
+    cellStart.assign(cellCount + 1, 0);
+    const float invCell = 1.0f / cellSize;
+    jobs.parallelForRange(current.size(), BODY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(!active[i]){
+                bodyCell[i] = NO_CELL;
+                continue;
+            }
+            const glm::vec2 local = (current[i] - minBound) * invCell;
+            const uint32_t x = static_cast<uint32_t>(std::clamp(static_cast<int64_t>(local.x), int64_t(0), int64_t(gridWidth - 1)));
+            const uint32_t y = static_cast<uint32_t>(std::clamp(static_cast<int64_t>(local.y), int64_t(0), int64_t(gridHeight - 1)));
+            bodyCell[i] = y * gridWidth + x;
+            std::atomic_ref<uint32_t>(cellStart[bodyCell[i]]).fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    uint32_t sum = 0;
+    for(uint32_t c = 0; c <= cellCount; c++){
+        const uint32_t cellBodies = cellStart[c];
+        cellStart[c] = sum;
+        sum += cellBodies;
+    }
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+
+    sortedBody.resize(sum);
+    sortedX.resize(sum);
+    sortedY.resize(sum);
+    sortedRadius.resize(sum);
+    jobs.parallelForRange(current.size(), BODY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(bodyCell[i] == NO_CELL) continue;
+            const uint32_t slot = std::atomic_ref<uint32_t>(cellCursor[bodyCell[i]]).fetch_add(1, std::memory_order_relaxed);
+            sortedBody[slot] = static_cast<uint32_t>(i);
+            sortedX[slot] = current[i].x;
+            sortedY[slot] = current[i].y;
+            sortedRadius[slot] = radius[i];
+        }
+    });
+}
+
+uint32_t VerletSolver::solveCollisions(JobSystem& jobs){
+    const uint32_t blocksX = (gridWidth + COLLISION_BLOCK - 1) / COLLISION_BLOCK;
+    const uint32_t blocksY = (gridHeight + COLLISION_BLOCK - 1) / COLLISION_BLOCK;
+    std::atomic<uint32_t> collisions = 0;
+
+    for(uint32_t colour = 0; colour < 4; colour++){
+        const uint32_t offsetX = colour & 1;
+        const uint32_t offsetY = colour >> 1;
+        const uint32_t countX = blocksX > offsetX ? (blocksX - offsetX + 1) / 2 : 0;
+        const uint32_t countY = blocksY > offsetY ? (blocksY - offsetY + 1) / 2 : 0;
+        jobs.parallelForRange(size_t(countX) * countY, 1, [&](size_t begin, size_t end){
+            uint32_t localCollisions = 0;
+            for(size_t k = begin; k < end; k++){
+                const uint32_t blockX = offsetX + 2 * static_cast<uint32_t>(k % countX);
+                const uint32_t blockY = offsetY + 2 * static_cast<uint32_t>(k / countX);
+                localCollisions += solveBlock(blockX, blockY);
+            }
+            collisions.fetch_add(localCollisions, std::memory_order_relaxed);
+        });
+    }
+
+    jobs.parallelForRange(sortedBody.size(), BODY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t k = begin; k < end; k++){
+            current[sortedBody[k]] = {sortedX[k], sortedY[k]};
+        }
+    });
+    return collisions;
+}
+
+// Every cell checks itself and the half of its neighbours ahead of it, so each pair is seen once
+uint32_t VerletSolver::solveBlock(uint32_t blockX, uint32_t blockY){
+    const uint32_t beginX = blockX * COLLISION_BLOCK;
+    const uint32_t beginY = blockY * COLLISION_BLOCK;
+    const uint32_t endX = std::min(beginX + COLLISION_BLOCK, gridWidth);
+    const uint32_t endY = std::min(beginY + COLLISION_BLOCK, gridHeight);
+    constexpr int32_t NEIGHBOURS[4][2] = {{1, -1}, {1, 0}, {1, 1}, {0, 1}};
+
+    uint32_t collisions = 0;
+    for(uint32_t y = beginY; y < endY; y++){
+        for(uint32_t x = beginX; x < endX; x++){
+            const uint32_t cell = y * gridWidth + x;
+            const uint32_t cellEnd = cellStart[cell + 1];
+            for(uint32_t a = cellStart[cell]; a < cellEnd; a++){
+                collisions += collide(a, a + 1, cellEnd);
+                for(const auto& offset : NEIGHBOURS){
+                    const int32_t nx = static_cast<int32_t>(x) + offset[0];
+                    const int32_t ny = static_cast<int32_t>(y) + offset[1];
+                    if(nx >= static_cast<int32_t>(gridWidth) || ny < 0 || ny >= static_cast<int32_t>(gridHeight)) continue;
+                    const uint32_t neighbour = static_cast<uint32_t>(ny) * gridWidth + static_cast<uint32_t>(nx);
+                    collisions += collide(a, cellStart[neighbour], cellStart[neighbour + 1]);
+                }
+            }
+        }
+    }
+    return collisions;
+}
+
+// Tests a against 4 candidates at a time, only the lanes that overlap go through the scalar resolve
+uint32_t VerletSolver::collide(uint32_t a, uint32_t begin, uint32_t end){
+    uint32_t collisions = 0;
+    uint32_t b = begin;
+#ifdef THING_VERLET_SSE2
+    const __m128 minDist2 = _mm_set1_ps(MIN_DIST2);
+    for(; b + 4 <= end; b += 4){
+        const __m128 ax = _mm_set1_ps(sortedX[a]);
+        const __m128 ay = _mm_set1_ps(sortedY[a]);
+        const __m128 ar = _mm_set1_ps(sortedRadius[a]);
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&sortedX[b]), ax);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&sortedY[b]), ay);
+        const __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 summed = _mm_add_ps(_mm_loadu_ps(&sortedRadius[b]), ar);
+        const __m128 hit = _mm_and_ps(_mm_cmplt_ps(dist2, _mm_mul_ps(summed, summed)), _mm_cmpgt_ps(dist2, minDist2));
+        int lanes = _mm_movemask_ps(hit);
+        while(lanes){
+            collisions += resolve(a, b + static_cast<uint32_t>(std::countr_zero(static_cast<unsigned>(lanes))));
+            lanes &= lanes - 1;
+        }
+    }
+#endif
+    for(; b < end; b++){
+        collisions += resolve(a, b);
+    }
+    return collisions;
+}
+
+uint32_t VerletSolver::resolve(uint32_t a, uint32_t b){
+    const float dx = sortedX[b] - sortedX[a];
+    const float dy = sortedY[b] - sortedY[a];
+    const float summed = sortedRadius[a] + sortedRadius[b];
+    const float dist2 = dx * dx + dy * dy;
+    if(dist2 >= summed * summed || dist2 <= MIN_DIST2){
+        return 0;
+    }
+    const float dist = std::sqrt(dist2);
+    const float push = (summed - dist) * stiffness / dist;
+    sortedX[a] -= dx * push;
+    sortedY[a] -= dy * push;
+    sortedX[b] += dx * push;
+    sortedY[b] += dy * push;
+    return 1;
+}
+
+void VerletSolver::applyBounds(std::span<InstanceData> circles, JobSystem& jobs){
+    jobs.parallelForRange(current.size(), BODY_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(!active[i]) continue;
+            const glm::vec2 r = glm::vec2(radius[i]);
+            current[i] = glm::clamp(current[i], minBound + r, glm::max(maxBound - r, minBound + r));
+            circles[i].position = current[i];
+            written[i] = current[i];
+        }
+    });
+}
@@ -0,0 +1,379 @@
+#include <ThING/spatial/spatialIndex.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+inline constexpr size_t REFIT_GRAIN = 0x2000;
+inline constexpr float BASE_CELL = 8.0f; // about the biggest circle the demo spawns, every level doubles it
+inline constexpr float MAX_CELL_COORD = 1e9f; // keeps the float -> int conversion defined for absurd positions
+
+static float cellSizeOf(uint32_t level){
+    return std::ldexp(BASE_CELL, static_cast<int>(level));
+}
+
+static int32_t cellCoord(float value, float cellSize){
+    return static_cast<int32_t>(std::clamp(std::floor(value / cellSize), -MAX_CELL_COORD, MAX_CELL_COORD));
+}
+
+static uint64_t cellKey(int32_t x, int32_t y){
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static float segmentDistance(glm::vec2 p, glm::vec2 a, glm::vec2 b){
+    glm::vec2 ab = b - a;
+    float len2 = glm::dot(ab, ab);
+    float t = len2 > 0.0f ? std::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+    return glm::length(p - (a + ab * t));
+}
+
+static float rectDistance(glm::vec2 p, glm::vec2 min, glm::vec2 max){
+    return glm::length(p - glm::clamp(p, min, max));
+}
+
+// Liang-Barsky clip, true when some part of the segment is inside the rect
+static bool segmentHitsRect(glm::vec2 a, glm::vec2 b, glm::vec2 min, glm::vec2 max){
+    glm::vec2 d = b - a;
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+    for(int k = 0; k < 2; k++){
+        if(std::abs(d[k]) < 1e-12f){
+            if(a[k] < min[k] || a[k] > max[k]) return false;
+            continue;
+        }
+        float ta = (min[k] - a[k]) / d[k];
+        float tb = (max[k] - a[k]) / d[k];
+        if(ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        if(t0 > t1) return false;
+    }
+    return true;
+}
+
+// Two disjoint segments are closest at an endpoint of one of them, so the rect corners and the line ends cover it
+static float segmentRectDistance(glm::vec2 a, glm::vec2 b, glm::vec2 min, glm::vec2 max){
+    if(segmentHitsRect(a, b, min, max)){
+        return 0.0f;
+    }
+    float d = std::min(rectDistance(a, min, max), rectDistance(b, min, max));
+    d = std::min(d, segmentDistance(min, a, b));
+    d = std::min(d, segmentDistance(max, a, b));
+    d = std::min(d, segmentDistance({min.x, max.y}, a, b));
+    d = std::min(d, segmentDistance({max.x, min.y}, a, b));
+    return d;
+}
+
+static float shapeDistance(InstanceType type, glm::vec2 p, glm::vec2 a, glm::vec2 b, float radius, glm::vec2 min, glm::vec2 max){
+    switch (type) {
+        case InstanceType::Circle: return std::max(glm::length(p - a) - radius, 0.0f);
+        case InstanceType::Line: return std::max(segmentDistance(p, a, b) - radius, 0.0f);
+        default: return rectDistance(p, min, max);
+    }
+}
+
+bool SpatialIndex::circleShape(const InstanceData& circle, Entry& entry){
+    if(!circle.alive) return false;
+    entry.a = circle.position;
+    entry.radius = circle.scale.x;
+    entry.min = circle.position - circle.scale.x;
+    entry.max = circle.position + circle.scale.x;
+    return true;
+}
+
+bool SpatialIndex::lineShape(const LineData& line, Entry& entry){
+    if(!line.alive) return false;
+    entry.a = line.point1;
+    entry.b = line.point2;
+    entry.radius = line.thickness * 0.5f;
+    entry.min = glm::min(line.point1, line.point2) - entry.radius;
+    entry.max = glm::max(line.point1, line.point2) + entry.radius;
+    return true;
+}
+
+// Same transform as basic.vert: scale, rotate, translate
+bool SpatialIndex::polygonShape(const InstanceData& polygon, const MeshData* mesh, std::span<const Vertex> vertices, Entry& entry){
+    if(!polygon.alive) return false;
+    entry.min = polygon.position;
+    entry.max = polygon.position;
+    if(mesh == nullptr) return true;
+    const float c = std::cos(polygon.rotation);
+    const float s = std::sin(polygon.rotation);
+    for(const Vertex& vertex : vertices.subspan(mesh->vertexOffset, mesh->vertexCount)){
+        glm::vec2 local = vertex.pos * polygon.scale;
+        glm::vec2 world = glm::vec2(c * local.x - s * local.y, s * local.x + c * local.y) + polygon.position;
+        entry.min = glm::min(entry.min, world);
+        entry.max = glm::max(entry.max, world);
+    }
+    return true;
+}
+
+void SpatialIndex::refit(std::span<const InstanceData> circles, std::span<const LineData> lines, std::span<const InstanceData> polygons,
+    std::span<const MeshData> meshes, std::span<const Vertex> vertices, JobSystem& jobs){
+    refitType(InstanceType::Circle, circles.size(), [&](size_t i, Entry& entry){
+        return circleShape(circles[i], entry);
+    }, jobs);
+    refitType(InstanceType::Line, lines.size(), [&](size_t i, Entry& entry){
+        return lineShape(lines[i], entry);
+    }, jobs);
+    refitType(InstanceType::Polygon, polygons.size(), [&](size_t i, Entry& entry){
+        return polygonShape(polygons[i], i < meshes.size() ? &meshes[i] : nullptr, vertices, entry);
+    }, jobs);
+    updateTopReach();
+}
+
+// Entities past the end of their vector (deleted by a clear since) just leave the grid
+void SpatialIndex::refit(std::span<const Entity> changed, std::span<const InstanceData> circles, std::span<const LineData> lines,
+    std::span<const InstanceData> polygons, std::span<const MeshData> meshes, std::span<const Vertex> vertices){
+    for(const Entity& e : changed){
+        switch (e.type) {
+            case InstanceType::Circle:
+                refitOne(e.type, e.index, [&](Entry& entry){
+                    return e.index < circles.size() && circleShape(circles[e.index], entry);
+                });
+                break;
+            case InstanceType::Line:
+                refitOne(e.type, e.index, [&](Entry& entry){
+                    return e.index < lines.size() && lineShape(lines[e.index], entry);
+                });
+                break;
+            case InstanceType::Polygon:
+                refitOne(e.type, e.index, [&](Entry& entry){
+                    return e.index < polygons.size()
+                        && polygonShape(polygons[e.index], e.index < meshes.size() ? &meshes[e.index] : nullptr, vertices, entry);
+                });
+                break;
+            case InstanceType::Count:
+                break;
+        }
+    }
+    updateTopReach();
+}
+
+// Writes the new bounds into entry when the shape is there and finite, and says where it belongs now
+SpatialIndex::Placement SpatialIndex::reshape(Entry& entry, bool found, const Entry& shape) const{
+    if(!found || !std::isfinite(shape.min.x) || !std::isfinite(shape.min.y) || !std::isfinite(shape.max.x) || !std::isfinite(shape.max.y)){
+        return {0, 0, false};
+    }
+    entry.min = shape.min;
+    entry.max = shape.max;
+    entry.a = shape.a;
+    entry.b = shape.b;
+    entry.radius = shape.radius;
+    return place(entry);
+}
+
+bool SpatialIndex::needsMove(const Entry& entry, const Placement& placement) const{
+    return placement.present != entry.present
+        || (placement.present && (placement.level != entry.level || placement.cell != entry.cell));
+}
+
+void SpatialIndex::move(uint32_t ref, Entry& entry, const Placement& placement){
+    if(entry.present) remove(entry);
+    entry.present = false;
+    if(placement.present) insert(ref, entry, placement);
+}
+
+// Bounds are rewritten in parallel, every job only writes its own entries. Entities that changed cell are
+// collected and moved afterwards on this thread, the cell vectors aren't touched by the jobs
+template <typename ShapeFn>
+void SpatialIndex::refitType(InstanceType type, size_t count, ShapeFn&& shapeOf, JobSystem& jobs){
+    std::vector<Entry>& table = entries[static_cast<size_t>(type)];
+    for(size_t i = count; i < table.size(); i++){
+        if(table[i].present) remove(table[i]);
+    }
+    table.resize(count, Entry{.present = false});
+    placements.resize(count);
+    moved.clear();
+
+    std::mutex movedMutex;
+    jobs.parallelForRange(count, REFIT_GRAIN, [&](size_t begin, size_t end){
+        std::vector<uint32_t> localMoved;
+        for(size_t i = begin; i < end; i++){
+            Entry& entry = table[i];
+            Entry shape = entry;
+            const bool found = shapeOf(i, shape);
+            placements[i] = reshape(entry, found, shape);
+            if(needsMove(entry, placements[i])){
+                localMoved.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        if(!localMoved.empty()){
+            std::lock_guard<std::mutex> lock(movedMutex);
+            moved.insert(moved.end(), localMoved.begin(), localMoved.end());
+        }
+    });
+
+    const uint32_t typeBits = static_cast<uint32_t>(type) << 30;
+    for(uint32_t i : moved){
+        move(typeBits | i, table[i], placements[i]);
+    }
+}
+
+template <typename ShapeFn>
+void SpatialIndex::refitOne(InstanceType type, uint32_t index, ShapeFn&& shapeOf){
+    std::vector<Entry>& table = entries[static_cast<size_t>(type)];
+    if(index >= table.size()){
+        table.resize(index + 1, Entry{.present = false});
+    }
+    Entry& entry = table[index];
+    Entry shape = entry;
+    const bool found = shapeOf(shape);
+    const Placement placement = reshape(entry, found, shape);
+    if(needsMove(entry, placement)){
+        move((static_cast<uint32_t>(type) << 30) | index, entry, placement);
+    }
+}
+
+// Only a handful of entities are ever big enough for the last level, rescanning them keeps the reach from only growing
+void SpatialIndex::updateTopReach(){
+    topReach = 0.0f;
+    for(const auto& [key, cell] : levels[SPATIAL_LEVELS - 1]){
+        for(uint32_t ref : cell){
+            const Entry& entry = entries[ref >> 30][ref & REF_INDEX_MASK];
+            const glm::vec2 half = (entry.max - entry.min) * 0.5f;
+            topReach = std::max({topReach, half.x, half.y});
+        }
+    }
+}
+
+void SpatialIndex::clear(){
+    for(std::vector<Entry>& table : entries) table.clear();
+    for(Cells& cells : levels) cells.clear();
+    levelCounts = {};
+    topReach = 0.0f;
+}
+
+SpatialIndex::Placement SpatialIndex::place(const Entry& entry) const{
+    const glm::vec2 size = entry.max - entry.min;
+    const float extent = std::max(size.x, size.y);
+    uint32_t level = 0;
+    while(level + 1 < SPATIAL_LEVELS && cellSizeOf(level) < extent){
+        level++;
+    }
+    const float cellSize = cellSizeOf(level);
+    const glm::vec2 center = (entry.min + entry.max) * 0.5f;
+    return {cellKey(cellCoord(center.x, cellSize), cellCoord(center.y, cellSize)), static_cast<uint8_t>(level), true};
+}
+
+void SpatialIndex::insert(uint32_t ref, Entry& entry, const Placement& placement){
+    std::vector<uint32_t>& cell = levels[placement.level][placement.cell];
+    entry.cell = placement.cell;
+    entry.level = placement.level;
+    entry.slot = static_cast<uint32_t>(cell.size());
+    entry.present = true;
+    cell.push_back(ref);
+    levelCounts[placement.level]++;
+}
+
+// Swap remove, the entity that takes the slot gets its slot fixed
+void SpatialIndex::remove(const Entry& entry){
+    Cells& cells = levels[entry.level];
+    auto it = cells.find(entry.cell);
+    std::vector<uint32_t>& cell = it->second;
+    const uint32_t last = cell.back();
+    cell[entry.slot] = last;
+    entryOf(last).slot = entry.slot;
+    cell.pop_back();
+    if(cell.empty()){
+        cells.erase(it); // keeps cells.size() = occupied cells, visit() relies on it for big ranges
+    }
+    levelCounts[entry.level]--;
+}
+
+// fn(type, entry) for every entity whose bounds overlap [min, max]
+template <typename Fn>
+void SpatialIndex::visit(glm::vec2 min, glm::vec2 max, Fn&& fn) const{
+    auto visitCell = [&](const std::vector<uint32_t>& cell){
+        for(uint32_t ref : cell){
+            const Entry& entry = entries[ref >> 30][ref & REF_INDEX_MASK];
+            if(entry.max.x < min.x || entry.min.x > max.x || entry.max.y < min.y || entry.min.y > max.y) continue;
+            fn(static_cast<InstanceType>(ref >> 30), ref & REF_INDEX_MASK, entry);
+        }
+    };
+
+    for(uint32_t level = 0; level < SPATIAL_LEVELS; level++){
+        if(levelCounts[level] == 0) continue;
+        const Cells& cells = levels[level];
+        const float cellSize = cellSizeOf(level);
+        const float reach = level == SPATIAL_LEVELS - 1 ? std::max(cellSize * 0.5f, topReach) : cellSize * 0.5f;
+        const int32_t x0 = cellCoord(min.x - reach, cellSize);
+        const int32_t y0 = cellCoord(min.y - reach, cellSize);
+        const int32_t x1 = cellCoord(max.x + reach, cellSize);
+        const int32_t y1 = cellCoord(max.y + reach, cellSize);
+
+        // Huge ranges (zoomed out rects, nearest far from everything) walk the occupied cells instead
+        const double rangeCells = (static_cast<double>(x1) - x0 + 1) * (static_cast<double>(y1) - y0 + 1);
+        if(rangeCells > static_cast<double>(cells.size())){
+            for(const auto& [key, cell] : cells){
+                const int32_t x = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+                const int32_t y = static_cast<int32_t>(static_cast<uint32_t>(key));
+                if(x < x0 || x > x1 || y < y0 || y > y1) continue;
+                visitCell(cell);
+            }
+            continue;
+        }
+        for(int32_t y = y0; y <= y1; y++){
+            for(int32_t x = x0; x <= x1; x++){
+                auto it = cells.find(cellKey(x, y));
+                if(it != cells.end()) visitCell(it->second);
+            }
+        }
+    }
+}
+
+void SpatialIndex::queryPoint(glm::vec2 point, std::vector<Entity>& out) const{
+    visit(point, point, [&](InstanceType type, uint32_t index, const Entry& entry){
+        if(shapeDistance(type, point, entry.a, entry.b, entry.radius, entry.min, entry.max) <= 0.0f){
+            out.push_back({index, type});
+        }
+    });
+}
+
+void SpatialIndex::queryRect(glm::vec2 min, glm::vec2 max, std::vector<Entity>& out) const{
+    visit(min, max, [&](InstanceType type, uint32_t index, const Entry& entry){
+        bool hit = true; // polygons, the bounds already overlap
+        if(type == InstanceType::Circle){
+            hit = rectDistance(entry.a, min, max) <= entry.radius;
+        } else if(type == InstanceType::Line){
+            hit = segmentRectDistance(entry.a, entry.b, min, max) <= entry.radius;
+        }
+        if(hit) out.push_back({index, type});
+    });
+}
+
+void SpatialIndex::queryRadius(glm::vec2 center, float radius, std::vector<Entity>& out) const{
+    visit(center - radius, center + radius, [&](InstanceType type, uint32_t index, const Entry& entry){
+        if(shapeDistance(type, center, entry.a, entry.b, entry.radius, entry.min, entry.max) <= radius){
+            out.push_back({index, type});
+        }
+    });
+}
+
+// Growing radius search, anything within r of the point overlaps the r box so the first hit inside r is final
+Entity SpatialIndex::nearest(glm::vec2 point, float maxDistance) const{
+    bool empty = true;
+    for(uint32_t count : levelCounts) empty = empty && count == 0;
+    if(empty || !(maxDistance >= 0.0f)){
+        return INVALID_ENTITY;
+    }
+
+    float range = std::min(BASE_CELL, maxDistance);
+    while(true){
+        Entity best = INVALID_ENTITY;
+        float bestDistance = std::numeric_limits<float>::max();
+        visit(point - range, point + range, [&](InstanceType type, uint32_t index, const Entry& entry){
+            float distance = shapeDistance(type, point, entry.a, entry.b, entry.radius, entry.min, entry.max);
+            if(distance < bestDistance){
+                bestDistance = distance;
+                best = {index, type};
+            }
+        });
+        if(bestDistance <= range){
+            return best;
+        }
+        if(range >= maxDistance){
+            return INVALID_ENTITY;
+        }
+        range = std::min(range * 4.0f, maxDistance);
+    }
+}
@@ -0,0 +1,229 @@
+#include <ThING/text/font.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Strokes of every glyph from ' ' to '~', split by spaces, each one a polyline of two digit points. First digit x
+// from 0 to 4, second y from 0 to 8 with the baseline at 2, x-height at 6 and capitals at 8. One point is a dot
+static constexpr std::array<const char*, FONT_GLYPH_COUNT> STROKES = {
+    "",                                     // space
+    "2824 22",                              // !
+    "1817 3837",                            // "
+    "1218 3238 0444 0646",                  // #
+    "473818070615354443321203 2822",        // $
+    "0248 17 33",                           // %
+    "420607182837260403122244",             // &
+    "2827",                                 // '
+    "38262432",                             // (
+    "18262412",                             // )
+    "2723 0644 0446",                       // *
+    "2723 0545",                            // +
+    "2211",                                 // ,
+    "0545",                                 // -
+    "22",                                   // .
+    "0248",                                 // /
+    "183847433212030718 0347",              // 0
+    "072822 0242",                          // 1
+    "07183847460242",                       // 2
+    "07183847463515 354443321203",          // 3
+    "32380444",                             // 4
+    "480805354443321203",                   // 5
+    "473818070312324344351504",             // 6
+    "084812",                               // 7
+    "15060718384746351504031232434435",     // 8
+    "031232434738180706153546",             // 9
+    "26 23",                                // :
+    "26 2312",                              // ;
+    "470543",                               // <
+    "0646 0444",                            // =
+    "074503",                               // >
+    "07183847462524 22",                    // ?
+    "36261514233336 334447381807031232",    // @
+    "0206284642 0545",                      // A
+    "02083847463505 3544433202",            // B
+    "4738180703123243",                     // C
+    "02082846442202",                       // D
+    "48080242 0535",                        // E
+    "480802 0535",                          // F
+    "47381807031232434525",                 // G
+    "0208 4248 0545",                       // H
+    "1838 2822 1232",                       // I
+    "4843321203",                           // J
+    "0208 4804 1542",                       // K
+    "080242",                               // L
+    "0208254842",                           // M
+    "02084248",                             // N
+    "183847433212030718",                   // O
+    "02083847463505",                       // P
+    "183847433212030718 2441",              // Q
+    "02083847463505 2542",                  // R
+    "473818070615354443321203",             // S
+    "0848 2822",                            // T
+    "080312324348",                         // U
+    "082248",                               // V
+    "0812253248",                           // W
+    "0842 0248",                            // X
+    "082548 2522",                          // Y
+    "08480242",                             // Z
+    "38181232",                             // [
+    "0842",                                 // backslash
+    "18383212",                             // ]
+    "062846",                               // ^
+    "0141",                                 // _
+    "1827",                                 // `
+    "16364542 441403123243",                // a
+    "08023243453606",                       // b
+    "461605031242",                         // c
+    "48421203051646",                       // d
+    "044445361605031242",                   // e
+    "48281712 0636",                        // f
+    "46413010 461605031242",                // g
+    "0802 0516364542",                      // h
+    "2622 28",                              // i
+    "36312010 38",                          // j
+    "0802 3603 1442",                       // k
+    "182822 1232",                          // l
+    "0602 05162522 25364542",               // m
+    "0602 0516364542",                      // n
+    "163645433212030516",                   // o
+    "0600 05163645433202",                  // p
+    "4640 45361605031242",                  // q
+    "0602 042646",                          // r
+    "4616051434433202",                     // s
+    "18132242 0636",                        // t
+    "0603123243 4642",                      // u
+    "062246",                               // v
+    "0612243246",                           // w
+    "0642 0246",                            // x
+    "0622 4610",                            // y
+    "06460242",                             // z
+    "38272615242332",                       // {
+    "2820",                                 // |
+    "18272635242312",                       // }
+    "05163445",                             // ~
+};
+
+static constexpr float UNITS_PER_EM = 8.0f; // stroke grid units
+static constexpr float STROKE_RADIUS = 0.5f; // units
+static constexpr float FIELD_SPREAD = 2.0f; // units of distance from 0 to 1 in the field
+
+struct Segment{
+    glm::vec2 a;
+    glm::vec2 b;
+};
+
+// Glyph space in units, y down from the top of the capitals like the em space
+static std::vector<Segment> parseStrokes(const char* strokes){
+    std::vector<Segment> segments;
+    glm::vec2 last;
+    bool first = true;
+    for(const char* p = strokes; *p; ){
+        if(*p == ' '){
+            first = true;
+            p++;
+            continue;
+        }
+        const glm::vec2 point(1.0f + static_cast<float>(p[0] - '0'), 8.0f - static_cast<float>(p[1] - '0'));
+        const bool alone = first && (p[2] == '\0' || p[2] == ' ');
+        if(alone){
+            segments.push_back({point, point});
+        } else if(!first){
+            segments.push_back({last, point});
+        }
+        last = point;
+        first = false;
+        p += 2;
+    }
+    return segments;
+}
+
+static float segmentDistance(glm::vec2 p, const Segment& s){
+    const glm::vec2 ab = s.b - s.a;
+    const float length2 = glm::dot(ab, ab);
+    const float t = length2 > 0.0f ? std::clamp(glm::dot(p - s.a, ab) / length2, 0.0f, 1.0f) : 0.0f;
+    return glm::length(p - (s.a + ab * t));
+}
+
+std::vector<uint8_t> buildGlyphAtlas(){
+    std::vector<uint8_t> atlas(static_cast<size_t>(FONT_ATLAS_WIDTH) * FONT_ATLAS_HEIGHT, 0);
+    const float unitsPerPixel = UNITS_PER_EM / FONT_PIXELS_PER_EM;
+    for(uint32_t glyph = 0; glyph < FONT_GLYPH_COUNT; glyph++){
+        const std::vector<Segment> segments = parseStrokes(STROKES[glyph]);
+        if(segments.empty()){
+            continue;
+        }
+        const uint32_t cellX = (glyph % FONT_ATLAS_COLUMNS) * FONT_CELL_WIDTH;
+        const uint32_t cellY = (glyph / FONT_ATLAS_COLUMNS) * FONT_CELL_HEIGHT;
+        for(uint32_t y = 0; y < FONT_CELL_HEIGHT; y++){
+            for(uint32_t x = 0; x < FONT_CELL_WIDTH; x++){
+                const glm::vec2 p = glm::vec2(FONT_CELL_LEFT, FONT_CELL_TOP) * UNITS_PER_EM +
+                    (glm::vec2(static_cast<float>(x), static_cast<float>(y)) + 0.5f) * unitsPerPixel;
+                float distance = UNITS_PER_EM;
+                for(const Segment& segment : segments){
+                    distance = std::min(distance, segmentDistance(p, segment));
+                }
+                const float value = std::clamp(0.5f - (distance - STROKE_RADIUS) / FIELD_SPREAD, 0.0f, 1.0f);
+                atlas[static_cast<size_t>(cellY + y) * FONT_ATLAS_WIDTH + cellX + x] = static_cast<uint8_t>(std::lround(value * 255.0f));
+            }
+        }
+    }
+    return atlas;
+}
+
+static uint32_t glyphOf(char c){
+    const uint8_t code = static_cast<uint8_t>(c);
+    return (code >= FONT_FIRST_CHAR && code < FONT_FIRST_CHAR + FONT_GLYPH_COUNT) ? code - FONT_FIRST_CHAR : '?' - FONT_FIRST_CHAR;
+}
+
+static bool isBlank(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+uint32_t countGlyphs(std::string_view text){
+    uint32_t count = 0;
+    for(char c : text){
+        if(!isBlank(c) && c != '\n'){
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t layoutText(std::string_view text, glm::vec2 pivot, uint32_t textIndex, std::span<GlyphData> dst){
+    // Lines line up on the pivot too, so a centred label is centred line by line
+    uint32_t lines = 1;
+    for(char c : text){
+        lines += c == '\n' ? 1 : 0;
+    }
+    const float height = static_cast<float>(lines - 1) * FONT_LINE_HEIGHT + FONT_CAP_HEIGHT;
+    const float top = -pivot.y * height;
+
+    uint32_t written = 0;
+    uint32_t line = 0;
+    size_t begin = 0;
+    while(begin <= text.size() && written < dst.size()){
+        size_t end = text.find('\n', begin);
+        if(end == std::string_view::npos){
+            end = text.size();
+        }
+        const std::string_view row = text.substr(begin, end - begin);
+        const size_t length = static_cast<size_t>(std::count_if(row.begin(), row.end(), [](char c){return c != '\r';}));
+        float x = -static_cast<float>(length) * FONT_ADVANCE * pivot.x;
+        const float y = top + static_cast<float>(line) * FONT_LINE_HEIGHT;
+        for(char c : row){
+            if(c == '\r'){
+                continue;
+            }
+            if(!isBlank(c)){
+                if(written == dst.size()){
+                    break;
+                }
+                dst[written++] = {{x, y}, glyphOf(c), textIndex};
+            }
+            x += FONT_ADVANCE;
+        }
+        line++;
+        begin = end + 1;
+    }
+    return written;
+}
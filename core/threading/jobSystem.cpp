@@ -0,0 +1,172 @@
+#include <ThING/threading/jobSystem.h>
+#include <cassert>
+#include <utility>
+
+namespace {
+    // Which queue belongs to the current thread, -1 for threads outside of the pool
+    thread_local const JobSystem* currentSystem = nullptr;
+    thread_local int32_t currentWorker = -1;
+}
+
+JobSystem::JobSystem(uint32_t workerCount){
+    if(workerCount == 0){
+        const uint32_t cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1;
+    }
+    queues.reserve(workerCount);
+    for(uint32_t i = 0; i < workerCount; i++){
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers.reserve(workerCount);
+    for(uint32_t i = 0; i < workerCount; i++){
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem(){
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    sleepCondition.notify_all();
+    for(std::thread& worker : workers){
+        worker.join();
+    }
+}
+
+void JobSystem::submit(Job job, JobCounter* counter){
+    if(counter){
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Workers keep what they spawn (good for nested parallelFor), outside threads spread round robin
+    uint32_t queueIndex;
+    if(currentSystem == this){
+        queueIndex = static_cast<uint32_t>(currentWorker);
+    } else {
+        queueIndex = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->jobs.push_back({std::move(job), counter});
+    }
+    queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex); // no lost wake up between the check and the sleep
+    }
+    sleepCondition.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter){
+    while(!counter.done()){
+        if(!tryRunOne()){
+            std::this_thread::yield();
+        }
+    }
+    if(counter.failed.load(std::memory_order_relaxed)){
+        std::exception_ptr error = std::exchange(counter.error, nullptr);
+        counter.failed.store(false, std::memory_order_relaxed); // the counter can be reused
+        std::rethrow_exception(error);
+    }
+}
+
+bool JobSystem::tryRunOne(){
+    if(queuedJobs.load(std::memory_order_acquire) == 0){
+        return false;
+    }
+    const uint32_t queueCount = static_cast<uint32_t>(queues.size());
+    const bool isWorker = currentSystem == this;
+    const uint32_t self = isWorker ? static_cast<uint32_t>(currentWorker) : 0;
+
+    QueuedJob queued;
+    bool found = false;
+    if(isWorker){
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if(!queues[self]->jobs.empty()){
+            queued = std::move(queues[self]->jobs.back());
+            queues[self]->jobs.pop_back();
+            found = true;
+        }
+    }
+    for(uint32_t i = isWorker ? 1 : 0; !found && i < queueCount; i++){
+        WorkerQueue& victim = *queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.jobs.empty()){
+            queued = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+    if(!found){
+        return false;
+    }
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    if(!queued.counter){
+        queued.job();
+        return true;
+    }
+    try {
+        queued.job();
+    } catch (...) {
+        if(!queued.counter->failed.exchange(true, std::memory_order_relaxed)){
+            queued.counter->error = std::current_exception();
+        }
+    }
+    queued.counter->pending.fetch_sub(1, std::memory_order_release); // whatever happened, or wait() never returns
+    return true;
+}
+
+void JobSystem::workerLoop(uint32_t index){
+    currentSystem = this;
+    currentWorker = static_cast<int32_t>(index);
+    while(true){
+        if(tryRunOne()){
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]{
+            return !running || queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        if(!running){
+            return;
+        }
+    }
+}
+
+TaskGraph::TaskId TaskGraph::addTask(std::function<void()> fn){
+    Task& task = tasks.emplace_back();
+    task.fn = std::move(fn);
+    return static_cast<TaskId>(tasks.size() - 1);
+}
+
+void TaskGraph::precede(TaskId before, TaskId after){
+    assert(before < tasks.size() && after < tasks.size() && "Invalid TaskId passed to precede");
+    tasks[before].successors.push_back(after);
+    tasks[after].dependencies++;
+}
+
+void TaskGraph::run(JobSystem& jobs){
+    for(Task& task : tasks){
+        task.remaining.store(task.dependencies, std::memory_order_relaxed);
+    }
+    JobCounter counter;
+    for(TaskId id = 0; id < tasks.size(); id++){
+        if(tasks[id].dependencies == 0){
+            schedule(jobs, id, counter);
+        }
+    }
+    // Successors are submitted before their parent's job counts as finished, so the counter can't hit 0 early
+    jobs.wait(counter);
+}
+
+void TaskGraph::schedule(JobSystem& jobs, TaskId id, JobCounter& counter){
+    jobs.submit([this, &jobs, &counter, id]{
+        Task& task = tasks[id];
+        task.fn();
+        for(TaskId next : task.successors){
+            if(tasks[next].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1){
+                schedule(jobs, next, counter);
+            }
+        }
+    }, &counter);
+}
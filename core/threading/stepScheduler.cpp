@@ -0,0 +1,131 @@
+#include <ThING/threading/stepScheduler.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iterator>
+
+inline constexpr uint64_t MAX_CLOCK_STRIDE = 0x1000; // steps between two clock reads at most
+
+uint64_t StepScheduler::add(ThING::StepTask task){
+    if(task.done()){
+        return 0;
+    }
+    const uint64_t id = nextId++;
+    (running ? started : tasks).push_back({id, std::move(task)});
+    return id;
+}
+
+bool StepScheduler::cancel(uint64_t id){
+    auto byId = [id](const Entry& entry){return entry.id == id && !entry.cancelled;};
+    auto late = std::find_if(started.begin(), started.end(), byId);
+    if(late != started.end()){
+        started.erase(late); // never resumed, nothing of it is on the stack
+        return true;
+    }
+    auto it = std::find_if(tasks.begin(), tasks.end(), byId);
+    if(it == tasks.end()){
+        return false;
+    }
+    if(running){
+        it->cancelled = true;
+        return true;
+    }
+    const size_t index = static_cast<size_t>(it - tasks.begin());
+    tasks.erase(it); // destroys the coroutine frame, locals of the task get their destructors
+    if(cursor > index){
+        cursor--;
+    }
+    return true;
+}
+
+bool StepScheduler::isRunning(uint64_t id) const{
+    auto byId = [id](const Entry& entry){return entry.id == id && !entry.cancelled;};
+    return std::any_of(tasks.begin(), tasks.end(), byId) || std::any_of(started.begin(), started.end(), byId);
+}
+
+void StepScheduler::clear(){
+    started.clear();
+    if(running){
+        for(Entry& entry : tasks){
+            entry.cancelled = true;
+        }
+        return;
+    }
+    tasks.clear();
+    cursor = 0;
+}
+
+// Applies what tasks asked for during run(), nothing is being resumed anymore
+void StepScheduler::settle(){
+    running = false;
+    size_t kept = 0;
+    size_t removedBeforeCursor = 0;
+    for(size_t i = 0; i < tasks.size(); i++){
+        if(tasks[i].cancelled){
+            removedBeforeCursor += i < cursor;
+            continue;
+        }
+        if(kept != i){
+            tasks[kept] = std::move(tasks[i]);
+        }
+        kept++;
+    }
+    tasks.erase(tasks.begin() + kept, tasks.end());
+    cursor -= removedBeforeCursor;
+    std::move(started.begin(), started.end(), std::back_inserter(tasks));
+    started.clear();
+}
+
+void StepScheduler::run(){
+    using clock = std::chrono::steady_clock;
+    lastSteps = 0;
+    if(tasks.empty()){
+        return;
+    }
+    const clock::time_point start = clock::now();
+    const clock::time_point deadline = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<float, std::milli>(budget));
+
+    uint64_t steps = 0;
+    uint64_t nextCheck = 1;
+    running = true;
+    while(!tasks.empty()){
+        if(cursor >= tasks.size()){
+            cursor = 0;
+        }
+        Entry& entry = tasks[cursor];
+        if(entry.cancelled){
+            tasks.erase(tasks.begin() + cursor); // stopped by another task, suspended so it can go now
+            continue;
+        }
+        const bool resumed = entry.task.resume();
+        steps++;
+        if(resumed && !entry.cancelled){
+            cursor++;
+        } else {
+            const std::exception_ptr error = resumed ? nullptr : entry.task.error();
+            tasks.erase(tasks.begin() + cursor);
+            if(error){
+                lastSteps = steps;
+                settle();
+                std::rethrow_exception(error);
+            }
+        }
+        if(stepLimit > 0 && steps >= stepLimit){
+            break;
+        }
+        if(steps >= nextCheck){
+            const clock::time_point now = clock::now();
+            if(now >= deadline){
+                break;
+            }
+            // Next read once about half of what is left should be gone at the average step cost so far, tiny steps
+            // barely read the clock and slow ones can't overshoot the budget by much
+            const double perStep = std::chrono::duration<double>(now - start).count() / static_cast<double>(steps);
+            const double left = std::chrono::duration<double>(deadline - now).count();
+            const double stride = std::clamp(left * 0.5 / std::max(perStep, 1e-9), 1.0, static_cast<double>(MAX_CLOCK_STRIDE));
+            nextCheck = steps + static_cast<uint64_t>(stride);
+        }
+    }
+    lastSteps = steps;
+    settle();
+}
@@ -0,0 +1,165 @@
+#include "ThING/consts.h"
+#include "ThING/extras/handMade.h"
+#include "ThING/types/sceneFile.h"
+#include <ThING/timeline/sceneFile.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+static uint64_t alignUp(uint64_t value){
+    return (value + SCENE_FILE_ALIGNMENT - 1) & ~(SCENE_FILE_ALIGNMENT - 1);
+}
+
+static void pad(std::ofstream& file, uint64_t from, uint64_t to){
+    static const std::array<char, SCENE_FILE_ALIGNMENT> zeros{};
+    file.write(zeros.data(), static_cast<std::streamsize>(to - from));
+}
+
+// Tween slots only mean something to the session that handed them out, staged so the scene itself isn't written
+static void writeInstances(std::ofstream& file, std::span<const InstanceData> instances){
+    constexpr size_t STAGE = 0x1000;
+    std::vector<InstanceData> staged;
+    staged.reserve(std::min(instances.size(), STAGE));
+    for(size_t begin = 0; begin < instances.size(); begin += STAGE){
+        const size_t end = std::min(begin + STAGE, instances.size());
+        staged.assign(instances.begin() + begin, instances.begin() + end);
+        for(InstanceData& instance : staged){
+            instance.tweenSlot = 0;
+        }
+        file.write(reinterpret_cast<const char*>(staged.data()), static_cast<std::streamsize>(staged.size() * sizeof(InstanceData)));
+    }
+}
+
+bool saveSceneFile(const std::string& path, const TimelineScene& scene){
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file){
+        return false;
+    }
+    const std::array<size_t, static_cast<size_t>(TimelineStream::Count)> counts = {
+        scene.circles.size(), scene.lines.size(), scene.polygons.size(), scene.edges.size(),
+        scene.meshes.size(), scene.vertices.size(), scene.indices.size()
+    };
+    SceneFileHeader header;
+    uint64_t offset = SCENE_FILE_ALIGNMENT;
+    for(size_t stream = 0; stream < counts.size(); stream++){
+        header.sections[stream] = {offset, counts[stream]};
+        offset = alignUp(offset + counts[stream] * TIMELINE_STRIDES[stream]);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad(file, sizeof(header), SCENE_FILE_ALIGNMENT);
+
+    auto writeRaw = [&file](const void* data, size_t bytes){
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    };
+    for(size_t stream = 0; stream < counts.size(); stream++){
+        const size_t bytes = counts[stream] * TIMELINE_STRIDES[stream];
+        switch (static_cast<TimelineStream>(stream)) {
+            case TimelineStream::Circles: writeInstances(file, scene.circles); break;
+            case TimelineStream::Lines: writeInstances(file, scene.lines); break;
+            case TimelineStream::Polygons: writeInstances(file, scene.polygons); break;
+            case TimelineStream::Edges: writeRaw(scene.edges.data(), bytes); break;
+            case TimelineStream::Meshes: writeRaw(scene.meshes.data(), bytes); break;
+            case TimelineStream::Vertices: writeRaw(scene.vertices.data(), bytes); break;
+            case TimelineStream::Indices: writeRaw(scene.indices.data(), bytes); break;
+            case TimelineStream::Count: break;
+        }
+        const uint64_t end = header.sections[stream].offset + bytes;
+        if(stream + 1 < counts.size()){
+            pad(file, end, header.sections[stream + 1].offset);
+        }
+    }
+    file.flush();
+    return file.good();
+}
+
+// Straight from the mapping into the vector, the jobs fault their pages in at the same time
+template <typename T>
+static void copyStream(std::vector<T>& out, const std::byte* data, size_t count, JobSystem& jobs){
+    if constexpr (std::is_default_constructible_v<T>){
+        out.resize(count);
+    } else {
+        out.resize(count, T(0, 0, 0, 0, 0)); // MeshData, overwritten right below
+    }
+    std::byte* bytes = reinterpret_cast<std::byte*>(out.data());
+    jobs.parallelForRange(count * sizeof(T), SCENE_LOAD_GRAIN, [&](size_t begin, size_t end){
+        std::memcpy(bytes + begin, data + begin, end - begin);
+    });
+}
+
+// Checked on the mapping before anything is copied, so a bad file leaves the scene as it was
+template <typename T, typename Fn>
+static bool validStream(const std::byte* data, size_t count, JobSystem& jobs, Fn&& valid){
+    std::atomic<bool> ok = true;
+    jobs.parallelForRange(count, SCENE_VALIDATE_GRAIN, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end && ok.load(std::memory_order_relaxed); i++){
+            std::array<std::byte, sizeof(T)> raw;
+            std::memcpy(raw.data(), data + i * sizeof(T), sizeof(T));
+            if(!valid(std::bit_cast<T>(raw))){
+                ok.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+    return ok;
+}
+
+bool loadSceneFile(const std::string& path, const TimelineTarget& target, JobSystem& jobs){
+    osd::MappedFile file;
+    if(!file.open(path)){
+        return false;
+    }
+    const std::span<const std::byte> data = file.view();
+    SceneFileHeader header;
+    if(data.size() < sizeof(header)){
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if(header.magic != SCENE_FILE_MAGIC || header.version != SCENE_FILE_VERSION ||
+        header.streamCount != static_cast<uint32_t>(TimelineStream::Count) || header.strides != TIMELINE_STRIDES){
+        return false;
+    }
+    for(size_t stream = 0; stream < header.sections.size(); stream++){
+        const SceneFileSection& section = header.sections[stream];
+        if(section.offset > data.size() || section.count > (data.size() - section.offset) / TIMELINE_STRIDES[stream]){
+            return false; // cut short, nothing gets loaded
+        }
+    }
+    auto sectionOf = [&](TimelineStream stream) -> const SceneFileSection& {return header.sections[static_cast<size_t>(stream)];};
+    const uint64_t circles = sectionOf(TimelineStream::Circles).count;
+    const uint64_t polygons = sectionOf(TimelineStream::Polygons).count;
+    if(circles + sectionOf(TimelineStream::Lines).count + polygons > MAX_INSTANCED_OBJECTS / sizeof(InstanceData)){
+        return false; // more than one instance buffer holds
+    }
+    const uint64_t vertices = sectionOf(TimelineStream::Vertices).count;
+    const uint64_t indices = sectionOf(TimelineStream::Indices).count;
+    // Meshes index straight into the vertex and index pools and the polygons, edges into the circles
+    const bool meshesValid = validStream<MeshData>(data.data() + sectionOf(TimelineStream::Meshes).offset,
+        sectionOf(TimelineStream::Meshes).count, jobs, [&](const MeshData& mesh){
+            return static_cast<uint64_t>(mesh.vertexOffset) + mesh.vertexCount <= vertices &&
+                static_cast<uint64_t>(mesh.indexOffset) + mesh.indexCount <= indices && mesh.instanceIndex < polygons;
+        });
+    const bool edgesValid = validStream<EdgeData>(data.data() + sectionOf(TimelineStream::Edges).offset,
+        sectionOf(TimelineStream::Edges).count, jobs, [&](const EdgeData& edge){
+            return (edge.from < circles && edge.to < circles) || (edge.from == DEAD_EDGE_NODE && edge.to == DEAD_EDGE_NODE);
+        });
+    if(!meshesValid || !edgesValid){
+        return false;
+    }
+
+    auto copyOne = [&](TimelineStream stream, auto& out){
+        const SceneFileSection& section = header.sections[static_cast<size_t>(stream)];
+        copyStream(out, data.data() + section.offset, section.count, jobs);
+    };
+    copyOne(TimelineStream::Circles, target.circles);
+    copyOne(TimelineStream::Lines, target.lines);
+    copyOne(TimelineStream::Polygons, target.polygons);
+    copyOne(TimelineStream::Edges, target.edges);
+    copyOne(TimelineStream::Meshes, target.meshes);
+    copyOne(TimelineStream::Vertices, target.vertices);
+    copyOne(TimelineStream::Indices, target.indices);
+    return true;
+}
@@ -0,0 +1,158 @@
+#include <ThING/timeline/snapshotStore.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+static size_t chunkElements(TimelineStream stream){
+    return std::max<size_t>(SNAPSHOT_CHUNK_BYTES / TIMELINE_STRIDES[static_cast<size_t>(stream)], 1);
+}
+
+uint64_t SnapshotStore::take(const TimelineScene& scene, JobSystem& jobs){
+    takeStream(TimelineStream::Circles, reinterpret_cast<const std::byte*>(scene.circles.data()), scene.circles.size(), jobs);
+    takeStream(TimelineStream::Lines, reinterpret_cast<const std::byte*>(scene.lines.data()), scene.lines.size(), jobs);
+    takeStream(TimelineStream::Polygons, reinterpret_cast<const std::byte*>(scene.polygons.data()), scene.polygons.size(), jobs);
+    takeStream(TimelineStream::Edges, reinterpret_cast<const std::byte*>(scene.edges.data()), scene.edges.size(), jobs);
+    takeStream(TimelineStream::Meshes, reinterpret_cast<const std::byte*>(scene.meshes.data()), scene.meshes.size(), jobs);
+    takeStream(TimelineStream::Vertices, reinterpret_cast<const std::byte*>(scene.vertices.data()), scene.vertices.size(), jobs);
+    takeStream(TimelineStream::Indices, reinterpret_cast<const std::byte*>(scene.indices.data()), scene.indices.size(), jobs);
+
+    Snapshot& snapshot = snapshots.emplace_back();
+    snapshot.id = nextId++;
+    for(size_t stream = 0; stream < STREAM_COUNT; stream++){
+        snapshot.chunks[stream] = streams[stream].base; // pointer copies, the bytes are shared
+        size_t bytes = 0;
+        for(const Chunk& chunk : streams[stream].base){
+            bytes += chunk->size();
+        }
+        snapshot.counts[stream] = bytes / TIMELINE_STRIDES[stream];
+    }
+    evict();
+    return snapshot.id;
+}
+
+void SnapshotStore::takeStream(TimelineStream stream, const std::byte* data, size_t count, JobSystem& jobs){
+    Stream& state = streams[static_cast<size_t>(stream)];
+    const size_t stride = TIMELINE_STRIDES[static_cast<size_t>(stream)];
+    const size_t perChunk = chunkElements(stream);
+    const size_t chunks = (count + perChunk - 1) / perChunk;
+
+    ChunkList next(chunks);
+    // Chunks nobody wrote are shared as they are, written ones are only copied when they really differ
+    jobs.parallelForRange(chunks, 16, [&](size_t begin, size_t end){
+        for(size_t chunk = begin; chunk < end; chunk++){
+            const size_t first = chunk * perChunk;
+            const size_t size = (std::min(first + perChunk, count) - first) * stride;
+            const std::byte* bytes = data + first * stride;
+            if(chunk < state.base.size() && state.base[chunk]->size() == size){
+                const bool written = state.allDirty || (chunk < state.dirty.size() && state.dirty[chunk]);
+                if(!written || std::memcmp(state.base[chunk]->data(), bytes, size) == 0){
+                    next[chunk] = state.base[chunk];
+                    continue;
+                }
+            }
+            next[chunk] = makeChunk(bytes, size);
+        }
+    });
+    state.base = std::move(next);
+    state.dirty.assign(state.dirty.size(), 0);
+    state.allDirty = false;
+}
+
+template <typename T>
+void SnapshotStore::restoreStream(TimelineStream stream, std::vector<T>& out, const ChunkList& chunks, size_t count){
+    static_assert(std::is_trivially_copyable_v<T>, "chunks are copied back as bytes");
+    Stream& state = streams[static_cast<size_t>(stream)];
+    const size_t liveBytes = out.size() * sizeof(T); // past it the vector holds nothing of the base
+    if constexpr (std::is_default_constructible_v<T>){
+        out.resize(count);
+    } else {
+        out.resize(count, T(0, 0, 0, 0, 0)); // MeshData, every element gets overwritten right below
+    }
+    std::byte* bytes = reinterpret_cast<std::byte*>(out.data());
+    size_t offset = 0;
+    for(size_t chunk = 0; chunk < chunks.size(); chunk++){
+        const size_t size = chunks[chunk]->size();
+        const bool same = !state.allDirty && offset + size <= liveBytes && chunk < state.base.size() &&
+            state.base[chunk] == chunks[chunk] && !(chunk < state.dirty.size() && state.dirty[chunk]);
+        if(!same){
+            std::memcpy(bytes + offset, chunks[chunk]->data(), size);
+        }
+        offset += size;
+    }
+    state.base = chunks;
+    state.dirty.assign(state.dirty.size(), 0);
+    state.allDirty = false;
+}
+
+bool SnapshotStore::restore(uint64_t id, const TimelineTarget& target){
+    auto it = std::find_if(snapshots.begin(), snapshots.end(), [id](const Snapshot& snapshot){return snapshot.id == id;});
+    if(it == snapshots.end()){
+        return false;
+    }
+    auto restoreOne = [&](TimelineStream stream, auto& out){
+        const size_t index = static_cast<size_t>(stream);
+        restoreStream(stream, out, it->chunks[index], it->counts[index]);
+    };
+    restoreOne(TimelineStream::Circles, target.circles);
+    restoreOne(TimelineStream::Lines, target.lines);
+    restoreOne(TimelineStream::Polygons, target.polygons);
+    restoreOne(TimelineStream::Edges, target.edges);
+    restoreOne(TimelineStream::Meshes, target.meshes);
+    restoreOne(TimelineStream::Vertices, target.vertices);
+    restoreOne(TimelineStream::Indices, target.indices);
+    return true;
+}
+
+bool SnapshotStore::drop(uint64_t id){
+    auto it = std::find_if(snapshots.begin(), snapshots.end(), [id](const Snapshot& snapshot){return snapshot.id == id;});
+    if(it == snapshots.end()){
+        return false;
+    }
+    snapshots.erase(it);
+    return true;
+}
+
+void SnapshotStore::clear(){
+    snapshots.clear();
+    for(Stream& stream : streams){
+        stream = {}; // the next take copies everything again
+    }
+}
+
+void SnapshotStore::markDirty(TimelineStream stream, size_t index){
+    Stream& state = streams[static_cast<size_t>(stream)];
+    const size_t chunk = index / chunkElements(stream);
+    if(chunk >= state.dirty.size()){
+        state.dirty.resize(chunk + 1, 0);
+    }
+    state.dirty[chunk] = 1;
+}
+
+void SnapshotStore::markAllDirty(){
+    for(Stream& stream : streams){
+        stream.allDirty = true;
+    }
+}
+
+void SnapshotStore::setBudget(size_t bytes){
+    budget = bytes;
+    evict();
+}
+
+bool SnapshotStore::contains(uint64_t id) const{
+    return std::any_of(snapshots.begin(), snapshots.end(), [id](const Snapshot& snapshot){return snapshot.id == id;});
+}
+
+SnapshotStore::Chunk SnapshotStore::makeChunk(const std::byte* data, size_t size){
+    memory.fetch_add(size, std::memory_order_relaxed);
+    return Chunk(new std::vector<std::byte>(data, data + size), [this](const std::vector<std::byte>* chunk){
+        memory.fetch_sub(chunk->size(), std::memory_order_relaxed);
+        delete chunk;
+    });
+}
+
+void SnapshotStore::evict(){
+    while(memory.load(std::memory_order_relaxed) > budget && snapshots.size() > 1){
+        snapshots.pop_front();
+    }
+}
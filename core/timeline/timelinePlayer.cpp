@@ -0,0 +1,210 @@
+#include <ThING/timeline/timelinePlayer.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+static T load(const std::byte* data){
+    std::array<std::byte, sizeof(T)> raw;
+    std::memcpy(raw.data(), data, sizeof(T));
+    T value = std::bit_cast<T>(raw); // file data is unaligned
+    if constexpr (requires(T& t){t.tweenSlot;}){
+        value.tweenSlot = 0; // slots of the recording session mean nothing here
+    }
+    return value;
+}
+
+// Full sections replace the vector, sparse ones overwrite their slots and append the ones past the end in order
+template <typename T>
+static bool applySection(std::vector<T>& out, const TimelineSection& section, const std::byte*& cursor, const std::byte* end){
+    const size_t available = static_cast<size_t>(end - cursor);
+    const size_t count = section.count;
+    if(section.type == TimelineSectionType::Full){
+        if(count != section.total || available / sizeof(T) < count){
+            return false;
+        }
+        if constexpr (std::is_default_constructible_v<T>){
+            out.resize(count);
+            if(count > 0){
+                std::memcpy(out.data(), cursor, count * sizeof(T));
+            }
+            if constexpr (requires(T& t){t.tweenSlot;}){
+                for(T& value : out){
+                    value.tweenSlot = 0;
+                }
+            }
+        } else {
+            out.clear();
+            out.reserve(count);
+            for(size_t i = 0; i < count; i++){
+                out.push_back(load<T>(cursor + i * sizeof(T)));
+            }
+        }
+        cursor += count * sizeof(T);
+        return true;
+    }
+    if(section.type != TimelineSectionType::Sparse || available / (sizeof(uint32_t) + sizeof(T)) < count){
+        return false;
+    }
+    const std::byte* slots = cursor;
+    const std::byte* values = cursor + count * sizeof(uint32_t);
+    if(out.size() > section.total){
+        out.erase(out.begin() + section.total, out.end());
+    }
+    for(size_t i = 0; i < count; i++){
+        uint32_t slot;
+        std::memcpy(&slot, slots + i * sizeof(uint32_t), sizeof(uint32_t));
+        if(slot < out.size()){
+            out[slot] = load<T>(values + i * sizeof(T));
+        } else if(slot == out.size() && slot < section.total){
+            out.push_back(load<T>(values + i * sizeof(T)));
+        } else {
+            return false;
+        }
+    }
+    cursor += count * (sizeof(uint32_t) + sizeof(T));
+    return out.size() == section.total;
+}
+
+bool TimelinePlayer::open(const std::string& path){
+    close();
+    if(!file.open(path)){
+        return false;
+    }
+    const std::span<const std::byte> data = file.view();
+    TimelineHeader header;
+    if(data.size() < sizeof(header)){
+        close();
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if(header.magic != TIMELINE_MAGIC || header.version != TIMELINE_VERSION || header.strides != TIMELINE_STRIDES || header.keyframeInterval == 0){
+        close();
+        return false;
+    }
+    keyframeInterval = header.keyframeInterval;
+    if(!readIndex()){
+        scanFrames();
+    }
+    if(frames.empty()){
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TimelinePlayer::close(){
+    file.close();
+    frames.clear();
+    keyframeInterval = 0;
+    position = 0;
+    applied = false;
+}
+
+bool TimelinePlayer::readIndex(){
+    const std::span<const std::byte> data = file.view();
+    TimelineFooter footer;
+    if(data.size() < sizeof(TimelineHeader) + sizeof(footer)){
+        return false;
+    }
+    std::memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+    const uint64_t indexEnd = data.size() - sizeof(footer);
+    if(footer.magic != TIMELINE_FOOTER_MAGIC || footer.indexOffset > indexEnd
+        || (indexEnd - footer.indexOffset) / sizeof(TimelineIndexEntry) != footer.frameCount){
+        return false;
+    }
+    frames.resize(footer.frameCount);
+    if(footer.frameCount > 0){
+        std::memcpy(frames.data(), data.data() + footer.indexOffset, footer.frameCount * sizeof(TimelineIndexEntry));
+    }
+    for(uint64_t frame = 0; frame < frames.size(); frame++){
+        if(frames[frame].offset + sizeof(TimelineFrameHeader) > footer.indexOffset || frames[frame].keyframe > frame){
+            frames.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void TimelinePlayer::scanFrames(){
+    const std::span<const std::byte> data = file.view();
+    frames.clear();
+    uint64_t offset = sizeof(TimelineHeader);
+    uint64_t lastKeyframe = 0;
+    TimelineFrameHeader header;
+    // Only the headers get touched, stops at the first frame that didn't make it to the disk whole
+    while(data.size() - offset >= sizeof(header)){
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        if(header.magic != TIMELINE_FRAME_MAGIC || header.frame != frames.size() || header.size > data.size() - offset - sizeof(header)){
+            break;
+        }
+        if(header.keyframe){
+            lastKeyframe = header.frame;
+        }
+        frames.push_back({offset, lastKeyframe});
+        offset += sizeof(header) + header.size;
+    }
+}
+
+bool TimelinePlayer::seek(uint64_t frame, const TimelineTarget& target, uint32_t& touched){
+    touched = 0;
+    if(frames.empty()){
+        return false;
+    }
+    frame = std::min<uint64_t>(frame, frames.size() - 1);
+    if(applied && frame == position){
+        return true;
+    }
+    const uint64_t keyframe = frames[frame].keyframe;
+    const uint64_t first = applied && position < frame && position >= keyframe ? position + 1 : keyframe;
+    applied = false;
+    for(uint64_t next = first; next <= frame; next++){
+        if(!applyFrame(next, target, touched)){
+            return false;
+        }
+        position = next;
+        applied = true;
+    }
+    return true;
+}
+
+bool TimelinePlayer::applyFrame(uint64_t frame, const TimelineTarget& target, uint32_t& touched){
+    const std::span<const std::byte> data = file.view();
+    const uint64_t offset = frames[frame].offset;
+    TimelineFrameHeader header;
+    if(offset > data.size() || data.size() - offset < sizeof(header)){
+        return false;
+    }
+    std::memcpy(&header, data.data() + offset, sizeof(header));
+    if(header.magic != TIMELINE_FRAME_MAGIC || header.frame != frame || header.size > data.size() - offset - sizeof(header)){
+        return false;
+    }
+    const std::byte* cursor = data.data() + offset + sizeof(header);
+    const std::byte* end = cursor + header.size;
+    for(uint32_t i = 0; i < header.sectionCount; i++){
+        TimelineSection section;
+        if(static_cast<size_t>(end - cursor) < sizeof(section)){
+            return false;
+        }
+        std::memcpy(&section, cursor, sizeof(section));
+        cursor += sizeof(section);
+        bool valid = false;
+        switch (section.stream) {
+            case TimelineStream::Circles: valid = applySection(target.circles, section, cursor, end); break;
+            case TimelineStream::Lines: valid = applySection(target.lines, section, cursor, end); break;
+            case TimelineStream::Polygons: valid = applySection(target.polygons, section, cursor, end); break;
+            case TimelineStream::Edges: valid = applySection(target.edges, section, cursor, end); break;
+            case TimelineStream::Meshes: valid = applySection(target.meshes, section, cursor, end); break;
+            case TimelineStream::Vertices: valid = applySection(target.vertices, section, cursor, end); break;
+            case TimelineStream::Indices: valid = applySection(target.indices, section, cursor, end); break;
+            case TimelineStream::Count: break;
+        }
+        if(!valid){
+            return false;
+        }
+        touched |= 1u << static_cast<uint32_t>(section.stream);
+    }
+    return true;
+}
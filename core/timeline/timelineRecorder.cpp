@@ -0,0 +1,207 @@
+#include "ThING/consts.h"
+#include <ThING/timeline/timelineRecorder.h>
+#include <algorithm>
+#include <cstring>
+
+static void append(std::vector<std::byte>& out, const void* data, size_t size){
+    if(size == 0){
+        return;
+    }
+    const size_t offset = out.size();
+    out.resize(offset + size);
+    std::memcpy(out.data() + offset, data, size);
+}
+
+bool TimelineRecorder::start(const std::string& path, uint32_t interval){
+    stop();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if(!file){
+        return false;
+    }
+    keyframeInterval = std::max(interval, 1u);
+    TimelineHeader header;
+    header.keyframeInterval = keyframeInterval;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for(std::vector<std::byte>& shadow : shadows){
+        shadow.clear();
+    }
+    frame = 0;
+    index.clear();
+    writeOffset = sizeof(header);
+    lastKeyframe = 0;
+    queuedBytes = 0;
+    failed = !file;
+    writerRunning = true;
+    recording = true;
+    writer = std::thread(&TimelineRecorder::writerLoop, this);
+    return true;
+}
+
+bool TimelineRecorder::stop(){
+    if(!recording){
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        writerRunning = false;
+    }
+    queueCondition.notify_all();
+    writer.join(); // drains what is still queued first
+
+    TimelineFooter footer;
+    footer.indexOffset = writeOffset;
+    footer.frameCount = index.size();
+    file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(TimelineIndexEntry)));
+    file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    const bool written = !failed && file.good();
+    file.close();
+
+    recording = false;
+    queued.clear();
+    spare.clear();
+    index = {};
+    for(std::vector<std::byte>& shadow : shadows){
+        shadow = {}; // a big scene leaves a big copy behind otherwise
+    }
+    return written;
+}
+
+void TimelineRecorder::capture(const TimelineScene& scene, bool meshesChanged, JobSystem& jobs){
+    if(!recording){
+        return;
+    }
+    const bool keyframe = frame % keyframeInterval == 0;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if(!spare.empty()){
+            encoding = std::move(spare.back());
+            spare.pop_back();
+        }
+    }
+    encoding.clear();
+    encoding.resize(sizeof(TimelineFrameHeader));
+    frameHeader = {};
+    frameHeader.keyframe = keyframe ? 1 : 0;
+    frameHeader.frame = frame;
+
+    writeStream(TimelineStream::Circles, reinterpret_cast<const std::byte*>(scene.circles.data()), scene.circles.size(), keyframe, jobs);
+    writeStream(TimelineStream::Lines, reinterpret_cast<const std::byte*>(scene.lines.data()), scene.lines.size(), keyframe, jobs);
+    writeStream(TimelineStream::Polygons, reinterpret_cast<const std::byte*>(scene.polygons.data()), scene.polygons.size(), keyframe, jobs);
+    writeStream(TimelineStream::Edges, reinterpret_cast<const std::byte*>(scene.edges.data()), scene.edges.size(), keyframe, jobs);
+    writeStream(TimelineStream::Meshes, reinterpret_cast<const std::byte*>(scene.meshes.data()), scene.meshes.size(), keyframe, jobs);
+    if(keyframe || meshesChanged){
+        writeFull(TimelineStream::Vertices, reinterpret_cast<const std::byte*>(scene.vertices.data()), scene.vertices.size());
+        writeFull(TimelineStream::Indices, reinterpret_cast<const std::byte*>(scene.indices.data()), scene.indices.size());
+    }
+    frameHeader.size = encoding.size() - sizeof(TimelineFrameHeader);
+    std::memcpy(encoding.data(), &frameHeader, sizeof(TimelineFrameHeader));
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueCondition.wait(lock, [this]{return queuedBytes < TIMELINE_MAX_QUEUED_BYTES;});
+        queuedBytes += encoding.size();
+        queued.push_back(std::move(encoding));
+    }
+    queueCondition.notify_all();
+    frame++;
+}
+
+void TimelineRecorder::writeStream(TimelineStream stream, const std::byte* data, size_t count, bool full, JobSystem& jobs){
+    const size_t stride = TIMELINE_STRIDES[static_cast<size_t>(stream)];
+    std::vector<std::byte>& shadow = shadows[static_cast<size_t>(stream)];
+    if(full){
+        shadow.assign(data, data + count * stride);
+        writeFull(stream, data, count);
+        return;
+    }
+
+    // Slots both frames have get compared a chunk per job, each job also catches its part of the shadow up
+    const size_t oldCount = shadow.size() / stride;
+    const size_t common = std::min(oldCount, count);
+    const size_t chunks = (common + TIMELINE_DIFF_GRAIN - 1) / TIMELINE_DIFF_GRAIN;
+    if(changedChunks.size() < chunks){
+        changedChunks.resize(chunks);
+    }
+    std::byte* previous = shadow.data();
+    jobs.parallelForRange(chunks, 1, [&](size_t begin, size_t end){
+        for(size_t chunk = begin; chunk < end; chunk++){
+            std::vector<uint32_t>& out = changedChunks[chunk];
+            out.clear();
+            const size_t last = std::min((chunk + 1) * TIMELINE_DIFF_GRAIN, common);
+            for(size_t i = chunk * TIMELINE_DIFF_GRAIN; i < last; i++){
+                if(std::memcmp(data + i * stride, previous + i * stride, stride) != 0){
+                    std::memcpy(previous + i * stride, data + i * stride, stride);
+                    out.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    });
+    changed.clear();
+    for(size_t chunk = 0; chunk < chunks; chunk++){
+        changed.insert(changed.end(), changedChunks[chunk].begin(), changedChunks[chunk].end());
+    }
+    for(size_t i = common; i < count; i++){
+        changed.push_back(static_cast<uint32_t>(i)); // new slots, the player appends them
+    }
+    shadow.resize(count * stride);
+    if(count > common){
+        std::memcpy(shadow.data() + common * stride, data + common * stride, (count - common) * stride);
+    }
+    if(changed.empty() && count == oldCount){
+        return;
+    }
+
+    const TimelineSection section{stream, TimelineSectionType::Sparse, static_cast<uint32_t>(changed.size()), static_cast<uint32_t>(count)};
+    append(encoding, &section, sizeof(section));
+    append(encoding, changed.data(), changed.size() * sizeof(uint32_t));
+    size_t offset = encoding.size();
+    encoding.resize(offset + changed.size() * stride);
+    for(uint32_t slot : changed){
+        std::memcpy(encoding.data() + offset, data + slot * stride, stride);
+        offset += stride;
+    }
+    frameHeader.sectionCount++;
+}
+
+void TimelineRecorder::writeFull(TimelineStream stream, const std::byte* data, size_t count){
+    const TimelineSection section{stream, TimelineSectionType::Full, static_cast<uint32_t>(count), static_cast<uint32_t>(count)};
+    append(encoding, &section, sizeof(section));
+    append(encoding, data, count * TIMELINE_STRIDES[static_cast<size_t>(stream)]);
+    frameHeader.sectionCount++;
+}
+
+void TimelineRecorder::writerLoop(){
+    while(true){
+        std::vector<std::byte> data;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]{return !queued.empty() || !writerRunning;});
+            if(queued.empty()){
+                return; // stopped and everything is written
+            }
+            data = std::move(queued.front());
+            queued.pop_front();
+        }
+        if(!failed){
+            TimelineFrameHeader header;
+            std::memcpy(&header, data.data(), sizeof(header));
+            if(header.keyframe){
+                lastKeyframe = header.frame;
+            }
+            index.push_back({writeOffset, lastKeyframe});
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            writeOffset += data.size();
+            if(!file){
+                failed = true; // the rest is dropped, stop() reports it
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queuedBytes -= data.size();
+            data.clear();
+            spare.push_back(std::move(data));
+        }
+        queueCondition.notify_all(); // capture can be waiting for room
+    }
+}
@@ -71,10 +71,36 @@ void UI(ThING::API& api, FPSCounter& fps){
         gravity[1] = 0;
     }
     ImGui::SliderFloat("Stiffness", &stiffness, 0.01f, 0.4f, "%.3f");
+    ImGui::Checkbox("GPU Physics", &gpuPhysics);
+    ImGui::Checkbox("Force Layout", &forceLayout);
+    static bool heatmap = false;
+    if(ImGui::Checkbox("Heatmap", &heatmap)){
+        HeatmapSettings settings = api.getHeatmap();
+        settings.enabled = heatmap;
+        api.setHeatmap(settings);
+    }
 
     ImGui::Text("Real FPS: %d", (int)(fps.getInstantFPS() + 1));
+    const FrameStats& stats = api.getFrameStats();
+    ImGui::Text("CPU: %.2fms GPU: %.2fms", stats.cpuTime, stats.gpuTime);
+    ImGui::Text("Wait: %.2fms Latency: %.2fms (%u in flight)", stats.waitTime, stats.latency, stats.framesInFlight);
+    ImGui::Text("Upload: %.1fMB %.2fms %.1fGB/s", stats.uploadBytes / 1e6f, stats.uploadTime, stats.uploadBandwidth);
     ImGui::Text("Collisions: %u", collissionCount);
 
+    // One pick in flight at a time, the answer is a frame or two behind the mouse
+    static uint64_t hoverTicket = 0;
+    static std::vector<Entity> hovered;
+    if(hoverTicket == 0 || api.readPick(hoverTicket, hovered)){
+        ImVec2 mouse = ImGui::GetMousePos();
+        hoverTicket = api.pickAsync({mouse.x, mouse.y});
+    }
+    static const char* typeNames[] = {"Polygon", "Circle", "Line"};
+    if(hovered.empty()){
+        ImGui::Text("Hover: -");
+    } else {
+        ImGui::Text("Hover: %s %u", typeNames[static_cast<uint32_t>(hovered[0].type)], hovered[0].index);
+    }
+
     if(ImGui::Button("Random Polygon")){
         int sides = getRandomNumber(3, 12);
         float x = getRandomNumber(-200.f, 600.f);
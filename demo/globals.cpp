@@ -9,5 +9,7 @@ int dockedSizeX;
 float simSpeed = .25;
 unsigned int collissionCount = 0;
 float stiffness = .25f;
+bool gpuPhysics = false;
+bool forceLayout = false;
 int simWidth = 0;
 int simHeight = 0;
\ No newline at end of file
@@ -8,24 +8,24 @@
 #include "glm/fwd.hpp"
 #include "../globals.h"
 #include "imgui.h"
-#include "physicsObject.h"
+#include <ThING/layout/forceLayout.h>
+#include <ThING/physics/verletSolver.h>
 #include <cstdint>
 #include <span>
 
 void update(ThING::API& api, FPSCounter& fps){
-    std::span<InstanceData> circleInstances = api.getInstanceVector(InstanceType::Circle);
+    // Read only, with GPU physics on taking the writable vector would upload every circle every frame
+    std::span<const InstanceData> circleInstances = api.viewInstanceVector(InstanceType::Circle);
 
     WindowSize windowSize;
     api.getWindowSize(&windowSize.width, &windowSize.height);
     windowSize.width /= 2;
     windowSize.height /= 2;
 
-    static uint32_t count = 0;
-    static std::vector<PhysicsObject> circlePhysics = {};
-    static std::vector<Entity> lineEntities;
+    static std::vector<glm::vec2> gpuPositions;
+    static std::vector<Entity> hits;
 
     const float BIGGER_RADIUS = 4;
-    const float BIGGER_RADIUS_MINUS = BIGGER_RADIUS - 1;
     const float SMALLER_RADIUS = 2;
 
     // ===== CLICK EVENTS START =====
@@ -42,23 +42,13 @@ void update(ThING::API& api, FPSCounter& fps){
             if(pos.x > -windowSize.width + dockedSizeX + 5){
 
                 float circleSize = getRandomNumber(SMALLER_RADIUS, BIGGER_RADIUS);
-                count++;
                 glm::vec4 color = {getRandomNumber(0.0f, 1.0f), getRandomNumber(0.0f, 1.0f), getRandomNumber(0.0f, 1.0f), 1};
 
                 Entity e = api.addCircle(pos, circleSize, {0,0,1,1.f});
-                circleInstances = api.getInstanceVector(InstanceType::Circle);        
+                circleInstances = api.viewInstanceVector(InstanceType::Circle);
 
-                api.getInstance(e).objectID = count;
-                api.getInstance(e).outlineSize = 5;
-                api.getInstance(e).outlineColor = color;
                 api.getInstance(e).drawIndex = 20;
-                api.updateOutlines();
-                
-                if (e.index < circlePhysics.size()) {
-                    circlePhysics[e.index] = {pos, pos, {0.f, 0.f}};
-                } else {
-                    circlePhysics.push_back({pos, pos, {0.f, 0.f}});
-                }
+                api.setOutline(e, 5, color);
             }
         }
 
@@ -69,142 +59,87 @@ void update(ThING::API& api, FPSCounter& fps){
                 tempPosition.y - windowSize.height
             };
 
-            Entity hit = INVALID_ENTITY;
-
-            for (uint32_t i = 0; i < circleInstances.size(); i++) {
-                const InstanceData& c = circleInstances[i];
-
-                if(!c.alive) continue;
-
-                glm::vec2 d = p - c.position;
-                if (glm::dot(d, d) <= c.scale.x * c.scale.x) {
-                    hit = {i, InstanceType::Circle};
-                    break;
+            if(gpuPhysics && !forceLayout){
+                // The instances don't follow the GPU bodies, pick against the last readback instead
+                for(uint32_t i = 0; i < gpuPositions.size() && i < circleInstances.size(); i++){
+                    const float radius = circleInstances[i].scale.x;
+                    if(circleInstances[i].alive && glm::dot(gpuPositions[i] - p, gpuPositions[i] - p) <= radius * radius){
+                        api.deleteInstance({i, InstanceType::Circle});
+                        break;
+                    }
+                }
+            } else {
+                api.queryPoint(p, hits);
+                for (const Entity& hit : hits) {
+                    if (hit.type == InstanceType::Circle) {
+                        api.deleteInstance(hit);
+                        break;
+                    }
                 }
-            }
-
-            if (api.exists(hit)) {
-                circlePhysics[hit.index] = {};
-
-                api.deleteInstance(hit);
             }
         }
         // ===== CLICK EVENTS ENDS =====
     }
 
-    const int steps = 4;
-    const float sub_dt = simSpeed / (float)steps;
-
-    int circleAmount = circleInstances.size();
-
-    int gridWidth  = (windowSize.width  + BIGGER_RADIUS_MINUS) / BIGGER_RADIUS;
-    int gridHeight = (windowSize.height + BIGGER_RADIUS_MINUS) / BIGGER_RADIUS;
-
-    static std::vector<std::vector<uint32_t>> circleID(gridWidth * gridHeight);
-    static WindowSize lastWindowSize = windowSize;
-    static bool firstTime = true;
-    if(lastWindowSize != windowSize){
-        circleID.clear();
-        circleID.resize(gridWidth * gridHeight);
-        firstTime = true;
-        lastWindowSize = windowSize;
-    }
-    if (firstTime) {
-        for (auto& cell : circleID) {
-            cell.reserve(8);
+    static VerletSolver solver;
+    static ForceLayout layout;
+    static bool wasGpuPhysics = false;
+    static bool wasForceLayout = false;
+    const glm::vec2 minBound = {-windowSize.width + dockedSizeX, -windowSize.height};
+    const glm::vec2 maxBound = {windowSize.width, windowSize.height};
+    if(wasGpuPhysics && !(gpuPhysics && !forceLayout)){
+        // Leaving GPU physics, this is the one frame the circles take the positions the bodies ended at
+        std::span<InstanceData> circles = api.getInstanceVector(InstanceType::Circle);
+        for(uint32_t i = 0; i < gpuPositions.size() && i < circles.size(); i++){
+            circles[i].position = gpuPositions[i];
         }
-        firstTime = false;
     }
-
-    for (auto& cell : circleID){
-        cell.clear();
-    }
-
-    for (int i = 0; i < circleAmount; i++){
-        if(!circleInstances[i].alive) 
-            continue;
-
-        int gridX = ((circleInstances[i].position.x + windowSize.width)  / 2) / BIGGER_RADIUS;
-        int gridY = ((circleInstances[i].position.y + windowSize.height) / 2) / BIGGER_RADIUS;
-
-        if (gridX >= 0 && gridX < gridWidth && gridY >= 0 && gridY < gridHeight)
-        {
-            circleID[(gridY * gridWidth) + gridX].push_back(i);
+    if(forceLayout){
+        if(wasGpuPhysics){
+            api.setGpuPhysics({});
         }
-    }
-
-    for (int s = steps; s; s--){
-
-        for(uint32_t i = 0; i < circlePhysics.size(); i++){
-            if(!circleInstances[i].alive) 
-                continue;
-            circlePhysics[i].accelerate({gravity[0], gravity[1]});
+        if(!wasForceLayout){
+            // Start from wherever physics left the circles
+            layout.adopt(api.viewInstanceVector(InstanceType::Circle));
         }
-
+        layout.setCenter((minBound + maxBound) * 0.5f);
+        layout.step(api.getInstanceVector(InstanceType::Circle), api.getEdgeVector(), api.getJobSystem());
         collissionCount = 0;
-        for(int i = 0; i < circleAmount; i++){
-            if(!circleInstances[i].alive) 
-                continue;
-
-            circlePhysics[i].updatePos(sub_dt);
-            circleInstances[i].position = circlePhysics[i].currentPos;
-        }
-
-        for (int x = 0; x < gridWidth; x++) {
-            for (int y = 0; y < gridHeight; y++) {
-                for (uint32_t ID : circleID[(y * gridWidth) + x]) {
-                    for (int j = 0; j <= 1; j++) {
-                        for (int k = -1; k <= 1; k++) {
-
-                            if (j == 0 && k == 1) continue;
-
-                            int nx = x + j;
-                            int ny = y + k;
-
-                            if (nx < 0 || ny < 0 || nx >= gridWidth || ny >= gridHeight)
-                                continue;
-
-                            for (uint32_t neighbor : circleID[(ny * gridWidth) + nx]) {
-                                if (ID == neighbor) continue;
-                                if (j == 0 && k == 0 && ID > neighbor) continue;
-
-                                Collision collision = getCircleCollision(circleInstances[ID], circleInstances[neighbor]);
-
-                                if(collision.hit){
-                                    collissionCount++;
-                                    circlePhysics[ID].currentPos -= collision.normal * collision.depth * stiffness;
-                                    circlePhysics[neighbor].currentPos += collision.normal * collision.depth * stiffness;
-                                }
-                            }
-                        }
-                    }
-                }
+    } else if(gpuPhysics){
+        GpuPhysicsSettings settings;
+        settings.enabled = true;
+        settings.gravity = {gravity[0], gravity[1]};
+        settings.stiffness = stiffness;
+        settings.minBound = minBound;
+        settings.maxBound = maxBound;
+        api.setGpuPhysics(settings);
+        api.stepGpuPhysics(simSpeed);
+        api.requestGpuPositions();
+        // Kept on the side (picking, handing the bodies back), writing it into the instances would dirty all of them
+        api.readGpuPositions(gpuPositions);
+        collissionCount = 0;
+    } else {
+        if(wasGpuPhysics || wasForceLayout){
+            // Hand the bodies back to the CPU solver where the GPU or the layout left them
+            if(wasGpuPhysics){
+                api.setGpuPhysics({});
+            }
+            for(uint32_t i = 0; i < circleInstances.size(); i++){
+                solver.teleport(i, circleInstances[i].position);
             }
         }
-
-        for(int i = 0; i < circleAmount; i++){
-            if(!circleInstances[i].alive) 
-                continue;
-
-            const glm::vec2 minBound{-windowSize.width + dockedSizeX, -windowSize.height};
-            const glm::vec2 maxBound{ windowSize.width, windowSize.height};
-
-            float r = circleInstances[i].scale.x;
-
-            if (circlePhysics[i].currentPos.x < minBound.x + r)
-                circlePhysics[i].currentPos.x = minBound.x + r;
-
-            if (circlePhysics[i].currentPos.x > maxBound.x - r)
-                circlePhysics[i].currentPos.x = maxBound.x - r;
-
-            if (circlePhysics[i].currentPos.y < minBound.y + r)
-                circlePhysics[i].currentPos.y = minBound.y + r;
-
-            if (circlePhysics[i].currentPos.y > maxBound.y - r)
-                circlePhysics[i].currentPos.y = maxBound.y - r;
-        }
+        solver.setGravity({gravity[0], gravity[1]});
+        solver.setStiffness(stiffness);
+        solver.setBounds(minBound, maxBound);
+        solver.step(api.getInstanceVector(InstanceType::Circle), simSpeed, api.getJobSystem());
+        collissionCount = solver.getCollisionCount();
     }
+    wasGpuPhysics = gpuPhysics && !forceLayout;
+    wasForceLayout = forceLayout;
+
+    // Edges read their ends from the circles, so they only get rebuilt when the chain itself changes
     static std::vector<uint32_t> aliveCircles;
+    static std::vector<uint32_t> chainedCircles;
     aliveCircles.clear();
 
     for (uint32_t i = 0; i < circleInstances.size(); i++){
@@ -213,26 +148,11 @@ void update(ThING::API& api, FPSCounter& fps){
         }
     }
 
-    uint32_t neededLines = aliveCircles.size() > 1 ? aliveCircles.size() - 1 : 0;
-
-    while (lineEntities.size() < neededLines) {
-        Entity e = api.addLine({0,0}, {0,0}, 2.0f);
-        lineEntities.push_back(e);
-    }
-
-    while (lineEntities.size() > neededLines) {
-        api.deleteInstance(lineEntities.back());
-        lineEntities.pop_back();
-    }
-
-    for (uint32_t i = 0; i < neededLines; i++) {
-        uint32_t a = aliveCircles[i];
-        uint32_t b = aliveCircles[i + 1];
-
-        Entity line = lineEntities[i];
-        LineData& ld = api.getLineVector()[line.index];
-
-        ld.point1 = circleInstances[a].position;
-        ld.point2 = circleInstances[b].position;
+    if (aliveCircles != chainedCircles) {
+        api.clearEdges();
+        for (uint32_t i = 0; i + 1 < aliveCircles.size(); i++) {
+            api.addEdge({aliveCircles[i], InstanceType::Circle}, {aliveCircles[i + 1], InstanceType::Circle}, 2.0f, {1, 1, 0, 1});
+        }
+        chainedCircles = aliveCircles;
     }
 }
@@ -1,5 +1,7 @@
 #include <string>
 #include <filesystem>
+#include <stdexcept>
+#include <utility>
 #include <ThING/extras/handMade.h>
 #if defined(_WIN32)
     #define WIN32_LEAN_AND_MEAN
@@ -11,7 +13,51 @@
         GetModuleFileNameA(NULL, path, MAX_PATH);
         return std::filesystem::path(path).parent_path().string();
     }
+
+    bool osd::MappedFile::open(const std::string& path) {
+        close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+        if (fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return true; // nothing to map, the view stays empty
+        }
+        HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file); // the mapping keeps the file open
+        if (map == nullptr) {
+            return false;
+        }
+        void* view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(map);
+            return false;
+        }
+        data = static_cast<const std::byte*>(view);
+        size = static_cast<size_t>(fileSize.QuadPart);
+        mapping = map;
+        return true;
+    }
+
+    void osd::MappedFile::close() {
+        if (data) {
+            UnmapViewOfFile(data);
+            CloseHandle(mapping);
+        }
+        data = nullptr;
+        size = 0;
+        mapping = nullptr;
+    }
 #elif defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
     #include <unistd.h>
     std::string osd::getExecutableDir() {
         char path[4096];
@@ -21,9 +67,55 @@
         }
         return std::filesystem::path(std::string(path, count)).parent_path().string();
     }
+
+    bool osd::MappedFile::open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == -1) {
+            ::close(fd);
+            return false;
+        }
+        if (info.st_size == 0) {
+            ::close(fd);
+            return true; // nothing to map, the view stays empty
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file open
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        data = static_cast<const std::byte*>(view);
+        size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    void osd::MappedFile::close() {
+        if (data) {
+            munmap(const_cast<std::byte*>(data), size);
+        }
+        data = nullptr;
+        size = 0;
+    }
 #else
     #error "Unsupported platform"
 #endif
 
+osd::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), mapping(std::exchange(other.mapping, nullptr)) {}
+
+osd::MappedFile& osd::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+        mapping = std::exchange(other.mapping, nullptr);
+    }
+    return *this;
+}
+
 std::random_device rd;
 std::mt19937 rng(rd());
\ No newline at end of file
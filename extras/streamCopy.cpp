@@ -0,0 +1,43 @@
+#include <ThING/extras/streamCopy.h>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define THING_STREAM_SSE2
+#endif
+
+void streamCopy(void* dst, const void* src, size_t bytes){
+#ifdef THING_STREAM_SSE2
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    // Streaming stores need an aligned destination, the source can be anything
+    size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+    if(head > bytes){
+        head = bytes;
+    }
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    bytes -= head;
+
+    // Full 64 byte lines so the write-combining buffers flush whole lines
+    for(; bytes >= 64; bytes -= 64, d += 64, s += 64){
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+        __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), e);
+    }
+    for(; bytes >= 16; bytes -= 16, d += 16, s += 16){
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+    }
+    memcpy(d, s, bytes);
+    _mm_sfence(); // streaming stores are weakly ordered, make them visible before the submit
+#else
+    memcpy(dst, src, bytes);
+#endif
+}
@@ -6,11 +6,36 @@
 #include <cstdint>
 #include <miniaudio.h>
 #include <ThING/extras/fpsCounter.h>
+#include <ThING/types/tripleBuffer.h>
+#include <ThING/types/sceneSnapshot.h>
+#include <ThING/types/mpscQueue.h>
+#include <ThING/types/instanceEdit.h>
+#include <ThING/spatial/spatialIndex.h>
+#include <ThING/threading/stepScheduler.h>
+#include <ThING/timeline/timelinePlayer.h>
+#include <ThING/timeline/timelineRecorder.h>
+#include <ThING/timeline/snapshotStore.h>
+#include <ThING/timeline/sceneFile.h>
+#include <ThING/io/graphLoader.h>
+#include <ThING/io/tileStreamer.h>
+#include <ThING/audio/soundPool.h>
+#include <ThING/audio/synth.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 
 enum ApiFlags : uint8_t{
     ApiFlags_None = 0,
     ApiFlags_UpdateCallbackFirst = 1 << 0,
-    ApiFlags_UseFullFPS = 1 << 1
+    ApiFlags_UseFullFPS = 1 << 1,
+    // Update callback runs on its own thread with its own FPSCounter, the render loop draws the latest
+    // finished update step. UI callback stays on the main thread and runs between two update steps
+    ApiFlags_ThreadedUpdate = 1 << 2
 };
 
 struct Entity;
@@ -29,13 +54,15 @@ namespace ThING{
 
         // Get Info
         uint32_t getInstanceCount(InstanceType type);
-        void getWindowSize(int* x, int* y);
+        void getWindowSize(int* x, int* y); // as of the start of the frame, safe from the update thread
+        const FrameStats& getFrameStats() const {return app.frameStats;}
         
         // Direct Data Manipulation
-        std::span<InstanceData> getInstanceVector(InstanceType type);
+        std::span<InstanceData> getInstanceVector(InstanceType type); // marks every instance of the type as written
         std::span<LineData> getLineVector();
+        std::span<const InstanceData> viewInstanceVector(InstanceType type) const; // read only, marks nothing
 
-        // Camera Settings
+        // Camera Settings, under ApiFlags_ThreadedUpdate they reach the renderer with the next snapshot
         void setZoom(float zoom);
         void setOffset(glm::vec2 offset);
         void setBackgroundColor(glm::vec4 color);
@@ -54,13 +81,200 @@ namespace ThING{
         LineData& getLine(const Entity e);
         void clearInstanceVector(InstanceType type);
 
+        // Thread Safe Edits
+        // Can be called from any thread, they get applied in order before the next upload.
+        // New entities get their handle right away, exists() is false until the edit is applied.
+        // Return INVALID_ENTITY / false when the queue is full. Edits still queued when clearInstanceVector runs or
+        // the scene gets swapped (seek, restore, loadScene) are dropped
+        Entity queueCircle(glm::vec2 pos, float size, glm::vec4 color);
+        Entity queueLine(glm::vec2 point1, glm::vec2 point2, float width);
+        bool queueDelete(const Entity e);
+        bool queueColor(const Entity e, glm::vec4 color);
+        bool queuePosition(const Entity e, glm::vec2 pos);
+        bool queueInstance(const Entity e, const InstanceData& data);
+
         // Audio
         bool playAudio(const std::string& soundFile);
         bool playAudio(const std::string& soundFile, uint8_t volume);
+        // Decoded once into memory and played on MAX_SOUND_VOICES preallocated voices, playing one reads no file and
+        // allocates nothing so it keeps up with hundreds of sounds per second. When all are busy the oldest gets cut
+        SoundHandle loadSound(const std::string& soundFile) {return soundPool.load(soundFile);} // same path, same handle. INVALID_SOUND when it can't be decoded
+        bool playAudio(SoundHandle sound, uint8_t volume = 255, float pitch = 1.0f); // pitch 2 is an octave up and twice as fast
+        // Tones generated on the audio thread, for sonifying data at thousands of notes per second. Notes go through a
+        // lock-free queue and up to MAX_SYNTH_VOICES get picked up per audio period and ring at once (the oldest is
+        // cut). Duration is how long it's held, a short release follows. Overlapping notes add up, keep volume low for chords
+        bool playTone(float frequency, float duration, uint8_t volume = 255, Waveform waveform = Waveform::Sine); // false when MAX_QUEUED_TONES are waiting or frequency/duration is NaN or negative
         void setVolume(uint8_t volume) {this->volume = volume;}
 
+        // Outlines
+        bool setOutline(const Entity e, float size, glm::vec4 color, uint32_t groupID = 0);
+        bool updateOutline(const Entity e); // Pushes the outline fields of one instance, use after editing them directly
+        bool removeOutline(const Entity e);
+        void updateOutlines() {dirtyFlags.ssbo = true;} // Full resync, remaps every objectID to a dense slot
+
+        // Jobs
+        // Same pool the engine uses for its per-instance loops, use it instead of spawning threads
+        JobSystem& getJobSystem() {return app.jobSystem;}
+        template <typename T, typename Fn>
+        void parallelFor(std::span<T> items, size_t grain, Fn&& fn) {app.jobSystem.parallelFor(items, grain, std::forward<Fn>(fn));}
+        template <std::ranges::contiguous_range R, typename Fn>
+        void parallelFor(R&& items, size_t grain, Fn&& fn) {app.jobSystem.parallelFor(std::forward<R>(items), grain, std::forward<Fn>(fn));}
+
+        // Algorithm Tasks
+        // Algorithms written as ThING::StepTask coroutines that co_await ThING::nextStep() between steps. They run right
+        // after the update callback, on its thread, with as many steps as fit in the budget, so a visualization plays at
+        // any speed without blocking the frame. setTaskStepLimit caps the steps per frame for slow playback
+        uint64_t startTask(ThING::StepTask task) {return stepScheduler.add(std::move(task));} // 0 = nothing to run
+        bool stopTask(uint64_t task) {return stepScheduler.cancel(task);}
+        bool isTaskRunning(uint64_t task) const {return stepScheduler.isRunning(task);}
+        void setTaskBudget(float milliseconds) {stepScheduler.setBudget(milliseconds);}
+        void setTaskStepLimit(uint64_t steps) {stepScheduler.setStepLimit(steps);} // 0 = no limit
+        uint64_t getTaskSteps() const {return stepScheduler.getLastSteps();} // steps run last frame
+
+        // Tweens
+        // Played by the vertex shaders on the frame time, so starting one writes a single slot and the frames after cost
+        // the CPU nothing. The instance gets the target right away (queries and reads see where it ends up) and is drawn
+        // blending towards it from where it is drawn now, a new tween of a running property picks up from there.
+        // Lines move point1, point2 and thickness. Circle positions under GPU physics belong to the physics, splats and
+        // the heatmap show the target. Returns false when the entity is gone or too many are animating, 0 duration jumps
+        bool animate(const Entity e, TweenProperty property, glm::vec4 target, float duration, Easing easing = Easing::EaseInOut);
+        bool animate(const Entity e, TweenProperty property, glm::vec2 target, float duration, Easing easing = Easing::EaseInOut)
+            {return animate(e, property, glm::vec4(target, 0.0f, 0.0f), duration, easing);}
+        bool animate(const Entity e, TweenProperty property, float target, float duration, Easing easing = Easing::EaseInOut)
+            {return animate(e, property, glm::vec4(target, 0.0f, 0.0f, 0.0f), duration, easing);}
+        bool finishAnimations(const Entity e); // every running tween of e jumps to its target
+
+        // Timeline
+        // Records the scene after every frame (callbacks, tasks and queued edits applied) into a file, only the slots
+        // that changed plus the whole scene every keyframeInterval frames. Diffed on the job pool and written by a
+        // background thread. An opened timeline replaces the scene and seekTimeline puts it at any recorded frame, so
+        // a run recorded once can be scrubbed back and forth. Outlines come back too, tweens show where they ended
+        bool startRecording(const std::string& path, uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL); // false when the file can't be created
+        bool stopRecording() {return timelineRecorder.stop();} // false when something didn't make it to the file
+        bool isRecording() const {return timelineRecorder.isRecording();}
+        bool openTimeline(const std::string& path); // clears the scene and shows frame 0, false when it isn't a timeline
+        void closeTimeline() {timelinePlayer.close();} // the scene stays at the frame it was
+        bool seekTimeline(uint64_t frame); // past the end shows the last frame, false when nothing is open or the frame is corrupt
+        uint64_t getTimelineFrame() const {return timelinePlayer.getFrame();}
+        uint64_t getTimelineFrameCount() const {return timelinePlayer.getFrameCount();}
+
+        // Scene Files
+        // The whole scene (instances, edges, meshes and the vertex/index pools) in one file, laid out the way the engine
+        // keeps it. Loading maps the file and copies every vector in one go, so a big scene loads about as fast as the
+        // disk reads it instead of going through addCircle one by one. Outlines come back, tweens don't
+        bool saveScene(const std::string& path) {return saveSceneFile(path, viewScene());} // false when the file can't be written
+        bool loadScene(const std::string& path); // replaces the scene, false (scene untouched) when it isn't a scene file
+
+        // Graph Loading
+        // Big node/edge list files straight into the scene, nodes become circles and edges edges. Both files get
+        // parsed in the background on the job system and show up a block at a time, the frame keeps going meanwhile.
+        // Clearing the circles or replacing the scene cancels a load that is still running. A graph with more nodes than
+        // the instance buffer has room for stops there, getGraphLoadProgress().truncated tells
+        bool loadGraph(const std::string& nodesPath, const std::string& edgesPath, const GraphLoadSettings& settings = {}); // false when a file can't be opened
+        GraphLoadProgress getGraphLoadProgress() const {return graphLoader.getProgress();}
+        void cancelGraphLoad() {graphLoader.cancel();} // what is in the scene already stays
+
+        // Tiled Datasets
+        // Point sets far bigger than memory or the instance buffer, packed offline by thing_tile_packer into a tile
+        // pyramid. Only the tiles the camera sees get read, on a background thread, and they are drawn as circles at
+        // the detail the zoom asks for. Those circles belong to the tile layer, it rewrites them whenever the view
+        // moves onto other tiles. Snapshots and scene files see them like any other circle
+        bool openTiles(const std::string& path); // false when it isn't a tile pyramid
+        void closeTiles(); // its circles go away
+        TileStreamStats getTileStats() const {return tileStreamer.getStats();}
+        void setTileCacheBudget(size_t bytes) {tileStreamer.setCacheBudget(bytes);}
+
+        // Snapshots
+        // Step back for interactive demos. Snapshots share the scene in fixed size chunks by reference count, taking one
+        // copies only the chunks written since the last one and restoring copies back only the chunks that differ.
+        // Handing out a whole vector (getInstanceVector, getEdgeVector) makes the next snapshot compare all of it.
+        // Past the budget the oldest snapshots get dropped, the newest stays. Tweens of a restored scene show their target
+        uint64_t takeSnapshot();
+        bool restoreSnapshot(uint64_t snapshot); // false when it got dropped
+        bool dropSnapshot(uint64_t snapshot) {return snapshotStore.drop(snapshot);}
+        bool hasSnapshot(uint64_t snapshot) const {return snapshotStore.contains(snapshot);}
+        void clearSnapshots() {snapshotStore.clear();}
+        void setSnapshotBudget(size_t bytes) {snapshotStore.setBudget(bytes);}
+        size_t getSnapshotMemory() const {return snapshotStore.getMemory();}
+
+        // GPU Physics
+        // Same Verlet + collision step as VerletSolver but in compute passes, circle positions stay on the GPU and
+        // basic.vert reads them directly. While enabled, positions written on the CPU only matter for new circles,
+        // resetGpuBodies() restarts every body from its instance. Readback is async, request it and poll for it
+        void setGpuPhysics(const GpuPhysicsSettings& settings) {app.gpuPhysics.setSettings(settings);}
+        GpuPhysicsSettings getGpuPhysics() {return app.gpuPhysics.getSettings();}
+        void stepGpuPhysics(float dt) {app.gpuPhysics.step(dt);} // one step per rendered frame
+        void resetGpuBodies() {app.gpuPhysics.reseed();}
+        void requestGpuPositions() {app.gpuPhysics.requestReadback();}
+        bool readGpuPositions(std::vector<glm::vec2>& positions); // false until a requested copy finished
+
+        // GPU Layout
+        // ForceLayout in compute passes for graphs too big for the CPU, on the same device local positions as GPU physics
+        // (it takes over while enabled) so the circle and edge draws read the result directly. Repulsion goes through a
+        // grid pyramid rebuilt every iteration, the edges are sent as CSR only when the graph changes. Readback works the same
+        void setGpuLayout(const GpuLayoutSettings& settings) {app.gpuPhysics.setLayout(settings);}
+        GpuLayoutSettings getGpuLayout() {return app.gpuPhysics.getLayout();}
+        void reheatGpuLayout(float temperature = 1.0f) {app.gpuPhysics.reheatLayout(temperature);} // after moving things by hand
+
+        // Spatial Queries
+        // Engine kept loose grid over every alive instance, refit on the first query after the scene could have changed
+        // (a new frame or any add/delete/get call). Circles and lines are tested against their shape, polygons against
+        // their bounds. With GPU physics on, circles are where the CPU last put them. out is cleared, returns the hits
+        size_t queryPoint(glm::vec2 point, std::vector<Entity>& out);
+        size_t queryRect(glm::vec2 min, glm::vec2 max, std::vector<Entity>& out);
+        size_t queryRadius(glm::vec2 center, float radius, std::vector<Entity>& out);
+        Entity nearest(glm::vec2 point, float maxDistance = std::numeric_limits<float>::max());
+
+        // GPU Picking
+        // Reads back what actually got drawn, pixel exact and the same cost for any scene size. Window coordinates like
+        // the mouse, max is exclusive. Returns a ticket (0 = region too big or too many picks waiting) and the result
+        // shows up one or two frames later in readPick, with the distinct entities under it (topmost only per pixel)
+        uint64_t pickAsync(glm::vec2 screenPos) {return app.pickManager.request(screenPos, screenPos);}
+        uint64_t pickRegionAsync(glm::vec2 min, glm::vec2 max) {return app.pickManager.request(min, max);}
+        bool readPick(uint64_t ticket, std::vector<Entity>& out); // false until the ticket is done
+
+        // Sub-pixel Circles
+        // Circles smaller than threshold pixels of radius on screen skip the quad draw, a compute pass puts each one on
+        // the pixel under its centre (the topmost wins) with its area as coverage. Picking and outlines still see them, 0 = off
+        void setSplatThreshold(float pixels) {app.splatThreshold = std::max(pixels, 0.0f);}
+        float getSplatThreshold() {return app.splatThreshold;}
+
+        // Heatmap
+        // Density (or average color) of every circle binned into a screen grid and drawn through a colormap, for point
+        // clouds too dense to read as circles. Crossfades with the circles between circleZoom and heatmapZoom, below
+        // that the circles aren't drawn at all. Entities stay circles for spatial queries, GPU picking only sees what got drawn
+        void setHeatmap(const HeatmapSettings& settings) {app.heatmapManager.setSettings(settings);}
+        HeatmapSettings getHeatmap() {return app.heatmapManager.getSettings();}
+
+        // Edges
+        // A line between two circles that the vertex shader reads both ends of from the circle instances, so moving a
+        // circle (on the CPU or with GPU physics) moves its edges for free. 16 bytes each instead of a whole LineData.
+        // Drawn right under the lower of its circles, deleting or clearing a circle deletes its edges before the slot can
+        // be handed out again. Only uploaded when one changed. Not entities, so not pickable and not in spatial queries
+        uint32_t addEdge(const Entity from, const Entity to, float thickness, glm::vec4 color); // INVALID_EDGE unless both are alive circles
+        bool deleteEdge(uint32_t edge);
+        EdgeData& getEdge(uint32_t edge);
+        std::span<EdgeData> getEdgeVector() {markAllWritten(TimelineStream::Edges); dirtyFlags.edges = true; return edges;}
+        void clearEdges();
+
+        // Text
+        // Strings drawn with the built-in distance field font (printable ASCII, monospaced, ThING/text/font.h), one quad
+        // per glyph. Glyphs are laid out only when the string changes, moving, recoloring or resizing a text rewrites its
+        // 64 byte record and nothing else. A label is anchored to a circle: it follows it (GPU physics and tweens too),
+        // draws over it and goes away with it like its edges. Pivot is the point
+        // of the text block on the position, {0.5,0.5} centred. Not entities, not pickable, and not part of snapshots,
+        // timelines or scene files. Past MAX_GLYPHS glyphs the rest of the strings aren't drawn
+        uint32_t addText(std::string_view text, glm::vec2 position, float size, glm::vec4 color, glm::vec2 pivot = {0.5f, 0.5f}); // INVALID_TEXT when MAX_TEXTS are alive
+        uint32_t addLabel(const Entity circle, std::string_view text, float size, glm::vec4 color, glm::vec2 offset = {0.0f, 0.0f}, 
+            glm::vec2 pivot = {0.5f, 0.5f}); // INVALID_TEXT unless circle is an alive circle
+        bool setText(uint32_t text, std::string_view string); // false when the text is gone
+        const std::string& getTextString(uint32_t text);
+        bool deleteText(uint32_t text);
+        TextData& getText(uint32_t text); // position, size, colors, outline, drawIndex, flags
+        std::span<TextData> getTextVector() {dirtyFlags.texts = true; return texts;}
+        void clearTexts();
+
         // Misc
-        void updateOutlines() {dirtyFlags.ssbo = true;}
         // void updateApiFlags(uint8_t flags) {} Add if needed
 
         void EXIT(){EXIT_ = true;}
@@ -69,31 +283,133 @@ namespace ThING{
         // Instance Creation Helper
         Entity addCircle(InstanceData&& instance);
         Entity addLine(LineData&& line);
+        void releaseOutlines(std::vector<uint32_t>& slots);
+        std::vector<uint32_t>& outlineSlots(InstanceType type);
+        uint32_t& outlineSlot(const Entity e);
+        void trackOutlineSlots();
+        void releaseTweens(std::span<InstanceData> instances);
+        void expireTweens();
+        void recordTimeline();
+        TimelineScene viewScene();
+        TimelineTarget sceneTarget();
+        void adoptScene(bool meshesChanged);
+        void rebuildFreeLists();
+        void dropCircleLinks();
+        void markWritten(const Entity e);
+        void markWritten(TimelineStream stream, uint32_t index);
+        void markAllWritten(TimelineStream stream);
+        void markInstancesWritten();
+        void drainEdits();
+        uint32_t editEpoch(InstanceType type) const;
+        void ingestGraph();
+        void streamTiles();
+        void storeViewExtent();
+        void applyView(const ViewState& state);
+        void applyEdit(const InstanceEdit& edit);
+        uint32_t placeText(TextData&& text, std::string_view string, glm::vec2 pivot);
+        void layoutGlyphs(uint32_t text);
+        void wasteGlyphs(uint32_t text);
+        void compactGlyphs();
+        const SpatialIndex& refitSpatialIndex();
+        void markSpatial(const Entity e);
         // void cleanRenderData(); add if a lot of death objects exists, right now I don't plan to use it
 
         void mainLoop();
 
+        // ApiFlags_ThreadedUpdate
+        void threadedMainLoop();
+        void updateLoop();
+        void stopUpdateThread();
+        void publishSnapshot();
+
         std::vector<InstanceData> circleInstances;
         std::vector<LineData> lineInstances;
         std::vector<InstanceData> polygonInstances;
         std::vector<MeshData> polygonMeshes;
+        std::vector<EdgeData> edges;
 
         std::vector<Entity> circleFreeList;
         std::vector<Entity> lineFreeList;
         std::vector<Entity> polygonFreeList;
+        std::vector<uint32_t> edgeFreeList;
+        std::vector<uint32_t> freedCircles; // deleted since the last dropCircleLinks, edges and labels still point at them
+
+        // Slot the outline manager handed to each instance, 0 = none. objectID only means the same thing after a resync,
+        // until then it is whatever the user wrote there, so releasing goes through these
+        std::vector<uint32_t> circleOutlineSlots;
+        std::vector<uint32_t> lineOutlineSlots;
+        std::vector<uint32_t> polygonOutlineSlots;
+
+        // Every text owns a run of glyphs, a string that grows past its run moves to the end and leaves the run dead
+        // until there is enough waste to pack them again
+        struct TextRun{
+            uint32_t first = 0;
+            uint32_t count = 0; // glyphs written, the rest of the run is DEAD_GLYPH
+            uint32_t capacity = 0;
+            glm::vec2 pivot = {0.5f, 0.5f};
+        };
+        std::vector<TextData> texts;
+        std::vector<GlyphData> glyphs;
+        std::vector<std::string> textStrings;
+        std::vector<TextRun> textRuns;
+        std::vector<uint32_t> textFreeList;
+        size_t glyphWaste = 0;
+
+        // Next index past the end of each vector in the low 32 bits, shared by addX and queueX so reserved handles never
+        // collide. The high 32 bits are the epoch, clearInstanceVector and adoptScene start a new one and restart the
+        // index, queued edits tagged with an older epoch get dropped instead of landing on whatever took their slot
+        std::atomic<uint64_t> circleReserved = 0;
+        std::atomic<uint64_t> lineReserved = 0;
+        std::atomic<uint32_t> polygonEpoch = 0; // polygons aren't queued, but edits to them can be
+        MpscQueue<InstanceEdit, MAX_QUEUED_EDITS> editQueue;
+        StepScheduler stepScheduler;
+        TimelineRecorder timelineRecorder;
+        TimelinePlayer timelinePlayer;
+        SnapshotStore snapshotStore;
+        GraphLoader graphLoader;
+        GraphLoader::Batch graphBatch; // kept so the batch vectors get reused
+        std::vector<uint32_t> graphNodes; // node number of the running load -> circle index
+        GraphLoadSettings graphSettings;
+        TileStreamer tileStreamer;
+        std::vector<uint32_t> tileSlots; // circles the tile layer draws into, all alive
+        std::atomic<uint64_t> viewExtent = 0; // swapchain width << 32 | height, the tiles are picked from the update side
+        std::atomic<uint64_t> windowSize = 0; // same packing, glfw can only be asked from the main thread
+        ViewState view; // written by the camera setters, the one the renderer uses lives in app
 
 
         std::function<void(ThING::API&, FPSCounter&)> updateCallback;
         std::function<void(ThING::API&, FPSCounter&)> uiCallback;
 
         DirtyFlags dirtyFlags;
+        SpatialIndex spatialIndex;
+        bool spatialStale = true; // everything gets refit, spatialDirty is ignored
+        std::vector<Entity> spatialDirty; // handed out by getInstance & co since the last refit
 
         ma_engine audioEngine;
+        SoundPool soundPool;
+        Synth synth;
         uint8_t volume;
         ProtoThiApp app;
 
         uint8_t apiFlags = 0;
 
-        bool EXIT_ = false;
+        // ApiFlags_ThreadedUpdate, sceneMutex guards everything the callbacks can touch, the render thread
+        // only reads snapshots. Both publishers hold sceneMutex so the triple buffer still has one writer at a time
+        TripleBuffer<SceneSnapshot> snapshots;
+        std::thread updateThread;
+        std::mutex sceneMutex;
+        std::atomic<bool> updateRunning = false;
+        std::atomic<bool> uiWaiting = false;
+        std::condition_variable uiDone; // the update thread waits on it (with sceneMutex) while the UI callback wants in
+        std::atomic<bool> updateFailed = false;
+        std::exception_ptr updateError;
+        uint64_t meshVersion = 0;
+        uint64_t outlineVersion = 0;
+        uint64_t tweenVersion = 0;
+        uint64_t textVersion = 0;
+        uint64_t glyphVersion = 0;
+        uint64_t edgeVersion = 0;
+
+        std::atomic<bool> EXIT_ = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ThING/consts.h"
+#include "ThING/types/apiTypes.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <miniaudio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @note Sounds decoded once into memory and played on a fixed set of voices, so playing one never opens a file or
+ * allocates. Every voice is an ma_sound started on its own data source, a new clip gets to it through an atomic the
+ * audio thread checks on every read, the voice never reaches the end on its own (it plays silence once the clip runs
+ * out) so starting it again can't race with miniaudio stopping it. Finished voices are stopped on the next play().
+ * When every voice is busy the one that started first is taken over. Not thread safe, one caller at a time
+ */
+class SoundPool{
+public:
+    SoundPool() = default;
+    ~SoundPool() {uninit();}
+    SoundPool(const SoundPool&) = delete;
+    SoundPool& operator=(const SoundPool&) = delete;
+
+    bool init(ma_engine* engine); // false when the voices can't be created, every other call fails then
+    void uninit(); // before the engine goes
+
+    SoundHandle load(const std::string& path); // same handle for the same path, INVALID_SOUND when it can't be decoded
+    bool play(SoundHandle sound, float volume, float pitch); // false for an unknown handle
+    void setVolume(float volume) {ma_sound_group_set_volume(&group, volume);}
+
+private:
+    // Decoded to the engine's format so the voices never convert anything
+    struct Clip{
+        std::vector<float> samples;
+        uint64_t frames = 0;
+    };
+
+    struct Voice{
+        ma_data_source_base base; // has to be first, miniaudio hands the voice back as a data source
+        ma_sound sound;
+        uint32_t channels = 0;
+        uint32_t sampleRate = 0;
+
+        // Written by play(), the clip slot is set before its request generation goes out
+        std::atomic<const Clip*> clip = nullptr;
+        std::atomic<uint32_t> requested = 0;
+        std::atomic<uint32_t> finished = 0; // generation the audio thread played to the end
+
+        // Audio thread only
+        const Clip* playing = nullptr;
+        uint32_t playingGeneration = 0;
+        uint64_t cursor = 0;
+
+        // play() only
+        bool started = false;
+        uint64_t order = 0;
+    };
+
+    static ma_result readVoice(ma_data_source* source, void* out, ma_uint64 frameCount, ma_uint64* framesRead);
+    static ma_result seekVoice(ma_data_source* source, ma_uint64 frame);
+    static ma_result voiceFormat(ma_data_source* source, ma_format* format, ma_uint32* channels, ma_uint32* sampleRate,
+        ma_channel* channelMap, size_t channelMapCap);
+    Voice& takeVoice();
+
+    ma_engine* engine = nullptr;
+    ma_sound_group group;
+    uint32_t voiceCount = 0; // initialized ones, so uninit after a failed init only touches those
+    std::array<Voice, MAX_SOUND_VOICES> voices;
+    std::array<std::unique_ptr<Clip>, MAX_LOADED_SOUNDS> clips; // fixed so the audio thread never sees them move
+    uint32_t clipCount = 0;
+    std::unordered_map<std::string, SoundHandle> handles;
+    uint64_t playCount = 0;
+};
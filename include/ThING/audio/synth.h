@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ThING/consts.h"
+#include "ThING/types/spscQueue.h"
+#include "ThING/types/tone.h"
+#include <array>
+#include <cstdint>
+#include <miniaudio.h>
+
+/**
+ * @note Oscillators mixed on the audio thread, for tones far too many and too short for sound files. A note is a
+ * ToneEvent pushed through a lock-free queue, the audio thread takes up to MAX_SYNTH_VOICES of them at the top of
+ * each read and gives each a voice (attack, hold for the duration, release), the rest wait for the next reads. Past
+ * MAX_SYNTH_VOICES the oldest voice is taken over from the level it is at, so it doesn't click. Nothing on the audio
+ * thread locks or allocates and a read never starts more than MAX_SYNTH_VOICES notes, so its cost is bounded however
+ * many come in. play() is the producer side, one thread at a time
+ */
+class Synth{
+public:
+    Synth() = default;
+    ~Synth() {uninit();}
+    Synth(const Synth&) = delete;
+    Synth& operator=(const Synth&) = delete;
+
+    bool init(ma_engine* engine); // false when the sound can't be created, play fails then
+    void uninit(); // before the engine goes
+
+    bool play(const ToneEvent& tone); // false when MAX_QUEUED_TONES are still waiting or a field is NaN or negative
+    void setVolume(float volume);
+
+private:
+    // What miniaudio sees, it has to start with the base
+    struct Source{
+        ma_data_source_base base;
+        Synth* synth;
+    };
+
+    struct Voice{
+        Waveform waveform = Waveform::Sine;
+        float phase = 0.0f; // 0..1
+        float step = 0.0f; // phase per frame
+        float volume = 0.0f;
+        float level = 0.0f; // envelope
+        uint64_t hold = 0; // frames left before the release
+        uint64_t order = 0;
+        bool active = false;
+    };
+
+    static ma_result readSource(ma_data_source* source, void* out, ma_uint64 frameCount, ma_uint64* framesRead);
+    static ma_result seekSource(ma_data_source* source, ma_uint64 frame);
+    static ma_result sourceFormat(ma_data_source* source, ma_format* format, ma_uint32* channels, ma_uint32* sampleRate,
+        ma_channel* channelMap, size_t channelMapCap);
+    void render(float* out, uint64_t frames);
+    void start(const ToneEvent& tone);
+
+    ma_engine* engine = nullptr;
+    Source source;
+    ma_sound sound;
+    uint32_t channels = 0;
+    uint32_t sampleRate = 0;
+    bool started = false; // the sound only starts running with the first note
+    SpscQueue<ToneEvent, MAX_QUEUED_TONES> queue;
+
+    // Audio thread only
+    std::array<Voice, MAX_SYNTH_VOICES> voices{};
+    uint32_t activeVoices = 0;
+    uint64_t toneCount = 0;
+};
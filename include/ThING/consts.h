@@ -8,9 +8,84 @@ inline constexpr uint32_t WIDTH = 1200;
 inline constexpr uint32_t HEIGHT = 800;
 inline constexpr const char* TITLE = "Vulkan";
 inline constexpr size_t MAX_FRAMES_IN_FLIGHT = 3;
+inline constexpr VkFormat ID_IMAGE_FORMAT = VK_FORMAT_R32G32B32A32_SINT; // objectID, drawIndex, pick id (instance + 1), unused
 
 //BufferManager.cpp
 inline constexpr size_t BUFFER_PADDING = static_cast<size_t>(sizeof(Vertex)) * static_cast<size_t>(sizeof(InstanceData));
 inline constexpr size_t MAX_INDIRECT_COMMANDS = 0x10000; //around 65000 If you want more polygons just type more doesn't really matter 
 inline constexpr uint32_t MAX_SSBO_OBJECTS = 0x100000 * sizeof(SSBO); // around 1 Million If you want more (it literally can't take more), type more
-inline constexpr uint32_t MAX_INSTANCED_OBJECTS = 0x100000 * sizeof(InstanceData);
\ No newline at end of file
+inline constexpr uint32_t MAX_INSTANCED_OBJECTS = 0x100000 * sizeof(InstanceData);
+inline constexpr size_t INSTANCE_COPY_GRAIN = 0x4000; // instances per upload job, ~1.3MB
+inline constexpr size_t INDIRECT_BUILD_GRAIN = 0x1000;
+inline constexpr uint32_t MAX_PHYSICS_BODIES = MAX_INSTANCED_OBJECTS / sizeof(InstanceData); // one per circle the instance buffer can hold
+inline constexpr uint32_t PHYSICS_BODY_SIZE = 24; // Body in physics.comp
+inline constexpr uint32_t PHYSICS_HASH_CELLS = 0x40000; // power of two, has to match physics.comp
+inline constexpr uint32_t PHYSICS_CELL_CAPACITY = 15; // same, a cell takes 16 uints with its counter
+inline constexpr uint32_t MAX_EDGES = 0x100000; // around 1 Million per frame buffer, past that they just aren't drawn
+inline constexpr uint32_t MAX_TEXTS = 0x40000; // around 260k strings per frame buffer, same
+inline constexpr uint32_t MAX_GLYPHS = 0x100000; // around 1 Million characters per frame buffer, same
+inline constexpr uint32_t LAYOUT_GRID_LEVELS = 9; // finest pyramid level is 512 x 512 cells, has to match layout.comp
+inline constexpr uint32_t LAYOUT_FINEST_CELLS = 1u << (2 * LAYOUT_GRID_LEVELS);
+inline constexpr uint32_t LAYOUT_TREE_CELLS = ((1u << (2 * (LAYOUT_GRID_LEVELS + 1))) - 1) / 3; // every level
+inline constexpr uint32_t LAYOUT_ACCUM_HEADER = 4; // uints of bounds before the finest cells, same
+inline constexpr uint32_t LAYOUT_ADJACENCY_SIZE = MAX_PHYSICS_BODIES + 1 + 2 * MAX_EDGES; // uints, CSR offsets then neighbours
+inline constexpr uint32_t LAYOUT_SUM_SCALE = 1024; // fixed point of the cell sums, has to match layout.comp
+static_assert(static_cast<uint64_t>(MAX_PHYSICS_BODIES) * LAYOUT_SUM_SCALE <= UINT32_MAX, "every body in one cell has to fit a uint");
+inline constexpr float LAYOUT_MIN_TEMPERATURE = 0.002f; // same as ForceLayout, cooling stops there
+inline constexpr uint32_t MAX_TWEENS = 0x10000; // entities animating at once, past that animate() just jumps to the target
+inline constexpr uint32_t SPLAT_TEXEL_SIZE = 2 * sizeof(uint32_t); // depth key + instance per pixel, splat.comp
+
+//pickManager.cpp
+inline constexpr uint32_t MAX_PICKS_PER_FRAME = 16;
+inline constexpr uint32_t MAX_PENDING_PICKS = 64;
+inline constexpr uint32_t MAX_READY_PICKS = 256; // finished picks nobody read, the oldest get dropped
+inline constexpr uint32_t MAX_PICK_TEXELS = 0x40000; // per frame, a 512x512 region
+inline constexpr uint32_t PICK_TEXEL_SIZE = 4 * sizeof(int32_t); // one ID_IMAGE_FORMAT texel
+
+//heatmapManager.cpp
+inline constexpr uint32_t HEATMAP_LUT_SIZE = 64; // colormap entries in the heatmap uniform, user stops get resampled to it
+inline constexpr uint32_t HEATMAP_GRID_HEADER = 4; // uints before the cells, [0] = densest cell of the frame
+inline constexpr uint32_t HEATMAP_CELL_SIZE = 4 * sizeof(uint32_t); // count, red, green, blue sums
+
+//mainLoop.cpp
+inline constexpr float DEFAULT_SPLAT_THRESHOLD = 0.5f; // pixels of radius on screen, smaller circles get splatted
+
+//timelineRecorder.cpp
+inline constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 60; // frames, seeking applies at most this many deltas
+inline constexpr size_t TIMELINE_DIFF_GRAIN = 0x4000; // elements compared per job
+inline constexpr size_t TIMELINE_MAX_QUEUED_BYTES = 0x10000000; // 256MB of frames waiting for the writer, capture waits past it
+
+//snapshotStore.cpp
+inline constexpr size_t SNAPSHOT_CHUNK_BYTES = 0x10000; // rounded down to whole elements of each stream
+inline constexpr size_t DEFAULT_SNAPSHOT_BUDGET = 0x10000000; // 256MB of chunks, older snapshots get dropped past it
+
+//sceneFile.cpp
+inline constexpr size_t SCENE_LOAD_GRAIN = 0x100000; // bytes copied out of the mapping per job
+inline constexpr size_t SCENE_VALIDATE_GRAIN = 0x4000; // meshes or edges checked per job before loading
+
+//graphLoader.cpp
+inline constexpr size_t GRAPH_BLOCK_BYTES = 0x2000000; // 32MB of text per batch handed to the scene
+inline constexpr size_t GRAPH_SLICE_BYTES = 0x100000; // per parse job, rounded up to the next line break
+inline constexpr uint64_t GRAPH_DENSE_IDS = 0x1000000; // ids below it are looked up in a flat table, above in a hash map
+inline constexpr size_t GRAPH_MAX_READY_BATCHES = 8; // parsed but not taken, the driver waits past it
+
+//tileStreamer.cpp
+inline constexpr float TILE_POINT_PIXELS = 4.0f; // spacing of aggregated points on screen the level is picked for
+inline constexpr uint64_t TILE_MAX_VISIBLE_POINTS = 0x80000; // worst case of the tiles in view, past it a coarser level is used
+inline constexpr size_t DEFAULT_TILE_CACHE_BUDGET = 0x10000000; // 256MB of tiles, least recently drawn go first
+
+//soundPool.cpp
+inline constexpr uint32_t MAX_SOUND_VOICES = 32; // sounds playing at once, past it the oldest gets cut
+inline constexpr uint32_t MAX_LOADED_SOUNDS = 1024; // distinct files loadSound can keep decoded
+
+//synth.cpp
+inline constexpr uint32_t MAX_SYNTH_VOICES = 64; // tones ringing at once, past it the oldest gets cut
+inline constexpr size_t MAX_QUEUED_TONES = 0x1000; // waiting for the audio thread, has to be a power of two
+inline constexpr float SYNTH_ATTACK_SECONDS = 0.004f; // short ramps so notes don't click
+inline constexpr float SYNTH_RELEASE_SECONDS = 0.03f;
+
+//api.cpp
+inline constexpr size_t MAX_QUEUED_EDITS = 0x10000; // per frame, has to be a power of two
+inline constexpr size_t GRAPH_INGEST_GRAIN = 0x4000; // loaded nodes or edges written per job
+inline constexpr size_t TEXT_COMPACT_GLYPHS = 0x1000; // glyphs left behind by strings that grew before they get packed
+inline constexpr size_t MAX_SPATIAL_DIRTY = 0x1000; // entities handed out between queries, past it the whole index refits
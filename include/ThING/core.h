@@ -12,6 +12,16 @@
 #include <ThING/window/windowManager.h>
 #include <ThING/graphics/swapChainManager.h>
 #include <ThING/graphics/commandBufferManager.h>
+#include <ThING/graphics/outlineManager.h>
+#include <ThING/graphics/tweenManager.h>
+#include <ThING/graphics/pickManager.h>
+#include <ThING/graphics/heatmapManager.h>
+#include <ThING/threading/jobSystem.h>
+#include <ThING/physics/gpuPhysics.h>
+#include <ThING/types/frameStats.h>
+#include <ThING/types/sceneSnapshot.h>
+#include <array>
+#include <chrono>
 
 namespace ThING{
     class API;
@@ -34,6 +44,12 @@ private:
     PipelineManager pipelineManager;
     SwapChainManager swapChainManager;
     CommandBufferManager commandBufferManager;
+    OutlineManager outlineManager;
+    TweenManager tweenManager;
+    JobSystem jobSystem;
+    GpuPhysics gpuPhysics;
+    PickManager pickManager;
+    HeatmapManager heatmapManager;
 
     VkInstance instance;
     VkDebugUtilsMessengerEXT debugMessenger;
@@ -46,13 +62,26 @@ private:
 
     uint32_t currentFrame;
 
+    // Frame pacing, a slot is reused once the frame timeline reaches the value it was submitted with
+    uint64_t frameTimelineValue = 0;
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> slotTimelineValues{};
+    std::array<std::chrono::steady_clock::time_point, MAX_FRAMES_IN_FLIGHT> slotBeginTimes{};
+    std::chrono::steady_clock::time_point frameBegin;
+    FrameStats frameStats;
+
     VkDescriptorPool imguiDescriptorPool;
 
     std::vector<Vertex> vertices;
     std::vector<uint16_t> indices;
 
     WorldData worldData;
+    std::vector<VkDrawIndexedIndirectCommand> indirectCommands; // kept so the capacity is reused every frame
     uint32_t indirectCommandCount;
+    PhysicsFrame physicsFrame;
+    PickFrame pickFrame;
+    uint32_t splatCircles = 0;
+    float smallestCircle = 0.0f; // radius of the smallest alive circle, rescanned with every circle upload
+    HeatmapFrame heatmapFrame;
     /* I really don't like this being here, it is calculated once per frame in mainLoop, but since I need this info I need
         a variable here... I think I really need that renderer class more every day, but I really want to get this donde right now
           so that's just life, move it later to a renderer class later maybe... */
@@ -62,16 +91,25 @@ private:
     glm::vec2 offset;
     std::vector<VkClearValue> clearColor;
     uint32_t maxOutlineSize = 0;
+    float splatThreshold = DEFAULT_SPLAT_THRESHOLD;
 
     void initVulkan(VkPresentModeKHR prefferedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR);
     void initImGui();
     void mainLoop();
     
+    void beginFrame();
+    void waitForFrameSlot();
     void renderFrame();
     void cleanup();
 
     void recordWorldData(std::span<InstanceData> circleInstances, std::span<InstanceData> polygonInstances, 
-        std::span<InstanceData> lineInstances, std::span<MeshData> meshes, DirtyFlags dirtyFlags);
+        std::span<InstanceData> lineInstances, std::span<MeshData> meshes, std::span<const EdgeData> edges, std::span<const TextData> texts, 
+        std::span<const GlyphData> glyphs, DirtyFlags dirtyFlags);
+    void recordSnapshot(SceneSnapshot& snapshot, DirtyFlags dirtyFlags);
+    void syncOutlines(std::span<InstanceData> circleInstances, std::span<InstanceData> lineInstances, 
+        std::span<InstanceData> polygonInstances);
+    bool adoptOutlines(std::span<InstanceData> circleInstances, std::span<InstanceData> lineInstances, 
+        std::span<InstanceData> polygonInstances);
     
     void createInstance();
     void pickPhysicalDevice();
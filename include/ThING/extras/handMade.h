@@ -1,6 +1,9 @@
 #pragma once
 #include <concepts>
+#include <cstddef>
 #include <random>
+#include <span>
+#include <string>
 
 extern std::random_device rd;
 extern std::mt19937 rng;
@@ -25,4 +28,26 @@ T getRandomNumber(T min, T max) {
 
 namespace osd{
     std::string getExecutableDir();
+
+    // Read only view of a whole file, pages come in on first touch. Move only, unmaps on destruction
+    class MappedFile{
+    public:
+        MappedFile() = default;
+        ~MappedFile() {close();}
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path); // false when it can't be mapped, an empty file opens with an empty view
+        void close();
+
+        bool isOpen() const {return data != nullptr;} // false for an empty file, nothing is mapped
+        std::span<const std::byte> view() const {return {data, size};}
+
+    private:
+        const std::byte* data = nullptr;
+        size_t size = 0;
+        void* mapping = nullptr; // Windows only, the mapping object behind the view
+    };
 }
\ No newline at end of file
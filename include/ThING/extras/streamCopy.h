@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+
+// memcpy with non-temporal stores, meant for write-combined mappings where normal stores would read
+// the destination lines into the cache first. Plain memcpy when SSE2 isn't there.
+void streamCopy(void* dst, const void* src, size_t bytes);
@@ -4,6 +4,9 @@
 #include <ThING/consts.h>
 #include <ThING/types/dynamicBuffer.h>
 #include <ThING/types/uniformBufferObject.h>
+#include <ThING/types/heatmap.h>
+#include <ThING/types/renderImage.h>
+#include <ThING/threading/jobSystem.h>
 
 class BufferManager{
 public:
@@ -11,29 +14,59 @@ public:
     BufferManager(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue);
     void createBuffers();
 
-    void updateCustomBuffers(std::span<Vertex> vertices, std::span<uint16_t> indices, WorldData& worldData, std::span<VkFence> inFlightFences, uint32_t frameIndex);
-    void updateIndirectBuffers(std::span<const VkDrawIndexedIndirectCommand> commands, std::vector<VkFence>& inFlightFences, uint32_t frameIndex);
-    void updateUniformBuffers(const VkExtent2D& swapChainExtent, float zoom, glm::vec2 offset, uint32_t frameIndex);
+    // Every update* call writes the resources of frameIndex only, the caller has to wait for that frame slot first
+    void updateCustomBuffers(std::span<Vertex> vertices, std::span<uint16_t> indices, WorldData& worldData, uint32_t frameIndex, JobSystem& jobs);
+    uint32_t updateIndirectBuffers(std::span<const VkDrawIndexedIndirectCommand> commands, uint32_t frameIndex);
+    void updateUniformBuffers(const VkExtent2D& swapChainExtent, float zoom, glm::vec2 offset, uint32_t physicsBodyCount, 
+        float splatThreshold, float circleAlpha, float time, uint32_t frameIndex);
+    void updateHeatmapUniform(const HeatmapUniform& uniform, uint32_t frameIndex);
+    // The splat buffer has one texel per pixel and only ever grows, call before recording a frame of that extent
+    void reserveSplatBuffer(const VkExtent2D& extent);
+    void reserveHeatmapGrid(uint32_t cells); // same for the heatmap grid
     void cleanUp();
     const Buffer& viewBuffer(BufferType type, size_t index) const;
     std::span<const Buffer, MAX_FRAMES_IN_FLIGHT> viewBuffers(BufferType type) const;
+
+    // GPU physics readback of frameIndex, only valid once that frame finished on the GPU
+    inline const glm::vec2* viewPhysicsReadback(uint32_t frameIndex) const {return static_cast<const glm::vec2*>(physicsReadbackMapped[frameIndex]);}
+    // GPU layout adjacency staged for frameIndex, the caller has to wait for that frame slot first
+    inline uint32_t* getLayoutStaging(uint32_t frameIndex) {return static_cast<uint32_t*>(layoutStagingMapped[frameIndex]);}
+    // Id image texels copied by the picks of frameIndex, 4 ints each, same rule
+    inline const int32_t* viewPickReadback(uint32_t frameIndex) const {return static_cast<const int32_t*>(pickReadbackMapped[frameIndex]);}
+    inline const RenderImage& viewGlyphAtlas() const {return glyphAtlas;}
+
+    // Instance upload of the last updateCustomBuffers call
+    inline uint64_t getUploadBytes() const {return uploadBytes;}
+    inline float getUploadTime() const {return uploadTime;} // ms
 private:
+    void uploadInstances(InstanceData* dst, std::span<const InstanceData> src, JobSystem& jobs);
+    template <typename T>
+    void uploadRecords(void* mapped, std::span<const T> src, JobSystem& jobs);
 
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 
     void createCustomBuffers();
     void createIndirectBuffers();
     void createUniformBuffers();
+    void createPhysicsBuffers();
+    void createLayoutBuffers();
+    void createPickBuffers();
+    void createSplatBuffer(uint32_t pixels);
+    void createHeatmapBuffers(uint32_t cells);
+    void createHeatmapGridBuffer(uint32_t cells);
+    void createGlyphAtlas();
 
     void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
     void uploadBuffer(VkDeviceSize bufferSize, VkBuffer *buffer, void* bufferData);
-    void updateBuffer(VkFence& inFlightFences, const void* data, VkDeviceSize newBufferSize, 
+    void updateBuffer(const void* data, VkDeviceSize newBufferSize, 
         uint32_t frameIndex, VkBufferUsageFlags usage, BufferType type);
 
     Buffer& getBuffer(BufferType type, size_t index);
     std::array<Buffer, MAX_FRAMES_IN_FLIGHT>& getBuffers(BufferType type);
 
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    bool hasMemoryType(VkMemoryPropertyFlags properties);
+    VkMemoryPropertyFlags readbackMemoryFlags();
 
 
     std::vector<Buffer> buffers;
@@ -44,9 +77,26 @@ private:
 
     std::vector<DynamicBuffer<MAX_FRAMES_IN_FLIGHT>> stagingBuffers;
     UniformBufferObject ubo;
-    Buffer ssbo;
-    void* ssboMapped;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> ssboMapped;
+    std::array<std::vector<uint32_t>, MAX_FRAMES_IN_FLIGHT> pendingSsboSlots;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> tweenMapped;
+    std::array<std::vector<uint32_t>, MAX_FRAMES_IN_FLIGHT> pendingTweenSlots;
     std::array<void*, MAX_FRAMES_IN_FLIGHT> instancedMapped;
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> pendingCircles = {}; // with GPU physics the circles are only uploaded when they changed
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> edgeMapped;
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> pendingEdges = {};
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> textMapped;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> glyphMapped;
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> pendingTexts = {};
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> pendingGlyphs = {};
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> indirectMapped;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> physicsReadbackMapped;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> layoutStagingMapped;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> pickReadbackMapped;
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> heatmapUniformMapped;
+    bool instanceWriteCombined = false; // host visible memory without HOST_CACHED, gets streaming stores
+    uint64_t uploadBytes = 0;
+    float uploadTime = 0.0f;
     
     std::array<Buffer, MAX_FRAMES_IN_FLIGHT> vertexBuffers;
     std::array<Buffer, MAX_FRAMES_IN_FLIGHT> indexBuffers;
@@ -54,5 +104,27 @@ private:
     Buffer quadVertexBuffer;
     Buffer quadIndexBuffer;
     std::array<Buffer, MAX_FRAMES_IN_FLIGHT> instanceBuffers;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> edgeBuffers;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> textBuffers;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> glyphBuffers;
     std::array<Buffer, MAX_FRAMES_IN_FLIGHT> indirectBuffers;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> ssboBuffers;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> tweenBuffers;
+
+    // GPU physics, device local and shared by every frame since the GPU runs the frames in order
+    Buffer physicsPositionBuffer;
+    Buffer physicsBodyBuffer;
+    Buffer physicsGridBuffer;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> physicsReadbackBuffers;
+    Buffer layoutAccumBuffer;
+    Buffer layoutTreeBuffer;
+    Buffer layoutAdjacencyBuffer;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> layoutStagingBuffers;
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> pickReadbackBuffers;
+    Buffer splatBuffer;
+    uint32_t splatCapacity = 0; // pixels
+    Buffer heatmapGridBuffer;
+    uint32_t heatmapCapacity = 0; // cells
+    std::array<Buffer, MAX_FRAMES_IN_FLIGHT> heatmapUniformBuffers;
+    RenderImage glyphAtlas; // built-in font, uploaded once (ThING/text/font.h)
 };
\ No newline at end of file
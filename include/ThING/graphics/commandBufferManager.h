@@ -11,10 +11,13 @@ public:
     CommandBufferManager();
     void createCommandPool(VkPhysicalDevice& physicalDevice, VkDevice& device, VkSurfaceKHR& surface);
     void createCommandBuffers(VkDevice& device, VkSurfaceKHR& surface);
+    void createQueryPool(VkPhysicalDevice& physicalDevice, VkDevice& device, VkSurfaceKHR& surface);
+    bool readGpuTime(VkDevice& device, uint32_t currentFrame, float& gpuTime);
     void recordCommandBuffer(uint32_t currentFrame, const RenderContext& renderContext, const FrameContext& frameContext);
     
     void cleanUpCommandBuffers(VkDevice& device);
     void cleanUpCommandPool(VkDevice& device);
+    void cleanUpQueryPool(VkDevice& device);
 
     const VkCommandPool& viewCommandPool(){return commandPool;};
     const VkCommandBuffer& viewCommandBufferOnFrame(uint32_t currentFrame){return commandBuffers[currentFrame];};
@@ -34,12 +37,28 @@ private:
 
     void recordInstanceDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const DrawBatch& drawBatch);
     void recordIndirectDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, uint32_t commandCount);
+    void recordEdgeDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
+    void recordTextDraw(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
 
     void recordJFAPass(VkCommandBuffer& commandBuffer, const FrameContext& frameContext, uint32_t currentFrame, uint32_t maxOutlineSize);
     void cmdDispatchJFA(VkCommandBuffer& commandBuffer, const FrameContext& frameContext);
     void cmdBindComputePipeline(VkCommandBuffer& commandBuffer, const FrameContext& frameContext, uint32_t currentFrame);
     void cmdPipelineBarrier(VkCommandBuffer& commandBuffer, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkImageMemoryBarrier& barrier);
 
+    void recordPhysicsPass(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
+    void recordLayoutPasses(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
+    void recordSplatPass(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
+    void recordHeatmapPass(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
+    void cmdMemoryBarrier(VkCommandBuffer& commandBuffer, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
+        VkAccessFlags srcAccess, VkAccessFlags dstAccess);
+
+    void recordPickCopy(VkCommandBuffer& commandBuffer, const RenderContext& renderContext, const FrameContext& frameContext);
+
     std::vector<VkCommandBuffer> commandBuffers;
     VkCommandPool commandPool;
+
+    // 2 timestamps per frame slot (begin, end), only used when the graphics queue supports them
+    VkQueryPool timestampPool = VK_NULL_HANDLE;
+    float timestampPeriod = 0.0f;
+    uint64_t timestampMask = 0;
 };
\ No newline at end of file
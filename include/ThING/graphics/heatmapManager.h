@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ThING/types/heatmap.h>
+#include <cstdint>
+#include <mutex>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @note Aggregate render mode for point clouds too dense for single circles. heatmap.comp bins every circle into a
+ * grid at cellSize pixels with atomics and the post pass maps it through a colormap, crossfading with the circles
+ * by zoom, so the scene keeps its normal instances. The public side can be called from the update thread, frame()
+ * runs on the render thread under the same lock.
+ */
+class HeatmapManager{
+public:
+    void setSettings(const HeatmapSettings& settings);
+    HeatmapSettings getSettings();
+
+    // Render thread, uniform is only written when the returned frame has circles
+    HeatmapFrame frame(float zoom, VkExtent2D extent, uint32_t circleCount, HeatmapUniform& uniform);
+
+private:
+    void buildLut();
+
+    std::mutex mutex;
+    HeatmapSettings settings;
+    std::array<glm::vec4, HEATMAP_LUT_SIZE> lut{};
+    bool lutBuilt = false;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ThING/types/renderData.h"
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+
+/**
+ * @note Outline slots are the objectID the post pass uses to index the outline SSBO.
+ * Slots are handed out densely by this class, so the SSBO only grows with the amount of
+ * outlined objects and not with the biggest ID someone picked. Slot 0 is reserved for "no outline".
+ */
+class OutlineManager{
+public:
+    OutlineManager();
+
+    uint32_t acquire();
+    void retain(uint32_t slot);
+    void release(uint32_t slot);
+    void write(uint32_t slot, const SSBO& data);
+    void reset();
+
+    // Takes the exact slot an instance already carries instead of handing one out, for scenes that come back with
+    // their objectIDs (timeline playback). reset() first, fillFreeSlots() once every instance claimed its slot
+    bool claim(uint32_t slot); // false past the last slot the SSBO can hold
+    void fillFreeSlots();
+
+    bool isLive(uint32_t slot) const;
+    bool isShared(uint32_t slot) const; // more than one instance holds it, writing it changes all of them
+    float getMaxOutlineSize() const;
+
+    inline std::span<const SSBO> viewSlots() const {return slots;}
+    inline std::span<const uint32_t> viewDirtySlots() const {return dirtySlots;}
+    void clearDirty();
+
+private:
+    void markDirty(uint32_t slot);
+    void trackSize(const SSBO& data, int32_t delta);
+
+    std::vector<SSBO> slots;
+    std::vector<uint32_t> slotRefs; // 0 = free
+    std::vector<uint32_t> freeSlots;
+
+    std::vector<uint8_t> dirtyMarks;
+    std::vector<uint32_t> dirtySlots;
+
+    std::map<float, uint32_t> sizeCounts; // running max without rescanning, only enabled slots are counted
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ThING/consts.h>
+#include <ThING/types/apiTypes.h>
+#include <ThING/types/pick.h>
+#include <ThING/types/renderData.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+class BufferManager;
+
+/**
+ * @note Asynchronous picking on the id image. basic.frag writes instance index + 1 into its third channel, every
+ * pick asked for during a frame gets copied out of it right after the base pass of the next recorded frame and is
+ * decoded into entities once that frame finished on the GPU, so results show up one or two frames later. The
+ * public side can be called from the update thread, the render thread takes the same lock in frame() and submitted().
+ */
+class PickManager{
+public:
+    // Window coordinates, max is exclusive. 0 when the region is bigger than MAX_PICK_TEXELS or too many picks wait
+    uint64_t request(glm::vec2 min, glm::vec2 max);
+    // true once the ticket is done, out gets the distinct entities drawn inside it. A ticket is only handed out once
+    bool read(uint64_t ticket, VkDevice device, VkSemaphore frameTimeline, const BufferManager& bufferManager, std::vector<Entity>& out);
+
+    // Render thread, frameIndex has to be waited on already
+    PickFrame frame(uint32_t frameIndex, glm::vec2 framebufferScale, VkExtent2D imageExtent, const WorldData& worldData, const BufferManager& bufferManager);
+    void submitted(uint32_t frameIndex, uint64_t timelineValue);
+
+private:
+    struct Slot{
+        PickFrame picks;
+        uint64_t timelineValue = 0; // 0 = recorded but not submitted yet
+        uint32_t circleCount = 0;
+        uint32_t polygonOffset = 0;
+    };
+
+    bool clampRegion(PickRegion& region) const;
+    void harvest(uint32_t frameIndex, const BufferManager& bufferManager);
+    void finish(uint64_t ticket, std::vector<Entity>&& hits);
+
+    std::mutex mutex;
+    uint64_t nextTicket = 1;
+    std::deque<PickRegion> pending;
+    std::array<Slot, MAX_FRAMES_IN_FLIGHT> slots{};
+
+    // Last frame's mapping from window coordinates to id image texels
+    glm::vec2 scale = {1.0f, 1.0f};
+    VkExtent2D extent{};
+
+    std::unordered_map<uint64_t, std::vector<Entity>> ready;
+    std::deque<uint64_t> readyOrder;
+};
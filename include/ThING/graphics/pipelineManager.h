@@ -33,6 +33,10 @@ public:
     inline std::span<const VkPipeline> viewPipelines() const {return pipelines;}
     inline std::span<const std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT>> viewDescriptorSets() const {return graphicsDescriptorSets;}
     inline std::span<const VkDescriptorSet> viewJFADescriptorSets() const {return JFADescriptorSets;}
+    inline std::span<const VkDescriptorSet> viewPhysicsDescriptorSets() const {return physicsDescriptorSets;}
+    inline std::span<const VkDescriptorSet> viewLayoutDescriptorSets() const {return layoutDescriptorSets;}
+    inline std::span<const VkDescriptorSet> viewSplatDescriptorSets() const {return splatDescriptorSets;}
+    inline std::span<const VkDescriptorSet> viewHeatmapGridDescriptorSets() const {return heatmapGridDescriptorSets;}
     
 private:
     void createDescriptorSetLayouts();
@@ -43,6 +47,14 @@ private:
     void createBaseGraphicsPipeline();
     void createPostGraphicsPipeline();
     void createJFAPipeline();
+    void createPhysicsPipeline();
+    void createLayoutPipeline();
+    void createSplatPipeline();
+    void createSplatResolvePipeline();
+    void createHeatmapPipeline();
+    void createHeatmapGridPipeline();
+    void createEdgePipeline();
+    void createTextPipeline();
 
 
     void createBaseRenderPass(const VkFormat& swapChainImageFormat);
@@ -53,12 +65,22 @@ private:
     void updateJFADescriptorSet(uint32_t currentFrame, SwapChainManager& swapChainManager);
     void writeJFADescriptorSet( uint32_t frameIndex, const RenderImage& ping, const RenderImage& pong, const RenderImage& idImage, const RenderImage& seedImage);
 
+    void createPhysicsDescriptorSets(BufferManager& bufferManager);
+    void createLayoutDescriptorSets(BufferManager& bufferManager);
+    void createSplatDescriptorSets(BufferManager& bufferManager);
+    void updateSplatDescriptorSet(uint32_t currentFrame, BufferManager& bufferManager);
+    void createHeatmapDescriptorSets(BufferManager& bufferManager);
+    void createHeatmapGridDescriptorSets(BufferManager& bufferManager);
+    void updateHeatmapDescriptorSets(uint32_t currentFrame, BufferManager& bufferManager);
+    void createTextDescriptorSets(BufferManager& bufferManager);
+
     void createDescriptorSet(BufferManager& bufferManager, SwapChainManager& swapChainManager, PipelineType type);
     void updateDescriptorSet(uint32_t currentFrame, BufferManager& bufferManager, SwapChainManager& swapChainManager, uint32_t imageIndex, PipelineType type);
 
     void createDescriptorPool();
     
     void createIdSampler();
+    void createAtlasSampler();
     
     VkShaderModule createShaderModule(std::span<const uint32_t> code);
 
@@ -68,14 +90,21 @@ private:
     std::array<VkDescriptorSetLayout, toIndex(PipelineType::Count)> descriptorSetLayouts;
     std::array<std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT>, GRAPHICS_PIPELINE_COUNT> graphicsDescriptorSets; // Change to graphicsDescriptorSets use PipeLineType::Count and new computePipelineCount Const
     std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> JFADescriptorSets;
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> physicsDescriptorSets; // only the instance buffer changes per frame
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> layoutDescriptorSets; // same
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> splatDescriptorSets;
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> heatmapGridDescriptorSets;
     VkDescriptorPool descriptorPool;
     VkDevice device;
     VkSampler idSampler;
+    VkSampler atlasSampler; // linear, the glyph atlas is a distance field
 
     inline static constexpr DescriptorBindingDesc baseBindings[] = {
         {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT},
         {DescriptorType::CombinedImageSampler, 1, VK_SHADER_STAGE_FRAGMENT_BIT},
-        {DescriptorType::CombinedImageSampler, 2, VK_SHADER_STAGE_FRAGMENT_BIT}
+        {DescriptorType::CombinedImageSampler, 2, VK_SHADER_STAGE_FRAGMENT_BIT},
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_VERTEX_BIT}, // GPU physics positions
+        {DescriptorType::StorageBuffer, 4, VK_SHADER_STAGE_VERTEX_BIT}  // tweens
     };
 
     inline static constexpr DescriptorBindingDesc postBindings[] = {
@@ -85,6 +114,33 @@ private:
         {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_FRAGMENT_BIT}
     };
 
+    inline static constexpr DescriptorBindingDesc splatResolveBindings[] = {
+        {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_FRAGMENT_BIT},
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_FRAGMENT_BIT}, // splat buffer
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_FRAGMENT_BIT}  // instances of the frame
+    };
+
+    inline static constexpr DescriptorBindingDesc heatmapBindings[] = {
+        {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_FRAGMENT_BIT}, // heatmap uniform
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_FRAGMENT_BIT}  // grid
+    };
+
+    inline static constexpr DescriptorBindingDesc edgeBindings[] = {
+        {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_VERTEX_BIT},
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_VERTEX_BIT}, // instances of the frame
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_VERTEX_BIT}, // GPU physics positions
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_VERTEX_BIT}  // tweens
+    };
+
+    inline static constexpr DescriptorBindingDesc textBindings[] = {
+        {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_VERTEX_BIT},
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_VERTEX_BIT}, // texts of the frame
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_VERTEX_BIT}, // instances of the frame, for anchors
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_VERTEX_BIT}, // GPU physics positions
+        {DescriptorType::StorageBuffer, 4, VK_SHADER_STAGE_VERTEX_BIT}, // tweens
+        {DescriptorType::CombinedImageSampler, 5, VK_SHADER_STAGE_FRAGMENT_BIT} // glyph atlas
+    };
+
     inline static constexpr DescriptorBindingDesc JFABindings[] = {
         {DescriptorType::StorageImage, 0, VK_SHADER_STAGE_COMPUTE_BIT},
         {DescriptorType::StorageImage, 1, VK_SHADER_STAGE_COMPUTE_BIT},
@@ -92,11 +148,50 @@ private:
         {DescriptorType::StorageImage, 3, VK_SHADER_STAGE_COMPUTE_BIT}
     };
 
+    inline static constexpr DescriptorBindingDesc physicsBindings[] = {
+        {DescriptorType::StorageBuffer, 0, VK_SHADER_STAGE_COMPUTE_BIT}, // positions
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_COMPUTE_BIT}, // bodies
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_COMPUTE_BIT}, // hash grid
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_COMPUTE_BIT}  // instances of the frame
+    };
+
+    inline static constexpr DescriptorBindingDesc layoutBindings[] = {
+        {DescriptorType::StorageBuffer, 0, VK_SHADER_STAGE_COMPUTE_BIT}, // positions, shared with physics
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_COMPUTE_BIT}, // bodies, same
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_COMPUTE_BIT}, // instances of the frame
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_COMPUTE_BIT}, // CSR adjacency
+        {DescriptorType::StorageBuffer, 4, VK_SHADER_STAGE_COMPUTE_BIT}, // bounds + finest cell sums
+        {DescriptorType::StorageBuffer, 5, VK_SHADER_STAGE_COMPUTE_BIT}  // grid pyramid
+    };
+
+    inline static constexpr DescriptorBindingDesc splatBindings[] = {
+        {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_COMPUTE_BIT},
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_COMPUTE_BIT}, // instances of the frame
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_COMPUTE_BIT}, // GPU physics positions
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_COMPUTE_BIT}  // splat buffer
+    };
+
+    inline static constexpr DescriptorBindingDesc heatmapGridBindings[] = {
+        {DescriptorType::UniformBuffer, 0, VK_SHADER_STAGE_COMPUTE_BIT},
+        {DescriptorType::StorageBuffer, 1, VK_SHADER_STAGE_COMPUTE_BIT}, // instances of the frame
+        {DescriptorType::StorageBuffer, 2, VK_SHADER_STAGE_COMPUTE_BIT}, // GPU physics positions
+        {DescriptorType::StorageBuffer, 3, VK_SHADER_STAGE_COMPUTE_BIT}, // grid
+        {DescriptorType::UniformBuffer, 4, VK_SHADER_STAGE_COMPUTE_BIT}  // heatmap uniform
+    };
+
 
     inline static constexpr std::array<std::span<const DescriptorBindingDesc>, toIndex(PipelineType::Count)> descriptorLayouts = {
         baseBindings,
         postBindings,
+        splatResolveBindings,
+        heatmapBindings,
+        edgeBindings,
+        textBindings,
         JFABindings,
+        physicsBindings,
+        layoutBindings,
+        splatBindings,
+        heatmapGridBindings,
     };
 
     inline static std::vector<char> readFile(const std::string& filename) { //CHANGE TO A FILE MANAGER OR SOMETHING
@@ -31,7 +31,7 @@ public:
     inline VkSurfaceKHR& getSurface() {return surface;}
     inline std::vector<VkSemaphore>& getImageAvailableSemaphores() {return imageAvailableSemaphores;}
     inline std::vector<VkSemaphore>& getRenderFinishedSemaphores() {return renderFinishedSemaphores;}
-    inline std::vector<VkFence>& getInFlightFences() {return inFlightFences;}
+    inline VkSemaphore getFrameTimeline() const {return frameTimeline;}
 
     inline std::span<const VkFramebuffer> viewBaseFrameBuffers() const {return baseFramebuffers;}
     inline std::span<const VkFramebuffer> viewImGuiFrameBuffers() const { return imGuiFramebuffers;}
@@ -85,8 +85,7 @@ private:
 
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
-    std::vector<VkFence> inFlightFences;
-    std::vector<VkFence> imagesInFlight;
+    VkSemaphore frameTimeline = VK_NULL_HANDLE;
 
     VkPresentModeKHR preferredPresentMode;
 };
\ No newline at end of file
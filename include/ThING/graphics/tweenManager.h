@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ThING/types/apiTypes.h"
+#include "ThING/types/tween.h"
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @note Tween slots are what InstanceData::tweenSlot points at, one per animating entity with a track per property.
+ * Handed out densely like the outline slots so the tween buffer only grows with what is animating right now, slot 0
+ * is "not animating". The vertex shaders play the tracks on ubo.time, this side only writes a slot when a tween
+ * starts and takes it back once every track of it ended.
+ */
+class TweenManager{
+public:
+    TweenManager();
+
+    float now() const; // seconds on the tween clock, what ubo.time gets too
+
+    // Returns the slot the track went to, 0 when every slot is taken. current is the instance value before the
+    // tween, a track that is still running starts from where it is drawn instead
+    uint32_t start(uint32_t slot, Entity owner, TweenProperty property, glm::vec4 current, glm::vec4 target, float duration, Easing easing);
+    void stop(uint32_t slot, TweenProperty property); // the instance value shows right away
+    void release(uint32_t slot);
+    void reset();
+
+    // Releases the slots with nothing left to play, returns their owners so the instances can drop the slot
+    std::span<const Entity> expire();
+
+    bool isLive(uint32_t slot) const;
+
+    inline std::span<const TweenData> viewSlots() const {return slots;}
+    inline std::span<const uint32_t> viewDirtySlots() const {return dirtySlots;}
+    void clearDirty();
+
+private:
+    void markDirty(uint32_t slot);
+
+    std::chrono::steady_clock::time_point epoch;
+
+    std::vector<TweenData> slots;
+    std::vector<Entity> owners;
+    std::vector<float> ends; // last track end of each slot
+    std::vector<uint8_t> live;
+    std::vector<uint32_t> freeSlots;
+
+    // Min heap of (end, slot), entries of a slot that got a longer tween since are skipped when they come up
+    std::vector<std::pair<float, uint32_t>> expiries;
+    std::vector<Entity> expired;
+
+    std::vector<uint8_t> dirtyMarks;
+    std::vector<uint32_t> dirtySlots;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ThING/extras/handMade.h"
+#include "ThING/threading/jobSystem.h"
+#include "ThING/types/graphLoad.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @note Streams a node CSV and an edge list into batches the API turns into circles and edges, see types/graphLoad.h.
+ * Both files are memory mapped, a driver thread cuts them into blocks and every block into slices that end on a line
+ * break, the slices get parsed with std::from_chars on a JobSystem of the loader's own, so a frame waiting on the
+ * engine pool never ends up parsing a megabyte slice. Ids are then numbered in file order on the
+ * driver, nodes first so every edge batch only points at nodes of its own or an earlier batch. The main thread takes
+ * finished batches whenever it wants, so the scene fills up while the rest is still being read.
+ */
+class GraphLoader{
+public:
+    struct Node{
+        glm::vec2 position;
+        float size;
+    };
+    // Batch nodes are numbered on from every node handed over before them, edges use those numbers
+    struct Batch{
+        std::vector<Node> nodes;
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+    };
+
+    GraphLoader() = default;
+    ~GraphLoader() {cancel();}
+    GraphLoader(const GraphLoader&) = delete;
+    GraphLoader& operator=(const GraphLoader&) = delete;
+
+    // Either path can be empty. False when a file can't be mapped, a load already running gets cancelled first
+    bool start(const std::string& nodesPath, const std::string& edgesPath, const GraphLoadSettings& settings);
+    void cancel(); // what got handed over stays
+    void truncate(uint64_t droppedNodes, uint64_t droppedEdges); // cancel because the scene is full, the last batch only got in partly
+
+    bool takeBatch(Batch& out); // false when nothing new is ready
+    GraphLoadProgress getProgress() const;
+
+private:
+    // One parsed slice, ids still as they are in the file
+    struct NodeRow{
+        uint64_t id;
+        Node node;
+        bool positioned;
+    };
+    struct Slice{
+        std::vector<NodeRow> nodes;
+        std::vector<std::pair<uint64_t, uint64_t>> edges;
+        uint64_t skipped = 0;
+    };
+
+    void run();
+    template <typename ParseFn>
+    void parseBlocks(std::span<const char> text, ParseFn&& parse, bool edgeFile);
+    uint32_t number(uint64_t id, Batch& batch, bool& created); // node number of an id, new ones are added to batch
+    glm::vec2 scatter(uint32_t node) const;
+    bool push(Batch&& batch);
+
+    osd::MappedFile nodesFile;
+    osd::MappedFile edgesFile;
+    GraphLoadSettings settings;
+    std::unique_ptr<JobSystem> jobs; // made by the first load, the workers sleep in between
+
+    std::thread driver;
+    std::atomic<bool> cancelled = false;
+    std::atomic<bool> driverRunning = false;
+
+    // Driver only
+    std::vector<Slice> slices;
+    std::vector<uint32_t> denseIds; // small ids index straight in, the rest goes through sparseIds
+    std::unordered_map<uint64_t, uint32_t> sparseIds;
+    uint32_t nodeCount = 0;
+
+    mutable std::mutex batchMutex;
+    std::condition_variable batchCondition;
+    std::deque<Batch> ready;
+
+    std::atomic<uint64_t> bytesParsed = 0;
+    std::atomic<uint64_t> skippedRows = 0;
+    uint64_t bytesTotal = 0;
+    uint64_t nodesTaken = 0;
+    uint64_t edgesTaken = 0;
+    bool truncated = false;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ThING/consts.h"
+#include "ThING/types/tilePyramid.h"
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @note Browses a tile pyramid (see types/tilePyramid.h) bigger than memory. Every update picks the level whose
+ * aggregated points land about TILE_POINT_PIXELS apart on screen and the tiles of it the view touches, tiles already
+ * cached are used as they are and the rest get queued for the I/O thread, nearest to the middle of the view first.
+ * Until a tile arrives its closest cached ancestor stands in for it, so zooming never shows holes, just coarser points
+ * for a moment. Tiles are kept in an LRU cache up to a byte budget, the ones on screen never get evicted.
+ */
+class TileStreamer{
+public:
+    using Tile = std::shared_ptr<const std::vector<TilePoint>>;
+
+    TileStreamer() = default;
+    ~TileStreamer() {close();}
+    TileStreamer(const TileStreamer&) = delete;
+    TileStreamer& operator=(const TileStreamer&) = delete;
+
+    bool open(const std::string& path); // false when it isn't a tile pyramid this build can read
+    void close();
+    bool isOpen() const {return ioThread.joinable();}
+
+    // True when the tiles to draw changed since the last call, zoom is pixels per world unit like the engine's
+    bool update(glm::vec2 viewMin, glm::vec2 viewMax, float zoom);
+    void invalidate() {visibleKeys.clear();} // next update reports a change even if the view didn't move
+
+    const std::vector<Tile>& getVisible() const {return visible;}
+    uint64_t getVisiblePoints() const {return visiblePoints;}
+    TileStreamStats getStats() const;
+    void setCacheBudget(size_t bytes) {cacheBudget = bytes;}
+
+private:
+    struct CacheEntry{
+        Tile tile;
+        std::list<uint64_t>::iterator lru;
+        uint64_t usedFrame;
+    };
+
+    const TileEntry* find(uint64_t key) const;
+    uint32_t chooseLevel(glm::vec2 viewMin, glm::vec2 viewMax, float zoom) const;
+    bool collect(uint32_t level, glm::vec2 viewMin, glm::vec2 viewMax, std::vector<uint64_t>& missing);
+    void use(CacheEntry& entry);
+    void evict();
+    void ioLoop();
+
+    TilePyramidHeader header;
+    std::vector<TileEntry> directory; // sorted by key
+
+    // Main thread only
+    std::unordered_map<uint64_t, CacheEntry> cache;
+    std::list<uint64_t> lru; // most recently used first
+    size_t cacheBytes = 0;
+    size_t cacheBudget = DEFAULT_TILE_CACHE_BUDGET;
+    uint64_t frame = 0;
+    uint32_t level = 0;
+    std::vector<uint64_t> visibleKeys; // sorted
+    std::vector<Tile> visible;
+    uint64_t visiblePoints = 0;
+
+    // Shared with the I/O thread
+    std::thread ioThread;
+    std::ifstream file; // I/O thread only once it runs
+    mutable std::mutex ioMutex;
+    std::condition_variable ioCondition;
+    std::vector<uint64_t> requests; // taken from the back
+    std::vector<std::pair<uint64_t, Tile>> loaded;
+    uint64_t reading = UINT64_MAX; // key the I/O thread is on, UINT64_MAX when idle
+    bool stopping = false;
+};
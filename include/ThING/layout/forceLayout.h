@@ -0,0 +1,82 @@
+#pragma once
+
+#include <ThING/types/renderData.h>
+#include <ThING/threading/jobSystem.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @note Force-directed layout that works straight on the circle instances, node i is circle i and the edges are the
+ * same EdgeData the renderer draws. Every iteration rebuilds a Barnes-Hut quadtree for the repulsion so a node only
+ * sees nearby nodes one by one and far away cells as a single mass, then forces run on the engine job system.
+ * New nodes start next to their placed neighbours (or where their circle is) and only reheat the layout a little,
+ * so growing a graph doesn't throw away the existing layout. Once it cooled down a step costs nothing.
+ */
+class ForceLayout{
+public:
+    // Runs iterations until the time budget is spent, positions are written back into circles. Returns the iterations run
+    uint32_t step(std::span<InstanceData> circles, std::span<const EdgeData> edges, JobSystem& jobs);
+
+    void setSpringLength(float springLength) {this->springLength = springLength > 0.0f ? springLength : 1.0f;}
+    void setSpringStiffness(float springStiffness) {this->springStiffness = springStiffness;}
+    void setRepulsion(float repulsion) {this->repulsion = repulsion;}
+    void setGravity(float gravity) {this->gravity = gravity;} // pull towards center, keeps loose components around
+    void setCenter(glm::vec2 center) {this->center = center;}
+    void setTheta(float theta) {this->theta = theta;} // cell size / distance under which a cell counts as one mass
+    void setCooling(float cooling) {this->cooling = cooling;}
+    void setTimeBudget(float milliseconds) {timeBudget = milliseconds;}
+
+    void teleport(uint32_t index, glm::vec2 pos); // the layout owns the positions, move nodes through here
+    void reheat(float temperature = 1.0f);
+    void clear(); // the next step seeds every node again, next to its neighbours
+    void adopt(std::span<const InstanceData> circles); // starts over from wherever the circles are now
+
+    float getTemperature() const {return temperature;}
+    bool isSettled() const;
+
+private:
+    struct QuadNode{
+        glm::vec2 centerOfMass;
+        float mass;
+        float size;
+        uint32_t firstChild; // the 4 children are contiguous
+        uint32_t begin; // sorted slots, only read on leaves
+        uint32_t end;
+    };
+
+    void syncNodes(std::span<const InstanceData> circles, std::span<const EdgeData> edges);
+    void buildAdjacency(std::span<const InstanceData> circles, std::span<const EdgeData> edges);
+    void iterate(JobSystem& jobs);
+    void buildTree(JobSystem& jobs);
+    void buildNode(uint32_t node, uint32_t begin, uint32_t end, glm::vec2 min, float size, uint32_t depth);
+    glm::vec2 repulse(uint32_t slot) const;
+    glm::vec2 attract(uint32_t index) const;
+
+    float springLength = 30.0f;
+    float springStiffness = 1.0f;
+    float repulsion = 1.0f;
+    float gravity = 0.1f;
+    glm::vec2 center = {0.0f, 0.0f};
+    float theta = 0.9f;
+    float cooling = 0.98f;
+    float timeBudget = 4.0f;
+    float temperature = 0.0f; // max step per iteration, in spring lengths
+    uint64_t edgeHash = 0;
+
+    // Per node, same index as the circle
+    std::vector<glm::vec2> position;
+    std::vector<glm::vec2> displacement;
+    std::vector<uint8_t> active;
+    std::vector<uint32_t> newcomers;
+
+    // CSR adjacency, adjacency[adjacencyStart[i]..adjacencyStart[i + 1]] are the neighbours of i
+    std::vector<uint32_t> adjacencyStart;
+    std::vector<uint32_t> adjacency;
+
+    // Active nodes in quadtree order, leaves own a contiguous range of slots
+    std::vector<uint32_t> order;
+    std::vector<glm::vec2> sortedPosition;
+    std::vector<QuadNode> nodes;
+};
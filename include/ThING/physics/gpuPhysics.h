@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ThING/consts.h>
+#include <ThING/types/gpuPhysics.h>
+#include <ThING/types/renderData.h>
+#include <ThING/threading/jobSystem.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+class BufferManager;
+
+/**
+ * @note Front end of the compute Verlet path (physics.comp) and of the compute layout (layout.comp), the passes
+ * themselves are recorded by the CommandBufferManager. Body i is circle i and lives in a device local buffer that
+ * basic.vert reads, so while either is enabled the CPU neither uploads nor sees circle positions. The layout wins
+ * when both are on, bodies are handed over at rest in both directions. Readback is optional and asynchronous:
+ * requestReadback() copies the positions at the end of the next frame and readPositions() hands them out once
+ * that frame finished on the GPU. The public side can be called from the update thread, the render thread
+ * takes the same lock in frame() and submitted().
+ */
+class GpuPhysics{
+public:
+    void setSettings(const GpuPhysicsSettings& settings);
+    GpuPhysicsSettings getSettings();
+    void step(float dt); // integrated on the next rendered frame, the last call before it wins
+    void reseed(); // every alive body restarts at rest from its instance position
+    void setLayout(const GpuLayoutSettings& settings);
+    GpuLayoutSettings getLayout();
+    void reheatLayout(float temperature);
+    void requestReadback();
+    bool readPositions(VkDevice device, VkSemaphore frameTimeline, const BufferManager& bufferManager, std::vector<glm::vec2>& positions);
+
+    // Render thread
+    PhysicsFrame frame(uint32_t frameIndex, std::span<const InstanceData> circles, bool circlesDirty, std::span<const EdgeData> edges,
+        BufferManager& bufferManager, JobSystem& jobs);
+    void submitted(uint32_t frameIndex, uint64_t timelineValue, const PhysicsFrame& frame);
+
+private:
+    float findMaxRadius(std::span<const InstanceData> circles, JobSystem& jobs);
+    void layoutFrame(PhysicsFrame& frame, uint32_t frameIndex, const GpuLayoutSettings& layout, float reheat, bool bodiesChanged,
+        std::span<const EdgeData> edges, BufferManager& bufferManager, JobSystem& jobs);
+    uint32_t buildAdjacency(uint32_t* staging, uint32_t bodyCount, std::span<const EdgeData> edges, JobSystem& jobs);
+    uint64_t hashEdges(std::span<const EdgeData> edges, JobSystem& jobs);
+
+    std::mutex mutex;
+    GpuPhysicsSettings settings;
+    float pendingDt = 0.0f;
+    bool pendingReseed = false;
+    bool readbackRequested = false;
+    GpuLayoutSettings layoutSettings;
+    float pendingReheat = 0.0f;
+
+    // Render thread only
+    bool wasEnabled = false;
+    uint32_t lastBodyCount = 0;
+    float cellSize = 1.0f;
+    bool wasLayout = false;
+    float temperature = 0.0f;
+    uint64_t edgeHash = 0;
+    bool adjacencyPending = false; // set until a frame that copies the new adjacency got submitted
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> adjacencyCursor;
+
+    // Timeline value of the frame that copied into each readback slot, 0 = nothing there
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> readbackValues{};
+    std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> readbackCounts{};
+    uint64_t lastReadValue = 0;
+};
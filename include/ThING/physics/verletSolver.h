@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ThING/types/renderData.h>
+#include <ThING/threading/jobSystem.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @note Verlet circle solver that works straight on the circle instances. Body i is circle i, a body wakes up
+ * the first step its circle is alive (starting at rest where the circle is) and goes to sleep when it dies. A circle
+ * that isn't where the last step left it (its slot got reused between steps, or it was moved from outside) starts
+ * over at rest too. Every substep rebuilds a flat uniform grid with a counting sort, then solves collisions over
+ * blocks of 8x8 cells in 4 colours (a 2x2 pattern of blocks): blocks of the same colour are never next to each other
+ * so they share no bodies and run in parallel without locks.
+ */
+class VerletSolver{
+public:
+    // dt is split over the substeps, positions are written back into circles at the end
+    void step(std::span<InstanceData> circles, float dt, JobSystem& jobs);
+
+    void setGravity(glm::vec2 gravity) {this->gravity = gravity;}
+    void setBounds(glm::vec2 minBound, glm::vec2 maxBound) {this->minBound = minBound; this->maxBound = maxBound;}
+    void setStiffness(float stiffness) {this->stiffness = stiffness;}
+    void setResistance(float resistance) {this->resistance = resistance;}
+    void setSubsteps(uint32_t substeps) {this->substeps = substeps > 0 ? substeps : 1;}
+
+    void teleport(uint32_t index, glm::vec2 pos); // moves a body without giving it velocity, the circle follows on the next step
+    void accelerate(uint32_t index, glm::vec2 acc); // only for the next step
+    void clear();
+
+    uint32_t getCollisionCount() const {return collisionCount;}
+
+private:
+    float syncBodies(std::span<const InstanceData> circles, JobSystem& jobs);
+    void integrate(float dt, JobSystem& jobs);
+    void buildGrid(float cellSize, JobSystem& jobs);
+    uint32_t solveCollisions(JobSystem& jobs);
+    uint32_t solveBlock(uint32_t blockX, uint32_t blockY);
+    uint32_t collide(uint32_t a, uint32_t begin, uint32_t end);
+    uint32_t resolve(uint32_t a, uint32_t b);
+    void applyBounds(std::span<InstanceData> circles, JobSystem& jobs);
+
+    glm::vec2 gravity = {0.0f, 1.0f};
+    glm::vec2 minBound = {-500.0f, -500.0f};
+    glm::vec2 maxBound = {500.0f, 500.0f};
+    float stiffness = 0.2f;
+    float resistance = 0.3f;
+    uint32_t substeps = 4;
+    uint32_t collisionCount = 0;
+
+    // Per body, same index as the circle
+    std::vector<glm::vec2> current;
+    std::vector<glm::vec2> previous;
+    std::vector<glm::vec2> written; // circle position the last step left, a circle anywhere else got moved from outside
+    std::vector<glm::vec2> acceleration;
+    std::vector<float> radius;
+    std::vector<uint8_t> active;
+    std::vector<uint32_t> bodyCell;
+
+    // Grid, cellStart[c]..cellStart[c + 1] are the sorted slots of cell c
+    float cellSize = 1.0f;
+    uint32_t gridWidth = 0;
+    uint32_t gridHeight = 0;
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellCursor;
+
+    // Bodies in cell order as SoA, this is what the collision kernel reads and writes
+    std::vector<uint32_t> sortedBody;
+    std::vector<float> sortedX;
+    std::vector<float> sortedY;
+    std::vector<float> sortedRadius;
+};
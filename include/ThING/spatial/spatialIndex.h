@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ThING/types/apiTypes.h>
+#include <ThING/types/renderData.h>
+#include <ThING/types/vertex.h>
+#include <ThING/threading/jobSystem.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+inline constexpr uint32_t SPATIAL_LEVELS = 16;
+
+/**
+ * @note Hierarchical loose grid over circles, lines and polygon bounds. Every entity sits in one cell only, the
+ * one under the centre of its bounds, on the first level whose cells are at least as big as those bounds, so a
+ * query just widens its range by half a cell per level. refit() recomputes every bound in parallel but only the
+ * entities that changed cell touch the grid, the second overload only looks at the entities it is given. Circles and
+ * lines (as capsules) are tested against their shape, polygons against their bounds. Queries see the scene as it was
+ * on the last refit.
+ */
+class SpatialIndex{
+public:
+    void refit(std::span<const InstanceData> circles, std::span<const LineData> lines, std::span<const InstanceData> polygons,
+        std::span<const MeshData> meshes, std::span<const Vertex> vertices, JobSystem& jobs);
+    void refit(std::span<const Entity> changed, std::span<const InstanceData> circles, std::span<const LineData> lines,
+        std::span<const InstanceData> polygons, std::span<const MeshData> meshes, std::span<const Vertex> vertices);
+    void clear();
+
+    // Hits get appended to out, in no particular order
+    void queryPoint(glm::vec2 point, std::vector<Entity>& out) const;
+    void queryRect(glm::vec2 min, glm::vec2 max, std::vector<Entity>& out) const;
+    void queryRadius(glm::vec2 center, float radius, std::vector<Entity>& out) const;
+    Entity nearest(glm::vec2 point, float maxDistance = std::numeric_limits<float>::max()) const; // distance to the shape, not the centre
+
+private:
+    struct Entry{
+        glm::vec2 min;
+        glm::vec2 max;
+        glm::vec2 a; // circle centre / line point1
+        glm::vec2 b; // line point2
+        float radius; // circle radius / half the line thickness
+        uint64_t cell;
+        uint32_t slot; // index inside the cell
+        uint8_t level;
+        bool present;
+    };
+    struct Placement{
+        uint64_t cell;
+        uint8_t level;
+        bool present;
+    };
+    using Cells = std::unordered_map<uint64_t, std::vector<uint32_t>>;
+
+    static bool circleShape(const InstanceData& circle, Entry& entry);
+    static bool lineShape(const LineData& line, Entry& entry);
+    static bool polygonShape(const InstanceData& polygon, const MeshData* mesh, std::span<const Vertex> vertices, Entry& entry);
+
+    template <typename ShapeFn>
+    void refitType(InstanceType type, size_t count, ShapeFn&& shapeOf, JobSystem& jobs);
+    template <typename ShapeFn>
+    void refitOne(InstanceType type, uint32_t index, ShapeFn&& shapeOf);
+    Placement reshape(Entry& entry, bool found, const Entry& shape) const;
+    bool needsMove(const Entry& entry, const Placement& placement) const;
+    void move(uint32_t ref, Entry& entry, const Placement& placement);
+    void updateTopReach();
+    template <typename Fn>
+    void visit(glm::vec2 min, glm::vec2 max, Fn&& fn) const;
+    Placement place(const Entry& entry) const;
+    void insert(uint32_t ref, Entry& entry, const Placement& placement);
+    void remove(const Entry& entry);
+    Entry& entryOf(uint32_t ref) {return entries[ref >> 30][ref & REF_INDEX_MASK];}
+
+    static constexpr uint32_t REF_INDEX_MASK = (1u << 30) - 1; // ref = type << 30 | index
+
+    std::array<std::vector<Entry>, static_cast<size_t>(InstanceType::Count)> entries;
+    std::array<Cells, SPATIAL_LEVELS> levels;
+    std::array<uint32_t, SPATIAL_LEVELS> levelCounts{};
+    float topReach = 0.0f; // the last level takes whatever doesn't fit anywhere else, so it keeps its own reach, recomputed every refit
+    std::vector<Placement> placements;
+    std::vector<uint32_t> moved;
+};
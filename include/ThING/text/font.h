@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ThING/types/renderData.h"
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Built-in stroke font, printable ASCII only (anything else draws as '?'), monospaced. Glyphs are line segments
+// turned into a signed distance field at startup so there is no font file to ship and text stays sharp at any zoom.
+// Em units, y down from the top of the capitals. Every glyph gets a cell of the atlas, FONT_ATLAS_COLUMNS cells per
+// row in character order, starting FONT_CELL_LEFT / FONT_CELL_TOP from the glyph's top left. Has to match text.vert
+inline constexpr uint32_t FONT_FIRST_CHAR = 32;
+inline constexpr uint32_t FONT_GLYPH_COUNT = 95;
+inline constexpr uint32_t FONT_ATLAS_COLUMNS = 16;
+inline constexpr uint32_t FONT_ATLAS_ROWS = (FONT_GLYPH_COUNT + FONT_ATLAS_COLUMNS - 1) / FONT_ATLAS_COLUMNS;
+inline constexpr uint32_t FONT_CELL_WIDTH = 32; // pixels
+inline constexpr uint32_t FONT_CELL_HEIGHT = 48;
+inline constexpr uint32_t FONT_ATLAS_WIDTH = FONT_ATLAS_COLUMNS * FONT_CELL_WIDTH;
+inline constexpr uint32_t FONT_ATLAS_HEIGHT = FONT_ATLAS_ROWS * FONT_CELL_HEIGHT;
+inline constexpr float FONT_PIXELS_PER_EM = 32.0f; // so a cell is 1 x 1.5 em
+inline constexpr float FONT_CELL_LEFT = -0.125f;
+inline constexpr float FONT_CELL_TOP = -0.25f;
+inline constexpr float FONT_ADVANCE = 0.75f;
+inline constexpr float FONT_LINE_HEIGHT = 1.25f;
+inline constexpr float FONT_CAP_HEIGHT = 0.75f;
+inline constexpr float FONT_MAX_OUTLINE = 0.1f; // em, the field fades to 0 a bit further out
+
+// R8 distance field, FONT_ATLAS_WIDTH x FONT_ATLAS_HEIGHT, 0.5 on the stroke edge and more inside
+std::vector<uint8_t> buildGlyphAtlas();
+
+// Glyphs of text written to dst, countGlyphs(text) of them (what doesn't fit is dropped). Pivot is the point of the
+// text block that lands on the text position, {0,0} top left and {0.5,0.5} the centre. '\n' starts a new line,
+// spaces take room but no glyph
+uint32_t layoutText(std::string_view text, glm::vec2 pivot, uint32_t textIndex, std::span<GlyphData> dst);
+uint32_t countGlyphs(std::string_view text);
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Counts the jobs submitted with it that didn't finish yet. A job that throws still counts as finished, the first
+// exception is kept and wait() rethrows it
+class JobCounter{
+public:
+    bool done() const {return pending.load(std::memory_order_acquire) == 0;}
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> pending = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr error; // written before the failing job's pending decrement, read once done()
+};
+
+/**
+ * @note Engine owned work-stealing pool. Every worker pops its own queue from the back and steals from
+ * the front of the others. Waiting (wait, parallelFor) runs queued jobs instead of sleeping, so nesting
+ * parallelFor inside a job is fine and the calling thread counts as one more worker.
+ */
+class JobSystem{
+public:
+    using Job = std::function<void()>;
+
+    explicit JobSystem(uint32_t workerCount = 0); // 0 = one per core minus the calling thread
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(Job job, JobCounter* counter = nullptr); // jobs without a counter must not throw
+    void wait(JobCounter& counter); // rethrows what a job of the counter threw, after all of them finished
+    inline uint32_t getWorkerCount() const {return static_cast<uint32_t>(workers.size());}
+
+    // fn(begin, end) for chunks of at least grain items, returns once every chunk ran, then rethrows if one threw
+    template <typename Fn>
+    void parallelForRange(size_t count, size_t grain, Fn&& fn);
+
+    // fn(item) or fn(item, index)
+    template <typename T, typename Fn>
+    void parallelFor(std::span<T> items, size_t grain, Fn&& fn);
+    // Same for anything a span can be made of (std::vector, std::array, ...), T can't be deduced from those
+    template <std::ranges::contiguous_range R, typename Fn>
+    void parallelFor(R&& items, size_t grain, Fn&& fn) {parallelFor(std::span(items), grain, std::forward<Fn>(fn));}
+
+private:
+    struct QueuedJob{
+        Job job;
+        JobCounter* counter;
+    };
+    struct WorkerQueue{
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    bool tryRunOne();
+    void workerLoop(uint32_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<uint32_t> queuedJobs = 0;
+    std::atomic<uint32_t> nextQueue = 0;
+    std::atomic<bool> running = true;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+};
+
+// Tasks with dependencies, built once and run as many times as needed
+class TaskGraph{
+public:
+    using TaskId = uint32_t;
+
+    TaskId addTask(std::function<void()> fn);
+    void precede(TaskId before, TaskId after); // after only starts once before finished
+    void run(JobSystem& jobs); // blocks until every task ran
+    void clear() {tasks.clear();}
+
+private:
+    struct Task{
+        std::function<void()> fn;
+        std::vector<TaskId> successors;
+        uint32_t dependencies = 0;
+        std::atomic<uint32_t> remaining = 0;
+    };
+    void schedule(JobSystem& jobs, TaskId id, JobCounter& counter);
+
+    std::deque<Task> tasks; // deque so Task never has to move
+};
+
+template <typename Fn>
+void JobSystem::parallelForRange(size_t count, size_t grain, Fn&& fn){
+    if(count == 0){
+        return;
+    }
+    // Never more than a few chunks per thread, tiny grains only add queue traffic
+    const size_t threads = workers.size() + 1;
+    grain = std::max({grain, size_t(1), (count + threads * 4 - 1) / (threads * 4)});
+    const size_t chunks = (count + grain - 1) / grain;
+    if(chunks == 1 || workers.empty()){
+        fn(size_t(0), count);
+        return;
+    }
+
+    JobCounter counter;
+    for(size_t chunk = 1; chunk < chunks; chunk++){
+        const size_t begin = chunk * grain;
+        const size_t end = std::min(begin + grain, count);
+        submit([&fn, begin, end]{ fn(begin, end); }, &counter);
+    }
+    // The queued chunks point at fn and counter, they have to finish even when this one throws
+    std::exception_ptr error;
+    try {
+        fn(size_t(0), grain);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    wait(counter);
+    if(error){
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename T, typename Fn>
+void JobSystem::parallelFor(std::span<T> items, size_t grain, Fn&& fn){
+    parallelForRange(items.size(), grain, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if constexpr (std::is_invocable_v<Fn&, T&, size_t>){
+                fn(items[i], i);
+            } else {
+                fn(items[i]);
+            }
+        }
+    });
+}
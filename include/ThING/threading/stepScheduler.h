@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ThING/threading/stepTask.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @note Runs the StepTasks of the API right after the update callback, on the same thread and under the same
+ * lock, so tasks can touch the scene like update() does. Steps go round robin over the tasks until the time
+ * budget or the step limit is spent, the clock is only read every few steps so tiny steps stay cheap.
+ * An exception thrown inside a task comes out of run() like one from the update callback would. Tasks may start
+ * and stop tasks (themselves included) while run() is resuming them, those only take effect once the step returns:
+ * started tasks join after run() and stopped ones are destroyed between steps.
+ */
+class StepScheduler{
+public:
+    uint64_t add(ThING::StepTask task); // 0 = the task was empty
+    bool cancel(uint64_t id);
+    bool isRunning(uint64_t id) const;
+    void clear();
+
+    void run();
+
+    void setBudget(float milliseconds) {budget = milliseconds;}
+    void setStepLimit(uint64_t steps) {stepLimit = steps;} // per run, 0 = only the budget counts. 1 = slow motion
+    float getBudget() const {return budget;}
+    uint64_t getStepLimit() const {return stepLimit;}
+    uint64_t getLastSteps() const {return lastSteps;}
+    size_t getTaskCount() const {return tasks.size() + started.size();} // stopped ones count until run() returns
+
+private:
+    struct Entry{
+        uint64_t id;
+        ThING::StepTask task;
+        bool cancelled = false; // stopped during run(), the frame may still be on the stack
+    };
+
+    void settle();
+
+    std::vector<Entry> tasks; // not resized while run() is resuming one of them
+    std::vector<Entry> started; // added during run()
+    bool running = false;
+    size_t cursor = 0; // round robin keeps going where the last run stopped
+    uint64_t nextId = 1;
+    float budget = 2.0f;
+    uint64_t stepLimit = 0;
+    uint64_t lastSteps = 0;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace ThING{
+    // What a task suspends on, one step of the algorithm. co_await nextStep() and co_yield nextStep() do the same
+    struct NextStep{
+        bool await_ready() const noexcept {return false;}
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        void await_resume() const noexcept {}
+    };
+
+    inline NextStep nextStep() {return {};}
+
+    /**
+     * @note Coroutine an algorithm visualization is written as, straight code instead of a state machine in update().
+     * Every nextStep() hands control back to the StepScheduler, which resumes as many steps per frame as fit in its
+     * budget. Tasks can co_await other StepTasks (a sort awaiting its partition), the scheduler always resumes the
+     * innermost one and a finished child continues its parent right away. Starts suspended, owns its frame.
+     */
+    class StepTask{
+    public:
+        struct promise_type;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        struct FinalAwaiter{
+            bool await_ready() const noexcept {return false;}
+            std::coroutine_handle<> await_suspend(Handle handle) noexcept {
+                promise_type& promise = handle.promise();
+                if(!promise.continuation){
+                    return std::noop_coroutine(); // a root, the scheduler sees it done
+                }
+                promise.root->leaf = promise.continuation;
+                return promise.continuation;
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct promise_type{
+            StepTask get_return_object() {
+                leaf = Handle::from_promise(*this);
+                return StepTask(Handle::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept {return {};}
+            FinalAwaiter final_suspend() noexcept {return {};}
+            std::suspend_always yield_value(NextStep) noexcept {return {};}
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept {error = std::current_exception();} // rethrown in the awaiter or by the scheduler
+
+            std::coroutine_handle<> continuation; // the task awaiting this one, null for a root
+            promise_type* root = this;
+            std::coroutine_handle<> leaf; // root only, the innermost task, what a step resumes
+            std::exception_ptr error;
+        };
+
+        // co_await on a child task, runs it up to its first step right away
+        struct Awaiter{
+            Handle child;
+            bool await_ready() const noexcept {return !child || child.done();}
+            std::coroutine_handle<> await_suspend(Handle parent) noexcept {
+                promise_type& promise = child.promise();
+                promise.continuation = parent;
+                promise.root = parent.promise().root;
+                promise.root->leaf = child;
+                return child;
+            }
+            void await_resume() const {
+                if(child && child.promise().error){
+                    std::rethrow_exception(child.promise().error);
+                }
+            }
+        };
+
+        StepTask() = default;
+        explicit StepTask(Handle handle) : handle(handle) {}
+        StepTask(StepTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        StepTask& operator=(StepTask&& other) noexcept {
+            if(this != &other){
+                if(handle) handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+        StepTask(const StepTask&) = delete;
+        StepTask& operator=(const StepTask&) = delete;
+        ~StepTask() {if(handle) handle.destroy();}
+
+        Awaiter operator co_await() && noexcept {return {handle};}
+
+        // One step of the innermost task, false once the whole task finished
+        bool resume() {
+            if(!handle || handle.done()){
+                return false;
+            }
+            handle.promise().leaf.resume();
+            return !handle.done();
+        }
+
+        bool done() const {return !handle || handle.done();}
+        std::exception_ptr error() const {return handle ? handle.promise().error : nullptr;}
+
+    private:
+        Handle handle;
+    };
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "ThING/threading/jobSystem.h"
+#include "ThING/timeline/timelinePlayer.h"
+#include "ThING/types/timeline.h"
+#include <string>
+
+// Whole scene in and out of one file, see types/sceneFile.h. Saving writes every vector as it is (tween slots as 0),
+// loading maps the file and copies each stream into its vector in parallel chunks, no per entity work at all
+bool saveSceneFile(const std::string& path, const TimelineScene& scene); // false when the file can't be written
+bool loadSceneFile(const std::string& path, const TimelineTarget& target, JobSystem& jobs); // false when it isn't a scene file this build can read, holds more instances than the instance buffer or a mesh or edge points past what it holds, target untouched
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ThING/consts.h"
+#include "ThING/threading/jobSystem.h"
+#include "ThING/timeline/timelinePlayer.h"
+#include "ThING/types/timeline.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/**
+ * @note Step back for the scene. Every stream (same ones the timeline has) is cut into fixed size chunks that
+ * snapshots share by reference count, the live vectors stay plain vectors. The API marks the chunks it writes, a
+ * snapshot copies only those (and shares them anyway if nothing actually changed) and points at the rest, restoring
+ * copies back only the chunks whose pointer differs from what the live vectors hold. Handing out a whole vector
+ * marks all of it, the compare keeps the memory down but not the time.
+ * Past the memory budget the oldest snapshots get dropped, the newest one always stays.
+ */
+class SnapshotStore{
+public:
+    SnapshotStore() = default;
+    SnapshotStore(const SnapshotStore&) = delete; // chunks count their bytes into this
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    uint64_t take(const TimelineScene& scene, JobSystem& jobs);
+    bool restore(uint64_t id, const TimelineTarget& target); // false when it got dropped
+    bool drop(uint64_t id);
+    void clear();
+
+    void markDirty(TimelineStream stream, size_t index);
+    void markAllDirty(TimelineStream stream) {streams[static_cast<size_t>(stream)].allDirty = true;}
+    void markAllDirty();
+
+    void setBudget(size_t bytes);
+    size_t getBudget() const {return budget;}
+    size_t getMemory() const {return memory.load(std::memory_order_relaxed);} // unique chunk bytes, shared ones count once
+    size_t getSnapshotCount() const {return snapshots.size();}
+    bool contains(uint64_t id) const;
+
+private:
+    static constexpr size_t STREAM_COUNT = static_cast<size_t>(TimelineStream::Count);
+    using Chunk = std::shared_ptr<const std::vector<std::byte>>;
+    using ChunkList = std::vector<Chunk>;
+
+    // The live vector as of the last take or restore, plus what got written since
+    struct Stream{
+        ChunkList base;
+        std::vector<uint8_t> dirty; // per chunk
+        bool allDirty = true;
+    };
+
+    struct Snapshot{
+        uint64_t id;
+        std::array<ChunkList, STREAM_COUNT> chunks;
+        std::array<size_t, STREAM_COUNT> counts;
+    };
+
+    void takeStream(TimelineStream stream, const std::byte* data, size_t count, JobSystem& jobs);
+    template <typename T>
+    void restoreStream(TimelineStream stream, std::vector<T>& out, const ChunkList& chunks, size_t count);
+    Chunk makeChunk(const std::byte* data, size_t size);
+    void evict();
+
+    std::atomic<size_t> memory = 0; // chunks are made on the job threads. Declared first, chunks outlive nothing else
+    std::array<Stream, STREAM_COUNT> streams;
+    std::deque<Snapshot> snapshots;
+    uint64_t nextId = 1;
+    size_t budget = DEFAULT_SNAPSHOT_BUDGET;
+};
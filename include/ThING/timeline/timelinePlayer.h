@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ThING/extras/handMade.h"
+#include "ThING/types/timeline.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where a seek writes the scene to, the vectors the API draws from
+struct TimelineTarget{
+    std::vector<InstanceData>& circles;
+    std::vector<LineData>& lines;
+    std::vector<InstanceData>& polygons;
+    std::vector<EdgeData>& edges;
+    std::vector<MeshData>& meshes;
+    std::vector<Vertex>& vertices;
+    std::vector<uint16_t>& indices;
+};
+
+/**
+ * @note Plays back a file written by TimelineRecorder. The file is memory mapped, only the frame index gets copied,
+ * so opening is instant and a seek only pages in the frames it applies. A seek goes to the last keyframe at or before
+ * the frame and applies the deltas after it, unless the frame is ahead of the one applied last within the same
+ * keyframe span, then only the deltas in between are applied. That keeps playing forward at one delta per frame.
+ * Tween slots read back as 0, what got recorded is where every tween ends up.
+ */
+class TimelinePlayer{
+public:
+    bool open(const std::string& path); // false when it isn't a timeline this build can read
+    void close();
+
+    // touched gets 1 << TimelineStream of every stream that got written. False when a frame turned out to be
+    // corrupt, the target holds the frames before it
+    bool seek(uint64_t frame, const TimelineTarget& target, uint32_t& touched);
+    void invalidate() {applied = false;} // the target got written by someone else, the next seek starts from a keyframe
+
+    bool isOpen() const {return file.isOpen();}
+    uint64_t getFrameCount() const {return frames.size();}
+    uint64_t getFrame() const {return position;}
+    uint32_t getKeyframeInterval() const {return keyframeInterval;}
+
+private:
+    bool readIndex();
+    void scanFrames(); // recording didn't stop cleanly, no index at the end
+    bool applyFrame(uint64_t frame, const TimelineTarget& target, uint32_t& touched);
+
+    osd::MappedFile file;
+    std::vector<TimelineIndexEntry> frames;
+    uint32_t keyframeInterval = 0;
+    uint64_t position = 0;
+    bool applied = false;
+};
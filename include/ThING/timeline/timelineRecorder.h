@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ThING/threading/jobSystem.h"
+#include "ThING/types/timeline.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @note Writes what the scene looks like after every frame into a timeline file, see types/timeline.h.
+ * Each capture diffs the instance vectors against the last captured frame on the JobSystem and keeps only the
+ * slots that changed, every keyframeInterval frames the whole scene goes in instead so seeking has somewhere to
+ * start from. Frames are encoded on the capturing thread and written by a background thread, capture only waits
+ * when the writer is too far behind.
+ */
+class TimelineRecorder{
+public:
+    TimelineRecorder() = default;
+    ~TimelineRecorder() {stop();}
+    TimelineRecorder(const TimelineRecorder&) = delete;
+    TimelineRecorder& operator=(const TimelineRecorder&) = delete;
+
+    bool start(const std::string& path, uint32_t keyframeInterval); // false when the file can't be created
+    bool stop(); // writes the frame index, false when any write failed along the way
+
+    // meshesChanged = vertices or indices got written since the last capture
+    void capture(const TimelineScene& scene, bool meshesChanged, JobSystem& jobs);
+
+    bool isRecording() const {return recording;}
+    uint64_t getFrameCount() const {return frame;}
+
+private:
+    void writerLoop();
+    void writeStream(TimelineStream stream, const std::byte* data, size_t count, bool full, JobSystem& jobs);
+    void writeFull(TimelineStream stream, const std::byte* data, size_t count);
+
+    std::ofstream file;
+    bool recording = false;
+    uint32_t keyframeInterval = 0;
+    uint64_t frame = 0;
+
+    // Last captured frame of every diffed stream, bytes so one diff works for all of them
+    std::array<std::vector<std::byte>, static_cast<size_t>(TimelineStream::Vertices)> shadows;
+    std::vector<std::vector<uint32_t>> changedChunks; // per diff job, merged in order afterwards
+    std::vector<uint32_t> changed;
+
+    // Frame being encoded, handed to the writer once done
+    std::vector<std::byte> encoding;
+    TimelineFrameHeader frameHeader;
+
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<std::vector<std::byte>> queued;
+    std::vector<std::vector<std::byte>> spare; // written frames, their memory gets reused
+    size_t queuedBytes = 0;
+    bool writerRunning = false;
+    std::atomic<bool> failed = false;
+
+    // Writer thread only until it is joined
+    std::vector<TimelineIndexEntry> index;
+    uint64_t writeOffset = 0;
+    uint64_t lastKeyframe = 0;
+};
@@ -58,3 +58,9 @@ constexpr Entity INVALID_ENTITY {
     std::numeric_limits<uint32_t>::max(),
     InstanceType::Count
 };
+
+constexpr uint32_t INVALID_EDGE = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t INVALID_TEXT = std::numeric_limits<uint32_t>::max();
+
+using SoundHandle = uint32_t; // ThING::API::loadSound
+constexpr SoundHandle INVALID_SOUND = std::numeric_limits<uint32_t>::max();
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ThING/types/renderData.h"
+#include "ThING/types/gpuPhysics.h"
+#include "ThING/types/pick.h"
+#include "ThING/types/heatmap.h"
 #include <cstdint>
 #include <vulkan/vulkan_core.h>
 
@@ -23,4 +26,8 @@ struct RenderContext {
     const BufferManager& bufferManager;
     uint32_t indirectCmdCount;
     uint32_t maxOutlineSize = 0;
+    PhysicsFrame physics{};
+    PickFrame picks{};
+    uint32_t splatCircles = 0; // circles splat.comp looks at, 0 = no sub-pixel path this frame
+    HeatmapFrame heatmap{};
 };
\ No newline at end of file
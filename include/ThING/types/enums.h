@@ -7,12 +7,20 @@
 enum class PipelineType{
     Base,//graphics first
     Post,
+    SplatResolve,
+    Heatmap,
+    Edge,
+    Text,
     JFA,// compute last
+    Physics,
+    Layout,
+    Splat,
+    HeatmapGrid,
     Count
 };
 
-const uint32_t GRAPHICS_PIPELINE_COUNT = 2; // Just count the above :p
-const uint32_t COMPUTE_PIPELINE_COUNT = 1; // Same here
+const uint32_t GRAPHICS_PIPELINE_COUNT = 6; // Just count the above :p
+const uint32_t COMPUTE_PIPELINE_COUNT = 5; // Same here
 
 enum class RenderPassType{
     Base,
@@ -45,6 +53,22 @@ enum class BufferType{
     Uniform,
     Indirect,
     SSBO,
+    PhysicsPositions,
+    PhysicsBodies,
+    PhysicsGrid,
+    PhysicsReadback,
+    PickReadback,
+    Splat,
+    HeatmapGrid,
+    HeatmapUniform,
+    Edge,
+    LayoutAccum,
+    LayoutTree,
+    LayoutAdjacency,
+    LayoutStaging,
+    Tween,
+    Text,
+    Glyph,
     Count
 };
 
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// All times in milliseconds
+struct FrameStats{
+    float cpuTime = 0.0f;   // frame begin -> queue submit
+    float waitTime = 0.0f;  // time blocked waiting for the GPU to free the frame slot
+    float gpuTime = 0.0f;   // GPU timestamps of the last completed frame, 0 if the queue has no timestamps
+    float latency = 0.0f;   // frame begin -> GPU completion seen by the CPU (upper bound by at most one CPU frame)
+
+    uint64_t uploadBytes = 0;     // instance data written to the mapped buffer this frame
+    float uploadTime = 0.0f;
+    float uploadBandwidth = 0.0f; // GB/s
+
+    uint64_t submittedFrames = 0;
+    uint64_t completedFrames = 0;
+    uint32_t framesInFlight = 0;
+};
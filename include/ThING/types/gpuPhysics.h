@@ -0,0 +1,96 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Same knobs as VerletSolver, the GPU path runs the same integrate -> grid -> collide -> bounds substeps
+struct GpuPhysicsSettings{
+    bool enabled = false;
+    glm::vec2 gravity = {0.0f, 1.0f};
+    glm::vec2 minBound = {-500.0f, -500.0f};
+    glm::vec2 maxBound = {500.0f, 500.0f};
+    float stiffness = 0.2f;
+    float resistance = 0.3f;
+    uint32_t substeps = 4;
+};
+
+// Same knobs as ForceLayout, the GPU path swaps the quadtree for a fixed depth grid pyramid built every iteration
+struct GpuLayoutSettings{
+    bool enabled = false;
+    float springLength = 30.0f;
+    float springStiffness = 1.0f;
+    float repulsion = 1.0f;
+    float gravity = 0.1f;
+    glm::vec2 center = {0.0f, 0.0f};
+    float theta = 0.9f;
+    float cooling = 0.98f;
+    uint32_t iterations = 4; // per rendered frame
+};
+
+enum class PhysicsPass : uint32_t{
+    Sync,       // wakes up new circles from the instance buffer, dead ones go to sleep
+    Integrate,
+    ClearGrid,
+    FillGrid,
+    Collide,    // every body only writes its own correction, no atomics on positions
+    Apply,      // correction + bounds
+    Count
+};
+
+enum class LayoutPass : uint32_t{
+    Sync,       // like PhysicsPass::Sync, but new circles wait for Place
+    Place,      // new nodes start next to their placed neighbours
+    Clear,
+    Bounds,
+    Fill,       // finest cells, fixed point atomics
+    Reduce,     // finest cells to centres of mass
+    Downsample, // one level of the pyramid from the one below it
+    Force,      // every node only writes its own displacement
+    Apply,
+    Count
+};
+
+// Has to match the push constant block of physics.comp
+struct PhysicsPushConstants{
+    glm::vec2 gravity;
+    glm::vec2 minBound;
+    glm::vec2 maxBound;
+    float dt;
+    float stiffness;
+    float resistance;
+    float cellSize;
+    uint32_t bodyCount;
+    uint32_t pass;
+    uint32_t reseed;
+};
+
+// Has to match the push constant block of layout.comp
+struct LayoutPushConstants{
+    glm::vec2 center;
+    float springLength;
+    float springStiffness;
+    float repulsion;
+    float gravity;
+    float theta;
+    float maxStep;
+    uint32_t bodyCount;
+    uint32_t pass;
+    uint32_t level;
+    uint32_t reseed;
+};
+
+// What the command buffer needs from GpuPhysics for one frame
+struct PhysicsFrame{
+    bool enabled = false;
+    bool readback = false;
+    uint32_t substeps = 0; // 0 = only sync, nothing moves this frame
+    PhysicsPushConstants constants{};
+
+    // Layout instead of the Verlet substeps
+    bool layout = false;
+    uint32_t iterations = 0;
+    float temperature = 0.0f; // of the first iteration, every next one gets cooled
+    float cooling = 1.0f;
+    uint32_t adjacencySize = 0; // uints staged for this frame to copy, 0 = the device copy is still current
+    LayoutPushConstants layoutConstants{};
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Node rows are "id[,x,y[,size]]", edge rows "from,to" with anything after ignored. Fields can be split by commas,
+// semicolons, tabs or spaces. Rows that don't start with a number (headers, # or % comments) are skipped.
+// Ids are any unsigned 64 bit numbers, an edge to an id that no node row had creates the node
+struct GraphLoadSettings{
+    glm::vec4 nodeColor = {1.0f, 1.0f, 1.0f, 1.0f};
+    float nodeSize = 4.0f; // when the row has none
+    glm::vec2 center = {0.0f, 0.0f};
+    float spread = 1000.0f; // nodes without a position get scattered in a square this wide around center
+    glm::vec4 edgeColor = {1.0f, 1.0f, 1.0f, 0.5f};
+    float edgeThickness = 1.0f;
+};
+
+struct GraphLoadProgress{
+    uint64_t bytesParsed = 0;
+    uint64_t bytesTotal = 0;
+    uint64_t nodes = 0; // created so far, visible in the scene
+    uint64_t edges = 0;
+    uint64_t skippedRows = 0;
+    bool running = false;
+    bool truncated = false; // the instance buffer filled up, the rest of the files was left out
+};
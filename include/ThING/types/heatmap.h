@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ThING/consts.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+enum class HeatmapMode : uint32_t{
+    Density,    // circles per cell through the colormap
+    Color,      // average circle color per cell, the colormap alpha still follows the density
+    Count
+};
+
+// Zoom is the engine zoom (pixels per world unit), zooming out lowers it
+struct HeatmapSettings{
+    bool enabled = false;
+    HeatmapMode mode = HeatmapMode::Density;
+    uint32_t cellSize = 1; // pixels per grid cell, 1 = screen resolution
+    float maxDensity = 0.0f; // circles per cell at the end of the colormap, 0 = densest cell of the frame
+    float heatmapZoom = 0.05f; // at and below it only the heatmap shows
+    float circleZoom = 0.25f; // at and above it only circles, crossfade in between
+    std::vector<glm::vec4> colormap; // evenly spaced stops from empty to dense, empty = built in
+};
+
+// Has to match the Heatmap uniform block of heatmap.comp and heatmap.frag (std140)
+struct HeatmapUniform{
+    glm::uvec2 gridSize;
+    uint32_t cellSize;
+    uint32_t mode;
+    float opacity;
+    float maxDensity;
+    uint32_t _pad0;
+    uint32_t _pad1;
+    std::array<glm::vec4, HEATMAP_LUT_SIZE> lut;
+};
+
+// Has to match the push constant block of heatmap.comp
+struct HeatmapPushConstants{
+    uint32_t circleCount;
+};
+
+// What the command buffer needs from HeatmapManager for one frame
+struct HeatmapFrame{
+    uint32_t circleCount = 0; // 0 = no heatmap this frame
+    uint32_t cells = 0;
+    float circleAlpha = 1.0f; // circles fade out while the heatmap fades in
+    bool circlesHidden = false; // fully faded, their draw is skipped
+};
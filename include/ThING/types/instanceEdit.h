@@ -0,0 +1,21 @@
+#pragma once
+#include "ThING/types/apiTypes.h"
+#include "ThING/types/renderData.h"
+#include <cstdint>
+
+enum class EditType : uint8_t{
+    Add,
+    Delete,
+    SetColor,
+    SetPosition,
+    SetInstance
+};
+
+// One queued change to an instance, lines travel as InstanceData (same layout)
+// Add/SetInstance use the whole data, SetColor only data.color and SetPosition only data.position
+struct InstanceEdit{
+    EditType type;
+    Entity entity;
+    uint32_t epoch; // of entity.type when it was queued, edits from before a clear or a scene swap get dropped
+    InstanceData data;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue, any amount of producers and one consumer. Every cell carries a sequence
+// number so producers only fight over the tail index, never over the cell itself.
+// push returns false when the queue is full, it never blocks.
+template <typename T, std::size_t CAPACITY>
+class MpscQueue{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "MpscQueue CAPACITY has to be a power of two");
+public:
+    MpscQueue() : cells(std::make_unique<Cell[]>(CAPACITY)){
+        for(std::size_t i = 0; i < CAPACITY; i++){
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread
+    bool push(const T& value){
+        return pushWith([&value](T& cell){cell = value;});
+    }
+
+    // Any thread. fill writes the cell once it is taken, so whatever it hands out (a reserved index) is never lost
+    // to a full queue
+    template <typename F>
+    bool pushWith(F&& fill){
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        while(true){
+            Cell& cell = cells[pos & MASK];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if(diff == 0){
+                if(tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    fill(cell.value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if(diff < 0){
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    bool pop(T& out){
+        Cell& cell = cells[head & MASK];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(head + 1) < 0){
+            return false;
+        }
+        out = cell.value;
+        cell.sequence.store(head + CAPACITY, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+private:
+    static constexpr std::size_t MASK = CAPACITY - 1;
+    struct Cell{
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<std::size_t> tail = 0;
+    alignas(64) std::size_t head = 0;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ThING/consts.h>
+#include <array>
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+// Texels of the id image one pick wants, bufferOffset is in texels into the frame's pick readback
+struct PickRegion{
+    uint64_t ticket = 0;
+    VkOffset2D offset{};
+    VkExtent2D extent{};
+    uint32_t bufferOffset = 0;
+};
+
+// What the command buffer needs from PickManager for one frame
+struct PickFrame{
+    std::array<PickRegion, MAX_PICKS_PER_FRAME> regions{};
+    uint32_t count = 0;
+};
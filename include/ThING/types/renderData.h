@@ -1,7 +1,9 @@
 #pragma once
 #include "ThING/types/enums.h"
 #include "ThING/types/vertex.h"
+#include "ThING/types/tween.h"
 #include <span>
+#include <type_traits>
 
 struct InstanceData {
     glm::vec2 position;
@@ -18,9 +20,10 @@ struct InstanceData {
     int32_t drawIndex = 0;
     uint32_t alive = 1;
     InstanceType type;
+    uint32_t tweenSlot = 0; // owned by the engine, 0 = not animating
 
-    static std::array<VkVertexInputAttributeDescription, 11> getAttributeDescriptions() {
-        std::array<VkVertexInputAttributeDescription, 11> attributes{};
+    static std::array<VkVertexInputAttributeDescription, 12> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 12> attributes{};
         uint32_t loc = 2;
         uint32_t binding = 1;
 
@@ -38,6 +41,7 @@ struct InstanceData {
         attributes[8] = { loc++, binding, VK_FORMAT_R32_SINT, offsetof(InstanceData, drawIndex) };
         attributes[9] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(InstanceData, alive) };
         attributes[10] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(InstanceData, type) };
+        attributes[11] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(InstanceData, tweenSlot) };
 
         return attributes;
     }
@@ -66,9 +70,10 @@ struct LineData {
     int32_t drawIndex = 0;
     uint32_t alive = 1;
     InstanceType type;
+    uint32_t tweenSlot = 0; // owned by the engine, 0 = not animating
 
-    static std::array<VkVertexInputAttributeDescription, 11> getAttributeDescriptions() {
-        std::array<VkVertexInputAttributeDescription, 11> attributes{};
+    static std::array<VkVertexInputAttributeDescription, 12> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 12> attributes{};
         uint32_t loc = 2;
         uint32_t binding = 1;
 
@@ -86,6 +91,7 @@ struct LineData {
         attributes[8] = { loc++, binding, VK_FORMAT_R32_SINT, offsetof(LineData, drawIndex) };
         attributes[9] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(LineData, alive) };
         attributes[10] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(LineData, type) };
+        attributes[11] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(LineData, tweenSlot) };
 
         return attributes;
     }
@@ -99,11 +105,114 @@ struct LineData {
     }
 };
 
+static_assert(sizeof(InstanceData) == 80); // std430 stride of Instance in the shaders
 static_assert(sizeof(LineData) == sizeof(InstanceData));
 static_assert(alignof(LineData) == alignof(InstanceData));
 static_assert(std::is_trivially_copyable_v<LineData>);
 static_assert(std::is_trivially_copyable_v<InstanceData>);
 
+inline constexpr uint32_t DEAD_EDGE_NODE = 0xFFFFFFFF; // from/to of a deleted edge, edge.vert skips anything past the circles
+
+// Line between two circles, edge.vert reads both ends from the circle instances of the frame
+struct EdgeData {
+    uint32_t from = DEAD_EDGE_NODE; // circle indices
+    uint32_t to = DEAD_EDGE_NODE;
+    float thickness = 1.0f;
+    uint32_t color = 0xFFFFFFFF; // RGBA8, red in the lowest byte (glm::packUnorm4x8)
+
+    static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 4> attributes{};
+        uint32_t loc = 2;
+        uint32_t binding = 1;
+
+        attributes[0] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(EdgeData, from) };
+        attributes[1] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(EdgeData, to) };
+        attributes[2] = { loc++, binding, VK_FORMAT_R32_SFLOAT, offsetof(EdgeData, thickness) };
+        attributes[3] = { loc++, binding, VK_FORMAT_R8G8B8A8_UNORM, offsetof(EdgeData, color) };
+
+        return attributes;
+    }
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription binding{};
+        binding.binding = 1;
+        binding.stride = sizeof(EdgeData);
+        binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        return binding;
+    }
+};
+
+static_assert(sizeof(EdgeData) == 16);
+static_assert(std::is_trivially_copyable_v<EdgeData>);
+
+// Has to match the push constant block of edge.vert
+struct EdgePushConstants {
+    uint32_t circleCount;
+};
+
+inline constexpr uint32_t NO_TEXT_ANCHOR = 0xFFFFFFFF; // text placed in the world instead of on a circle
+inline constexpr uint32_t DEAD_GLYPH = 0xFFFFFFFF; // text of a glyph nobody uses, text.vert skips it
+
+enum TextFlags : uint32_t{
+    TextFlags_None = 0,
+    TextFlags_ScreenSize = 1 << 0 // size is in pixels, the text keeps its size on screen whatever the zoom
+};
+
+// One string, text.vert reads it from a storage buffer for every glyph it has so moving, recoloring or outlining
+// a text only rewrites these 64 bytes. Same std430 layout as Text in text.vert
+struct TextData {
+    glm::vec2 position; // world, or from the centre of the anchor circle
+    float size = 16.0f; // em in world units (pixels with TextFlags_ScreenSize), capitals are 0.75 of it
+    uint32_t anchor = NO_TEXT_ANCHOR; // circle index, the text follows it and hides while it's dead
+
+    glm::vec4 color = {1,1,1,1};
+    glm::vec4 outlineColor = {0,0,0,0};
+
+    float outlineSize = 0.0f; // em, drawn from the distance field so it stops at FONT_MAX_OUTLINE
+    int32_t drawIndex = 0; // on top of the anchor circle's when anchored
+    uint32_t alive = 1;
+    uint32_t flags = TextFlags_None;
+};
+
+static_assert(sizeof(TextData) == 64);
+static_assert(std::is_trivially_copyable_v<TextData>);
+
+// One character on screen, laid out on the CPU when the string changes (ThING/text/font.h)
+struct GlyphData {
+    glm::vec2 offset; // em, top left of the glyph from the text position
+    uint32_t glyph; // atlas cell
+    uint32_t text = DEAD_GLYPH; // TextData index
+
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 3> attributes{};
+        uint32_t loc = 2;
+        uint32_t binding = 1;
+
+        attributes[0] = { loc++, binding, VK_FORMAT_R32G32_SFLOAT, offsetof(GlyphData, offset) };
+        attributes[1] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(GlyphData, glyph) };
+        attributes[2] = { loc++, binding, VK_FORMAT_R32_UINT, offsetof(GlyphData, text) };
+
+        return attributes;
+    }
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription binding{};
+        binding.binding = 1;
+        binding.stride = sizeof(GlyphData);
+        binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        return binding;
+    }
+};
+
+static_assert(sizeof(GlyphData) == 16);
+static_assert(std::is_trivially_copyable_v<GlyphData>);
+
+// Has to match the push constant block of text.vert
+struct TextPushConstants {
+    uint32_t circleCount;
+    uint32_t textCount;
+};
+
 struct MeshData{
     uint32_t vertexOffset;
     uint32_t vertexCount;
@@ -119,18 +228,13 @@ struct MeshData{
         this->indexCount = indexCount;
         this->instanceIndex = instanceIndex;
     }
-    MeshData(const MeshData& mesh){
-        this->vertexOffset = mesh.vertexOffset;
-        this->vertexCount = mesh.vertexCount;
-        this->indexOffset = mesh.indexOffset;
-        this->indexCount = mesh.indexCount;
-        this->instanceIndex = mesh.instanceIndex;
-    }
     static constexpr unsigned long InstanceSize(){
         return sizeof(InstanceData);
     }
 };
 
+static_assert(std::is_trivially_copyable_v<MeshData>); // snapshots, timelines and scene files copy it as bytes
+
 inline std::array<Vertex, 4> QUAD_VERTICES = {{
     {{-1.f, -1.f}, {-1.0f, -1.0f}},
     {{1.f, -1.f}, {1.0f, -1.0f}},
@@ -152,6 +256,11 @@ struct DrawBatch {
 struct DirtyFlags{
     bool ssbo = true;
     bool meshes = true;
+    bool circles = true; // only looked at with GPU physics on, the CPU path uploads circles every frame
+    bool tweens = false; // ApiFlags_ThreadedUpdate only, the snapshot brought a new tween table
+    bool texts = true; // text records, moved, recolored, outlined...
+    bool glyphs = true; // a string changed
+    bool edges = true; // edge records, added, removed, recolored
 };
 
 struct SSBO{
@@ -167,9 +276,18 @@ struct WorldData{
     std::span<InstanceData> polygonInstances;
     std::span<InstanceData> lineInstances;
     std::span<MeshData> meshes;
-    std::vector<SSBO> ssboData;
+    std::span<Vertex> vertices;
+    std::span<uint16_t> indices;
+    std::span<const SSBO> ssboData;
+    std::span<const uint32_t> ssboDirtySlots;
+    std::span<const TweenData> tweenData;
+    std::span<const uint32_t> tweenDirtySlots;
+    std::span<const EdgeData> edges;
+    std::span<const TextData> texts;
+    std::span<const GlyphData> glyphs;
 
     uint32_t polygonOffset;
 
     DirtyFlags dirtyFlags;
+    bool gpuPhysics = false; // circle positions live on the GPU, circles only get uploaded when dirty
 };
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ThING/types/timeline.h"
+#include <array>
+#include <cstdint>
+
+// Scene file layout, native endianness: SceneFileHeader then every stream (TimelineStream order) as the exact bytes
+// the engine keeps in its vectors, each starting on a SCENE_FILE_ALIGNMENT boundary so it maps to whole pages
+inline constexpr std::array<char, 8> SCENE_FILE_MAGIC = {'T','H','I','N','G','S','C','N'};
+inline constexpr uint32_t SCENE_FILE_VERSION = 1;
+inline constexpr uint64_t SCENE_FILE_ALIGNMENT = 0x1000;
+
+struct SceneFileSection{
+    uint64_t offset = 0; // from the start of the file
+    uint64_t count = 0; // elements
+};
+
+struct SceneFileHeader{
+    std::array<char, 8> magic = SCENE_FILE_MAGIC;
+    uint32_t version = SCENE_FILE_VERSION;
+    uint32_t streamCount = static_cast<uint32_t>(TimelineStream::Count);
+    std::array<uint32_t, static_cast<size_t>(TimelineStream::Count)> strides = TIMELINE_STRIDES;
+    uint32_t padding = 0;
+    std::array<SceneFileSection, static_cast<size_t>(TimelineStream::Count)> sections{};
+};
+
+static_assert(sizeof(SceneFileHeader) <= SCENE_FILE_ALIGNMENT, "the first stream starts one alignment in");
@@ -0,0 +1,44 @@
+#pragma once
+#include <ThING/types/renderData.h>
+#include <ThING/types/vertex.h>
+#include <cstdint>
+#include <vector>
+
+// Camera state set through the API, the render thread applies it (ApiFlags_ThreadedUpdate) so setZoom and friends
+// never touch what it is drawing with
+struct ViewState{
+    float zoom = 1.0f;
+    glm::vec2 offset = {0.0f, 0.0f};
+    glm::vec4 background = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// Everything the render thread needs from one finished update step (ApiFlags_ThreadedUpdate)
+// Meshes, outlines, tweens and text only get copied into a snapshot when their version changed
+struct SceneSnapshot{
+    std::vector<InstanceData> circleInstances;
+    std::vector<InstanceData> polygonInstances;
+    std::vector<LineData> lineInstances;
+    std::vector<MeshData> polygonMeshes;
+    std::vector<EdgeData> edges;
+    uint64_t edgeVersion = 0;
+
+    std::vector<Vertex> vertices;
+    std::vector<uint16_t> indices;
+    uint64_t meshVersion = 0;
+
+    std::vector<SSBO> outlines;
+    std::vector<uint32_t> outlineSlots; // 0..outlines.size(), uploaded as dirty when the version changes
+    float maxOutlineSize = 0.0f;
+    uint64_t outlineVersion = 0;
+
+    std::vector<TweenData> tweens;
+    std::vector<uint32_t> tweenSlots; // same as outlineSlots
+    uint64_t tweenVersion = 0;
+
+    std::vector<TextData> texts;
+    uint64_t textVersion = 0;
+    std::vector<GlyphData> glyphs;
+    uint64_t glyphVersion = 0;
+
+    ViewState view;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+enum class SplatPass : uint32_t{
+    Depth,      // atomicMax of the draw index on every pixel a small circle lands on
+    Claim,      // circles that won the depth race of their pixel take it, the lowest instance wins ties
+    Count
+};
+
+// Has to match the push constant block of splat.comp
+struct SplatPushConstants{
+    uint32_t circleCount;
+    uint32_t pass;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue, one producer and one consumer at a time. Each side owns one index and only reads
+// the other's, so neither ever waits: push returns false when the queue is full, pop when it is empty.
+// Small enough to live inline, the consumer can be a real-time thread that must not touch the allocator.
+template <typename T, std::size_t CAPACITY>
+class SpscQueue{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SpscQueue CAPACITY has to be a power of two");
+public:
+    // Producer thread only
+    bool push(const T& value){
+        const std::size_t pos = tail.load(std::memory_order_relaxed);
+        if(pos - head.load(std::memory_order_acquire) == CAPACITY){
+            return false;
+        }
+        cells[pos & MASK] = value;
+        tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool pop(T& out){
+        const std::size_t pos = head.load(std::memory_order_relaxed);
+        if(pos == tail.load(std::memory_order_acquire)){
+            return false;
+        }
+        out = cells[pos & MASK];
+        head.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t MASK = CAPACITY - 1;
+
+    std::array<T, CAPACITY> cells{};
+    alignas(64) std::atomic<std::size_t> tail = 0;
+    alignas(64) std::atomic<std::size_t> head = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Tile pyramid file, written by tools/tilePacker.cpp and streamed by io/tileStreamer.h, native endianness:
+// TilePyramidHeader, the tiles as TilePoint arrays, then the directory (TileEntry per tile sorted by key).
+// Level 0 is one square tile over every point, each level splits every tile in four. Leaves hold their points as
+// they are, the tiles above them one aggregated point per occupied TILE_GRID x TILE_GRID cell, so no tile holds more
+// than TILE_CAPACITY points. A tile missing from the directory is either empty or somewhere under a leaf
+inline constexpr std::array<char, 8> TILE_PYRAMID_MAGIC = {'T','H','I','N','G','T','P','1'};
+inline constexpr uint32_t TILE_PYRAMID_VERSION = 1;
+inline constexpr uint32_t TILE_GRID = 128;
+inline constexpr uint32_t TILE_CAPACITY = TILE_GRID * TILE_GRID;
+inline constexpr uint32_t TILE_MAX_LEVELS = 24; // past it a tile aggregates even when it's a leaf (stacked duplicates)
+
+struct TilePoint{
+    glm::vec2 position;
+    float size;
+    uint32_t color; // RGBA8, red in the lowest byte (glm::packUnorm4x8)
+};
+
+struct TilePyramidHeader{
+    std::array<char, 8> magic = TILE_PYRAMID_MAGIC;
+    uint32_t version = TILE_PYRAMID_VERSION;
+    uint32_t levels = 0;
+    glm::vec2 origin = {0.0f, 0.0f}; // lower corner of the level 0 tile
+    float size = 0.0f; // its side
+    uint32_t tileCount = 0;
+    uint64_t directoryOffset = 0;
+    uint64_t pointCount = 0; // points packed, aggregates not counted
+};
+
+struct TileEntry{
+    uint64_t key;
+    uint64_t offset; // from the start of the file
+    uint32_t count;
+    uint32_t leaf; // nothing under it, the view uses it at any deeper level
+};
+
+inline constexpr uint64_t tileKey(uint32_t level, uint32_t x, uint32_t y){
+    return (static_cast<uint64_t>(level) << 56) | (static_cast<uint64_t>(y) << 28) | x;
+}
+inline constexpr uint64_t tileParent(uint64_t key){
+    const uint32_t level = static_cast<uint32_t>(key >> 56);
+    const uint32_t x = static_cast<uint32_t>(key & 0xFFFFFFF);
+    const uint32_t y = static_cast<uint32_t>((key >> 28) & 0xFFFFFFF);
+    return tileKey(level - 1, x >> 1, y >> 1);
+}
+inline constexpr uint32_t tileLevel(uint64_t key){
+    return static_cast<uint32_t>(key >> 56);
+}
+
+struct TileStreamStats{
+    uint32_t level = 0; // the view wants
+    uint32_t visibleTiles = 0; // drawn, coarser stand-ins for tiles still loading included
+    uint32_t pendingTiles = 0;
+    uint64_t visiblePoints = 0;
+    size_t cacheBytes = 0;
+};
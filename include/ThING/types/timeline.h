@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ThING/types/renderData.h"
+#include "ThING/types/vertex.h"
+#include <array>
+#include <cstdint>
+#include <span>
+
+// Timeline file layout, native endianness (the file is for scrubbing on the machine that recorded it):
+// TimelineHeader, one chunk per frame (TimelineFrameHeader + its sections) and once recording stopped cleanly the
+// frame index (TimelineIndexEntry per frame) followed by TimelineFooter. A file without footer is scanned instead
+enum class TimelineStream : uint32_t{
+    Circles,
+    Lines,
+    Polygons,
+    Edges,
+    Meshes,   // polygonMeshes
+    Vertices, // always written whole, on keyframes and when the meshes changed
+    Indices,
+    Count
+};
+
+enum class TimelineSectionType : uint32_t{
+    Full,  // total elements
+    Sparse // count uint32_t slots, then count elements. Slots past the old size are always in it
+};
+
+inline constexpr std::array<char, 8> TIMELINE_MAGIC = {'T','H','I','N','G','T','L','1'};
+inline constexpr std::array<char, 8> TIMELINE_FOOTER_MAGIC = {'T','H','I','N','G','I','D','X'};
+inline constexpr uint32_t TIMELINE_VERSION = 1;
+inline constexpr uint32_t TIMELINE_FRAME_MAGIC = 0x4D415246; // "FRAM"
+
+// Element size of every stream, a file recorded with other layouts is refused
+inline constexpr std::array<uint32_t, static_cast<size_t>(TimelineStream::Count)> TIMELINE_STRIDES = {
+    sizeof(InstanceData), sizeof(LineData), sizeof(InstanceData), sizeof(EdgeData), sizeof(MeshData), sizeof(Vertex), sizeof(uint16_t)
+};
+
+struct TimelineHeader{
+    std::array<char, 8> magic = TIMELINE_MAGIC;
+    uint32_t version = TIMELINE_VERSION;
+    uint32_t keyframeInterval = 0;
+    std::array<uint32_t, static_cast<size_t>(TimelineStream::Count)> strides = TIMELINE_STRIDES;
+    uint32_t padding = 0;
+};
+
+struct TimelineFrameHeader{
+    uint32_t magic = TIMELINE_FRAME_MAGIC;
+    uint32_t keyframe = 0; // 1 = every stream is a Full section
+    uint32_t sectionCount = 0;
+    uint32_t padding = 0;
+    uint64_t frame = 0;
+    uint64_t size = 0; // bytes of sections after this header
+};
+
+struct TimelineSection{
+    TimelineStream stream;
+    TimelineSectionType type;
+    uint32_t count = 0; // elements in the section
+    uint32_t total = 0; // size of the stream after this frame
+};
+
+struct TimelineIndexEntry{
+    uint64_t offset = 0; // of the TimelineFrameHeader
+    uint64_t keyframe = 0; // frame of the last keyframe at or before this one
+};
+
+struct TimelineFooter{
+    uint64_t indexOffset = 0;
+    uint64_t frameCount = 0;
+    std::array<char, 8> magic = TIMELINE_FOOTER_MAGIC;
+};
+
+static_assert(sizeof(TimelineHeader) == 48, "TimelineHeader is written as is");
+static_assert(sizeof(TimelineFrameHeader) == 32, "TimelineFrameHeader is written as is");
+static_assert(sizeof(TimelineSection) == 16, "TimelineSection is written as is");
+
+// One frame of the scene as the recorder sees it, lines travel as InstanceData like everywhere else
+struct TimelineScene{
+    std::span<const InstanceData> circles;
+    std::span<const InstanceData> lines;
+    std::span<const InstanceData> polygons;
+    std::span<const EdgeData> edges;
+    std::span<const MeshData> meshes;
+    std::span<const Vertex> vertices;
+    std::span<const uint16_t> indices;
+};
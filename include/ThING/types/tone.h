@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+enum class Waveform : uint32_t{
+    Sine,
+    Triangle,
+    Square,
+    Saw,
+    Count
+};
+
+// One note for the synth (ThING/audio/synth.h), what goes through its queue
+struct ToneEvent{
+    float frequency = 440.0f; // Hz
+    float duration = 0.1f; // seconds held before the release, the release comes on top
+    float volume = 1.0f; // linear peak
+    Waveform waveform = Waveform::Sine;
+};
+
+static_assert(sizeof(ToneEvent) == 16);
+static_assert(std::is_trivially_copyable_v<ToneEvent>);
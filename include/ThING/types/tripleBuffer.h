@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Single writer, single reader. The writer always has a buffer to fill and the reader always gets the
+// latest complete one, neither side ever waits for the other. Buffers are reused, not reallocated.
+template <typename T>
+class TripleBuffer{
+public:
+    // Writer side
+    T& writeBuffer() {return buffers[writeIndex];}
+    void publish(){
+        uint8_t previous = middle.exchange(writeIndex | NEW_DATA, std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    // Reader side, returns false if nothing new was published since the last call
+    bool consume(){
+        if(!(middle.load(std::memory_order_relaxed) & NEW_DATA)){
+            return false;
+        }
+        uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+    T& readBuffer() {return buffers[readIndex];}
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0b011;
+    static constexpr uint8_t NEW_DATA = 0b100;
+
+    std::array<T, 3> buffers;
+    std::atomic<uint8_t> middle{1};
+    uint8_t writeIndex = 0;
+    uint8_t readIndex = 2;
+};
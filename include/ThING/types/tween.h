@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ThING/types/enums.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+
+// What a tween moves, lines read them as point1, point2 and thickness like the rest of the engine does
+enum class TweenProperty : uint32_t{
+    Position,
+    Scale,
+    Rotation,
+    Color,
+    Count
+};
+
+enum class Easing : uint32_t{
+    Linear,
+    EaseIn,     // cubic
+    EaseOut,
+    EaseInOut,
+    Count
+};
+
+// One property of one entity, only the components the property has are used
+struct TweenTrack{
+    glm::vec4 from = {0,0,0,0};
+    glm::vec4 to = {0,0,0,0};
+    float start = 0.0f; // seconds on the tween clock, same as ubo.time
+    float duration = 0.0f; // 0 = not animating, the instance value is drawn
+    uint32_t easing = 0;
+    uint32_t padding = 0;
+};
+
+// Has to match Tween in basic.vert and edge.vert, indexed by InstanceData::tweenSlot
+struct TweenData{
+    std::array<TweenTrack, toIndex(TweenProperty::Count)> tracks{};
+};
+
+static_assert(sizeof(TweenData) == 192);
+
+// Same curves as ease() in basic.vert, the CPU only needs them to pick up a running tween where it is
+inline float ease(Easing easing, float t){
+    switch (easing) {
+        case Easing::EaseIn: return t * t * t;
+        case Easing::EaseOut: {
+            const float u = 1.0f - t;
+            return 1.0f - u * u * u;
+        }
+        case Easing::EaseInOut: {
+            if (t < 0.5f) return 4.0f * t * t * t;
+            const float u = -2.0f * t + 2.0f;
+            return 1.0f - u * u * u * 0.5f;
+        }
+        case Easing::Linear:
+        case Easing::Count:
+        default: return t;
+    }
+}
+
+inline glm::vec4 sampleTrack(const TweenTrack& track, float time){
+    const float t = glm::clamp((time - track.start) / track.duration, 0.0f, 1.0f);
+    return glm::mix(track.from, track.to, ease(static_cast<Easing>(track.easing), t));
+}
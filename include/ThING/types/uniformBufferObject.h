@@ -1,8 +1,13 @@
 #pragma once
 #include "glm/fwd.hpp"
 #include <glm/glm.hpp>
+#include <cstdint>
 
 struct UniformBufferObject {
     glm::mat4 projection;
     glm::vec2 viewportSize;
+    uint32_t physicsBodyCount; // circles below this index take their position from the GPU physics buffer
+    float splatRadius; // world units, smaller circles are left to splat.comp, 0 = off
+    float circleAlpha; // heatmap crossfade, 0 = circles hidden
+    float time; // tween clock, seconds
 };
@@ -6,9 +6,10 @@ layout(location = 2) in vec2 vLocalPos;
 layout(location = 3) flat in uint vType;
 layout(location = 4) flat in uint vOutlineSize;
 layout(location = 5) flat in int  vDrawIndex;
+layout(location = 6) flat in uint vPickID;
 
 layout(location = 0) out vec4  outColor;
-layout(location = 1) out ivec2 outObjectID;
+layout(location = 1) out ivec4 outObjectID; // objectID, drawIndex, pick id
 layout(location = 2) out ivec2  outSeed;
 
 const float MIN_DRAW_INDEX = -50000.0;
@@ -49,9 +50,9 @@ void main()
 
     if (vOutlineSize > 0u) {
         outSeed     = ivec2(gl_FragCoord.xy);
-        outObjectID = ivec2(int(vObjectID), vDrawIndex);
+        outObjectID = ivec4(int(vObjectID), vDrawIndex, int(vPickID), 0);
     } else {
         outSeed     = ivec2(-1.0, -1.0);
-        outObjectID = ivec2(-1, vDrawIndex);
+        outObjectID = ivec4(-1, vDrawIndex, int(vPickID), 0);
     }
 }
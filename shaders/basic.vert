@@ -3,8 +3,30 @@
 layout(set = 0, binding = 0) uniform UBO {
     mat4 projection;
     vec2 viewportSize;
+    uint physicsBodyCount;
+    float splatRadius; // smaller circles are drawn by splat.comp
+    float circleAlpha; // heatmap crossfade
+    float time; // tween clock, seconds
 } ubo;
 
+// GPU physics, written by physics.comp, circle i is body i
+layout(std430, set = 0, binding = 3) readonly buffer Positions { vec2 positions[]; };
+
+struct Track {
+    vec4  from;
+    vec4  to;
+    float start;
+    float duration; // 0 = not animating
+    uint  easing;
+    uint  padding;
+};
+
+// TweenData, one track per TweenProperty, indexed by the tween slot of the instance
+struct Tween {
+    Track tracks[4];
+};
+layout(std430, set = 0, binding = 4) readonly buffer Tweens { Tween tweens[]; };
+
 layout(location = 0) in vec2 inPos;
 layout(location = 1) in vec2 inUV;
 
@@ -19,6 +41,7 @@ layout(location = 9)  in vec4  iOutlineColor;
 layout(location = 10) in int   iDrawIndex;
 layout(location = 11) in uint  iAlive;
 layout(location = 12) in uint  iType;
+layout(location = 13) in uint  iTweenSlot;
 
 layout(location = 0) out vec4 vColor;
 layout(location = 1) flat out uint vObjectID;
@@ -26,30 +49,74 @@ layout(location = 2) out vec2 vLocalPos;
 layout(location = 3) flat out uint vType;
 layout(location = 4) flat out uint vOutlineSize;
 layout(location = 5) flat out int  vOutDrawIndex;
+layout(location = 6) flat out uint vPickID;
 
+const uint TYPE_CIRCLE = 1u; // InstanceType::Circle
 const uint TYPE_LINE = 2u; // InstanceType::Line
 
+// TweenProperty and Easing
+const uint TWEEN_POSITION = 0u;
+const uint TWEEN_SCALE = 1u;
+const uint TWEEN_ROTATION = 2u;
+const uint TWEEN_COLOR = 3u;
+const uint EASE_IN = 1u;
+const uint EASE_OUT = 2u;
+const uint EASE_IN_OUT = 3u;
+
+float ease(uint easing, float t) {
+    if (easing == EASE_IN) return t * t * t;
+    if (easing == EASE_OUT) return 1.0 - pow(1.0 - t, 3.0);
+    if (easing == EASE_IN_OUT) return t < 0.5 ? 4.0 * t * t * t : 1.0 - pow(-2.0 * t + 2.0, 3.0) * 0.5;
+    return t;
+}
+
+// The instance already holds the target, a finished track just leaves it alone
+vec4 tween(uint property, vec4 value) {
+    Track track = tweens[iTweenSlot].tracks[property];
+    if (track.duration <= 0.0 || ubo.time >= track.start + track.duration) {
+        return value;
+    }
+    float t = clamp((ubo.time - track.start) / track.duration, 0.0, 1.0);
+    return mix(track.from, track.to, ease(track.easing, t));
+}
+
 void main() {
-    if (iAlive == 0u) {
+    vec2  position = iPosition;
+    vec2  scale    = iScale;
+    float rotation = iRotation;
+    vec4  color    = iColor;
+    if (iTweenSlot != 0u) {
+        position = tween(TWEEN_POSITION, vec4(position, 0.0, 0.0)).xy;
+        scale    = tween(TWEEN_SCALE, vec4(scale, 0.0, 0.0)).xy;
+        rotation = tween(TWEEN_ROTATION, vec4(rotation, 0.0, 0.0, 0.0)).x;
+        color    = tween(TWEEN_COLOR, color);
+    }
+
+    if (iAlive == 0u || (iType == TYPE_CIRCLE && scale.x < ubo.splatRadius)) {
         gl_Position   = vec4(2.0, 2.0, 0.0, 1.0);
         vColor        = vec4(0.0);
         vObjectID     = 0u;
         vLocalPos     = vec2(0.0);
         vType         = 0u;
         vOutlineSize  = 0u;
+        vPickID       = 0u;
         return;
     }
 
     vType         = iType;
-    vColor        = iColor;
+    vColor        = color;
+    if (iType == TYPE_CIRCLE) {
+        vColor.a *= ubo.circleAlpha;
+    }
     vObjectID     = iObjectID;
     vOutlineSize  = uint(iOutlineSize);
     vOutDrawIndex = iDrawIndex;
+    vPickID       = uint(gl_InstanceIndex) + 1u; // circles, lines, polygons share one instance buffer
 
     if (iType == TYPE_LINE) {
 
-        vec2 p0 = iPosition;
-        vec2 p1 = iScale;
+        vec2 p0 = position;
+        vec2 p1 = scale;
 
         float t    = (inPos.x + 1.0) * 0.5; // [-1,1] → [0,1]
         float side = inPos.y;
@@ -66,7 +133,7 @@ void main() {
         vec2 normal = vec2(-dir.y, dir.x);
 
         vec2 pos = mix(p0, p1, t);
-        pos += normal * side * (iRotation * 0.5);
+        pos += normal * side * (rotation * 0.5);
 
         gl_Position = ubo.projection * vec4(pos, 0.0, 1.0);
         vLocalPos   = vec2(t, side);
@@ -75,16 +142,22 @@ void main() {
 
     vLocalPos = inPos;
 
-    vec2 local = inPos * iScale;
+    vec2 local = inPos * scale;
 
-    float c = cos(iRotation);
-    float s = sin(iRotation);
+    float c = cos(rotation);
+    float s = sin(rotation);
 
     vec2 rotated = vec2(
         c * local.x - s * local.y,
         s * local.x + c * local.y
     );
 
-    vec2 worldPos = rotated + iPosition;
+    // Circles are the first instances in the buffer so the instance index is the circle index
+    vec2 center = position;
+    if (iType == TYPE_CIRCLE && uint(gl_InstanceIndex) < ubo.physicsBodyCount) {
+        center = positions[gl_InstanceIndex];
+    }
+
+    vec2 worldPos = rotated + center;
     gl_Position   = ubo.projection * vec4(worldPos, 0.0, 1.0);
 }
@@ -41,6 +41,72 @@ echo Compilando JFA compute shader...
 %GLSLC% "%COMP%" -o "%COMP_OUT%"
 if errorlevel 1 goto :error
 
+:: ===== PHYSICS (COMPUTE) =====
+set COMP=%SHADERS_DIR%\physics.comp
+set COMP_OUT=%SHADERS_DIR%\physicsComp.spv
+
+echo Compilando physics compute shader...
+%GLSLC% "%COMP%" -o "%COMP_OUT%"
+if errorlevel 1 goto :error
+
+:: ===== LAYOUT (COMPUTE) =====
+set COMP=%SHADERS_DIR%\layout.comp
+set COMP_OUT=%SHADERS_DIR%\layoutComp.spv
+
+echo Compilando layout compute shader...
+%GLSLC% "%COMP%" -o "%COMP_OUT%"
+if errorlevel 1 goto :error
+
+:: ===== SPLAT =====
+set COMP=%SHADERS_DIR%\splat.comp
+set FRAG=%SHADERS_DIR%\splat.frag
+set COMP_OUT=%SHADERS_DIR%\splatComp.spv
+set FRAG_OUT=%SHADERS_DIR%\splatFrag.spv
+
+echo Compilando splat compute shader...
+%GLSLC% "%COMP%" -o "%COMP_OUT%"
+if errorlevel 1 goto :error
+
+echo Compilando splat fragment shader...
+%GLSLC% "%FRAG%" -o "%FRAG_OUT%"
+if errorlevel 1 goto :error
+
+:: ===== HEATMAP =====
+set COMP=%SHADERS_DIR%\heatmap.comp
+set FRAG=%SHADERS_DIR%\heatmap.frag
+set COMP_OUT=%SHADERS_DIR%\heatmapComp.spv
+set FRAG_OUT=%SHADERS_DIR%\heatmapFrag.spv
+
+echo Compilando heatmap compute shader...
+%GLSLC% "%COMP%" -o "%COMP_OUT%"
+if errorlevel 1 goto :error
+
+echo Compilando heatmap fragment shader...
+%GLSLC% "%FRAG%" -o "%FRAG_OUT%"
+if errorlevel 1 goto :error
+
+:: ===== EDGE =====
+set VERT=%SHADERS_DIR%\edge.vert
+set VERT_OUT=%SHADERS_DIR%\edgeVert.spv
+
+echo Compilando edge vertex shader...
+%GLSLC% "%VERT%" -o "%VERT_OUT%"
+if errorlevel 1 goto :error
+
+:: ===== TEXT =====
+set VERT=%SHADERS_DIR%\text.vert
+set FRAG=%SHADERS_DIR%\text.frag
+set VERT_OUT=%SHADERS_DIR%\textVert.spv
+set FRAG_OUT=%SHADERS_DIR%\textFrag.spv
+
+echo Compilando text vertex shader...
+%GLSLC% "%VERT%" -o "%VERT_OUT%"
+if errorlevel 1 goto :error
+
+echo Compilando text fragment shader...
+%GLSLC% "%FRAG%" -o "%FRAG_OUT%"
+if errorlevel 1 goto :error
+
 
 echo.
 echo ✅ Compilación exitosa.
@@ -34,5 +34,62 @@ COMP_OUT="$SHADERS_DIR/jfaComp.spv"
 echo "Compilando JFA compute shader..."
 $GLSLC "$COMP" -o "$COMP_OUT"
 
+# ===== PHYSICS (COMPUTE) =====
+COMP="$SHADERS_DIR/physics.comp"
+COMP_OUT="$SHADERS_DIR/physicsComp.spv"
+
+echo "Compilando physics compute shader..."
+$GLSLC "$COMP" -o "$COMP_OUT"
+
+# ===== LAYOUT (COMPUTE) =====
+COMP="$SHADERS_DIR/layout.comp"
+COMP_OUT="$SHADERS_DIR/layoutComp.spv"
+
+echo "Compilando layout compute shader..."
+$GLSLC "$COMP" -o "$COMP_OUT"
+
+# ===== SPLAT =====
+COMP="$SHADERS_DIR/splat.comp"
+FRAG="$SHADERS_DIR/splat.frag"
+COMP_OUT="$SHADERS_DIR/splatComp.spv"
+FRAG_OUT="$SHADERS_DIR/splatFrag.spv"
+
+echo "Compilando splat compute shader..."
+$GLSLC "$COMP" -o "$COMP_OUT"
+
+echo "Compilando splat fragment shader..."
+$GLSLC "$FRAG" -o "$FRAG_OUT"
+
+# ===== HEATMAP =====
+COMP="$SHADERS_DIR/heatmap.comp"
+FRAG="$SHADERS_DIR/heatmap.frag"
+COMP_OUT="$SHADERS_DIR/heatmapComp.spv"
+FRAG_OUT="$SHADERS_DIR/heatmapFrag.spv"
+
+echo "Compilando heatmap compute shader..."
+$GLSLC "$COMP" -o "$COMP_OUT"
+
+echo "Compilando heatmap fragment shader..."
+$GLSLC "$FRAG" -o "$FRAG_OUT"
+
+# ===== EDGE =====
+VERT="$SHADERS_DIR/edge.vert"
+VERT_OUT="$SHADERS_DIR/edgeVert.spv"
+
+echo "Compilando edge vertex shader..."
+$GLSLC "$VERT" -o "$VERT_OUT"
+
+# ===== TEXT =====
+VERT="$SHADERS_DIR/text.vert"
+FRAG="$SHADERS_DIR/text.frag"
+VERT_OUT="$SHADERS_DIR/textVert.spv"
+FRAG_OUT="$SHADERS_DIR/textFrag.spv"
+
+echo "Compilando text vertex shader..."
+$GLSLC "$VERT" -o "$VERT_OUT"
+
+echo "Compilando text fragment shader..."
+$GLSLC "$FRAG" -o "$FRAG_OUT"
+
 echo
 echo "✅ Compilación exitosa."
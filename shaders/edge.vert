@@ -0,0 +1,134 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform UBO {
+    mat4 projection;
+    vec2 viewportSize;
+    uint physicsBodyCount;
+    float splatRadius;
+    float circleAlpha; // heatmap crossfade, edges fade with their circles
+    float time; // tween clock, seconds
+} ubo;
+
+struct Instance {
+    vec2  position;
+    vec2  scale;
+    float rotation;
+    float outlineSize;
+    uint  objectID;
+    uint  groupID;
+    vec4  color;
+    vec4  outlineColor;
+    int   drawIndex;
+    uint  alive;
+    uint  type;
+    uint  tweenSlot;
+};
+
+// Circles are the first instances in the buffer so circle i is instance i
+layout(std430, set = 0, binding = 1) readonly buffer Instances { Instance instances[]; };
+// GPU physics, written by physics.comp, circle i is body i
+layout(std430, set = 0, binding = 2) readonly buffer Positions { vec2 positions[]; };
+
+// Same tweens as basic.vert, only the position track matters here
+struct Track {
+    vec4  from;
+    vec4  to;
+    float start;
+    float duration;
+    uint  easing;
+    uint  padding;
+};
+struct Tween {
+    Track tracks[4];
+};
+layout(std430, set = 0, binding = 3) readonly buffer Tweens { Tween tweens[]; };
+
+layout(push_constant) uniform Push {
+    uint circleCount;
+} pc;
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 2) in uint  iFrom;
+layout(location = 3) in uint  iTo;
+layout(location = 4) in float iThickness;
+layout(location = 5) in vec4  iColor; // RGBA8, unpacked by the vertex fetch
+
+// Same outputs as basic.vert, basic.frag draws it as a line
+layout(location = 0) out vec4 vColor;
+layout(location = 1) flat out uint vObjectID;
+layout(location = 2) out vec2 vLocalPos;
+layout(location = 3) flat out uint vType;
+layout(location = 4) flat out uint vOutlineSize;
+layout(location = 5) flat out int  vOutDrawIndex;
+layout(location = 6) flat out uint vPickID;
+
+const uint TYPE_LINE = 2u; // InstanceType::Line
+const uint TWEEN_POSITION = 0u;
+
+// Same curves as basic.vert
+float ease(uint easing, float t) {
+    if (easing == 1u) return t * t * t;
+    if (easing == 2u) return 1.0 - pow(1.0 - t, 3.0);
+    if (easing == 3u) return t < 0.5 ? 4.0 * t * t * t : 1.0 - pow(-2.0 * t + 2.0, 3.0) * 0.5;
+    return t;
+}
+
+vec2 circleCenter(uint i) {
+    if (i < ubo.physicsBodyCount) {
+        return positions[i];
+    }
+    uint slot = instances[i].tweenSlot;
+    if (slot != 0u) {
+        Track track = tweens[slot].tracks[TWEEN_POSITION];
+        if (track.duration > 0.0 && ubo.time < track.start + track.duration) {
+            float t = clamp((ubo.time - track.start) / track.duration, 0.0, 1.0);
+            return mix(track.from.xy, track.to.xy, ease(track.easing, t));
+        }
+    }
+    return instances[i].position;
+}
+
+void main() {
+    // Not an entity, nothing to outline or pick
+    vObjectID    = 0u;
+    vOutlineSize = 0u;
+    vPickID      = 0u;
+    vType        = TYPE_LINE;
+
+    if (iFrom >= pc.circleCount || iTo >= pc.circleCount || instances[iFrom].alive == 0u || instances[iTo].alive == 0u) {
+        gl_Position   = vec4(2.0, 2.0, 0.0, 1.0);
+        vColor        = vec4(0.0);
+        vLocalPos     = vec2(0.0);
+        vOutDrawIndex = 0;
+        return;
+    }
+
+    vec2 p0 = circleCenter(iFrom);
+    vec2 p1 = circleCenter(iTo);
+
+    vColor        = vec4(iColor.rgb, iColor.a * ubo.circleAlpha);
+    // Right under the lower of its two circles, they cover the ends
+    vOutDrawIndex = min(instances[iFrom].drawIndex, instances[iTo].drawIndex) - 1;
+
+    float t    = (inPos.x + 1.0) * 0.5; // [-1,1] → [0,1]
+    float side = inPos.y;
+
+    vec2 dir = p1 - p0;
+    float len = length(dir);
+
+    if (len < 1e-6) {
+        gl_Position = vec4(2.0);
+        return;
+    }
+
+    dir /= len;
+    vec2 normal = vec2(-dir.y, dir.x);
+
+    vec2 pos = mix(p0, p1, t);
+    pos += normal * side * (iThickness * 0.5);
+
+    gl_Position = ubo.projection * vec4(pos, 0.0, 1.0);
+    vLocalPos   = vec2(t, side);
+}
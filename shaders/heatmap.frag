@@ -0,0 +1,46 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform Heatmap {
+    uvec2 gridSize;
+    uint  cellSize;
+    uint  mode;
+    float opacity;
+    float maxDensity;
+    vec4  lut[64]; // HEATMAP_LUT_SIZE
+} heatmap;
+
+// Written by heatmap.comp, [0] = densest cell, then count, red, green, blue per cell
+layout(std430, set = 0, binding = 1) readonly buffer Grid { uint grid[]; };
+
+layout(location = 0) out vec4 outColor;
+
+const uint GRID_HEADER = 4u;
+const uint LUT_SIZE = 64u;
+const uint MODE_COLOR = 1u;
+
+vec4 colormap(float t)
+{
+    float x = t * float(LUT_SIZE - 1u);
+    uint lo = min(uint(x), LUT_SIZE - 2u);
+    return mix(heatmap.lut[lo], heatmap.lut[lo + 1u], x - float(lo));
+}
+
+void main()
+{
+    uvec2 cell = min(uvec2(gl_FragCoord.xy) / heatmap.cellSize, heatmap.gridSize - 1u);
+    uint base = GRID_HEADER + (cell.y * heatmap.gridSize.x + cell.x) * 4u;
+    uint count = grid[base];
+    if (count == 0u)
+        discard;
+
+    // Log scale, a handful of dense cells would flatten everything else on a linear one
+    float maxDensity = heatmap.maxDensity > 0.0 ? heatmap.maxDensity : float(max(grid[0], 1u));
+    float t = clamp(log(1.0 + float(count)) / log(1.0 + maxDensity), 0.0, 1.0);
+    vec4 color = colormap(t);
+
+    if (heatmap.mode == MODE_COLOR) {
+        color.rgb = vec3(grid[base + 1u], grid[base + 2u], grid[base + 3u]) / (255.0 * float(count));
+    }
+
+    outColor = vec4(color.rgb, color.a * heatmap.opacity);
+}
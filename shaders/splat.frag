@@ -0,0 +1,69 @@
+#version 450
+
+struct Instance {
+    vec2  position;
+    vec2  scale;
+    float rotation;
+    float outlineSize;
+    uint  objectID;
+    uint  groupID;
+    vec4  color;
+    vec4  outlineColor;
+    int   drawIndex;
+    uint  alive;
+    uint  type;
+    uint  tweenSlot;
+};
+
+layout(set = 0, binding = 0) uniform UBO {
+    mat4 projection;
+    vec2 viewportSize;
+    uint physicsBodyCount;
+    float splatRadius;
+    float circleAlpha;
+} ubo;
+
+// Written by splat.comp, [0] = depth key, [1] = ~instance
+layout(std430, set = 0, binding = 1) readonly buffer Splat { uint splat[]; };
+layout(std430, set = 0, binding = 2) readonly buffer Instances { Instance instances[]; };
+
+layout(location = 0) out vec4  outColor;
+layout(location = 1) out ivec4 outObjectID; // objectID, drawIndex, pick id
+layout(location = 2) out ivec2 outSeed;
+
+const float MIN_DRAW_INDEX = -50000.0;
+const float MAX_DRAW_INDEX =  50000.0;
+const float PI = 3.14159265;
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    uint texel = (uint(p.y) * uint(ubo.viewportSize.x) + uint(p.x)) * 2u;
+    uint winner = splat[texel + 1u];
+    if (winner == 0u)
+        discard;
+
+    uint i = ~winner;
+    Instance inst = instances[i];
+
+    // The circle is smaller than the pixel, its area is how much of the pixel it covers
+    float zoom = ubo.viewportSize.x * ubo.projection[0][0] * 0.5;
+    float radius = inst.scale.x * zoom;
+    float alpha = inst.color.a * ubo.circleAlpha * min(PI * radius * radius, 1.0);
+    if (alpha <= 0.0)
+        discard;
+
+    float di = clamp(float(inst.drawIndex), MIN_DRAW_INDEX, MAX_DRAW_INDEX);
+    float depth01 = (di - MIN_DRAW_INDEX) / (MAX_DRAW_INDEX - MIN_DRAW_INDEX);
+    gl_FragDepth = 1.0 - depth01;
+
+    outColor = vec4(inst.color.rgb * alpha, alpha);
+
+    if (inst.outlineSize > 0.0) {
+        outSeed     = p;
+        outObjectID = ivec4(int(inst.objectID), inst.drawIndex, int(i + 1u), 0);
+    } else {
+        outSeed     = ivec2(-1, -1);
+        outObjectID = ivec4(-1, inst.drawIndex, int(i + 1u), 0);
+    }
+}
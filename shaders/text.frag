@@ -0,0 +1,40 @@
+#version 450
+
+layout(set = 0, binding = 5) uniform sampler2D glyphAtlas;
+
+layout(location = 0) in vec4 vColor;
+layout(location = 1) in vec4 vOutlineColor;
+layout(location = 2) in vec2 vUV;
+layout(location = 3) flat in float vOutline;
+layout(location = 4) flat in int  vDrawIndex;
+
+layout(location = 0) out vec4  outColor;
+layout(location = 1) out ivec4 outObjectID; // masked out, text isn't pickable
+layout(location = 2) out ivec2 outSeed;     // same
+
+const float MIN_DRAW_INDEX = -50000.0;
+const float MAX_DRAW_INDEX =  50000.0;
+
+void main()
+{
+    // 0.5 on the stroke edge, fwidth keeps the edge one pixel wide whatever the zoom
+    float d  = texture(glyphAtlas, vUV).r;
+    float aa = max(fwidth(d), 1e-4);
+
+    float fill = smoothstep(0.5 - aa, 0.5 + aa, d);
+    float body = smoothstep(vOutline - aa, vOutline + aa, d);
+
+    vec4 color  = mix(vOutlineColor, vColor, fill);
+    float alpha = color.a * (vOutline < 0.5 ? body : fill);
+
+    if (alpha <= 0.0)
+        discard;
+
+    float di = clamp(float(vDrawIndex), MIN_DRAW_INDEX, MAX_DRAW_INDEX);
+    float depth01 = (di - MIN_DRAW_INDEX) / (MAX_DRAW_INDEX - MIN_DRAW_INDEX);
+    gl_FragDepth = 1.0 - depth01;
+
+    outColor    = vec4(color.rgb * alpha, alpha); // premultiplied
+    outObjectID = ivec4(-1, vDrawIndex, 0, 0);
+    outSeed     = ivec2(-1, -1);
+}
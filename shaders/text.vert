@@ -0,0 +1,164 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform UBO {
+    mat4 projection;
+    vec2 viewportSize;
+    uint physicsBodyCount;
+    float splatRadius;
+    float circleAlpha; // heatmap crossfade, labels fade with their circles
+    float time; // tween clock, seconds
+} ubo;
+
+// TextData
+struct Text {
+    vec2  position;
+    float size;
+    uint  anchor;
+    vec4  color;
+    vec4  outlineColor;
+    float outlineSize;
+    int   drawIndex;
+    uint  alive;
+    uint  flags;
+};
+
+struct Instance {
+    vec2  position;
+    vec2  scale;
+    float rotation;
+    float outlineSize;
+    uint  objectID;
+    uint  groupID;
+    vec4  color;
+    vec4  outlineColor;
+    int   drawIndex;
+    uint  alive;
+    uint  type;
+    uint  tweenSlot;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Texts { Text texts[]; };
+// Circles are the first instances in the buffer so circle i is instance i
+layout(std430, set = 0, binding = 2) readonly buffer Instances { Instance instances[]; };
+// GPU physics, written by physics.comp, circle i is body i
+layout(std430, set = 0, binding = 3) readonly buffer Positions { vec2 positions[]; };
+
+// Same tweens as basic.vert, only the position track matters here
+struct Track {
+    vec4  from;
+    vec4  to;
+    float start;
+    float duration;
+    uint  easing;
+    uint  padding;
+};
+struct Tween {
+    Track tracks[4];
+};
+layout(std430, set = 0, binding = 4) readonly buffer Tweens { Tween tweens[]; };
+
+layout(push_constant) uniform Push {
+    uint circleCount;
+    uint textCount;
+} pc;
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 2) in vec2 iOffset; // em
+layout(location = 3) in uint iGlyph;
+layout(location = 4) in uint iText;
+
+layout(location = 0) out vec4 vColor;
+layout(location = 1) out vec4 vOutlineColor;
+layout(location = 2) out vec2 vUV;
+layout(location = 3) flat out float vOutline; // field value where the outline ends
+layout(location = 4) flat out int  vDrawIndex;
+
+// ThING/text/font.h
+const uint  FONT_ATLAS_COLUMNS = 16u;
+const uint  FONT_ATLAS_ROWS    = 6u;
+const vec2  FONT_CELL_ORIGIN   = vec2(-0.125, -0.25); // em, FONT_CELL_LEFT, FONT_CELL_TOP
+const vec2  FONT_CELL_SIZE     = vec2(1.0, 1.5); // em
+const float FONT_FIELD_PER_EM  = 4.0; // field units the value drops per em away from the stroke
+const float FONT_MAX_OUTLINE   = 0.1;
+const float MIN_PIXELS_PER_EM  = 4.0; // smaller than this is a smudge, skip it
+
+const uint TEXT_FLAGS_SCREEN_SIZE = 1u;
+const uint NO_TEXT_ANCHOR = 0xFFFFFFFFu;
+const uint TWEEN_POSITION = 0u;
+
+// Same curves as basic.vert
+float ease(uint easing, float t) {
+    if (easing == 1u) return t * t * t;
+    if (easing == 2u) return 1.0 - pow(1.0 - t, 3.0);
+    if (easing == 3u) return t < 0.5 ? 4.0 * t * t * t : 1.0 - pow(-2.0 * t + 2.0, 3.0) * 0.5;
+    return t;
+}
+
+// Same as edge.vert
+vec2 circleCenter(uint i) {
+    if (i < ubo.physicsBodyCount) {
+        return positions[i];
+    }
+    uint slot = instances[i].tweenSlot;
+    if (slot != 0u) {
+        Track track = tweens[slot].tracks[TWEEN_POSITION];
+        if (track.duration > 0.0 && ubo.time < track.start + track.duration) {
+            float t = clamp((ubo.time - track.start) / track.duration, 0.0, 1.0);
+            return mix(track.from.xy, track.to.xy, ease(track.easing, t));
+        }
+    }
+    return instances[i].position;
+}
+
+void cull() {
+    gl_Position   = vec4(2.0, 2.0, 0.0, 1.0);
+    vColor        = vec4(0.0);
+    vOutlineColor = vec4(0.0);
+    vUV           = vec2(0.0);
+    vOutline      = 1.0;
+    vDrawIndex    = 0;
+}
+
+void main() {
+    if (iText >= pc.textCount || texts[iText].alive == 0u) {
+        cull();
+        return;
+    }
+    Text text = texts[iText];
+
+    vec2 base      = text.position;
+    int  drawIndex = text.drawIndex;
+    float alpha    = 1.0;
+    if (text.anchor != NO_TEXT_ANCHOR) {
+        if (text.anchor >= pc.circleCount || instances[text.anchor].alive == 0u) {
+            cull();
+            return;
+        }
+        base      += circleCenter(text.anchor);
+        drawIndex += instances[text.anchor].drawIndex;
+        alpha      = ubo.circleAlpha;
+    }
+
+    // projection[0][0] is 2 / visible width, so this is pixels per world unit
+    float pixelsPerUnit = ubo.projection[0][0] * ubo.viewportSize.x * 0.5;
+    float emWorld = (text.flags & TEXT_FLAGS_SCREEN_SIZE) != 0u ? text.size / pixelsPerUnit : text.size;
+    if (emWorld * pixelsPerUnit < MIN_PIXELS_PER_EM) {
+        cull();
+        return;
+    }
+
+    vec2 t     = (inPos + 1.0) * 0.5; // [-1,1] → [0,1], y down like the em space
+    vec2 local = iOffset + FONT_CELL_ORIGIN + t * FONT_CELL_SIZE;
+    vec2 pos   = base + local * emWorld;
+
+    uvec2 cell = uvec2(iGlyph % FONT_ATLAS_COLUMNS, iGlyph / FONT_ATLAS_COLUMNS);
+
+    gl_Position   = ubo.projection * vec4(pos, 0.0, 1.0);
+    vUV           = (vec2(cell) + t) / vec2(FONT_ATLAS_COLUMNS, FONT_ATLAS_ROWS);
+    vColor        = vec4(text.color.rgb, text.color.a * alpha);
+    vOutlineColor = vec4(text.outlineColor.rgb, text.outlineColor.a * alpha);
+    vOutline      = 0.5 - clamp(text.outlineSize, 0.0, FONT_MAX_OUTLINE) * FONT_FIELD_PER_EM;
+    vDrawIndex    = drawIndex;
+}
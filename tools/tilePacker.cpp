@@ -0,0 +1,289 @@
+// Offline packer for the tile pyramid the engine streams (ThING/types/tilePyramid.h, api.openTiles).
+// Input rows are "x,y[,size[,rrggbbaa]]" split by commas, semicolons, tabs or spaces, rows that don't start with a
+// number are skipped. Memory stays flat whatever the input size: the points go through temporary files, every tile
+// is one pass over its file that both aggregates it and splits it into its four children, depth first.
+#include "ThING/extras/handMade.h"
+#include "ThING/types/tilePyramid.h"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static constexpr size_t STREAM_POINTS = 0x100000; // per read or write buffer
+
+static bool isSeparator(char c){
+    return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+template <typename T>
+static bool field(const char*& p, const char* end, T& out, int base = 10){
+    while(p < end && isSeparator(*p)){
+        p++;
+    }
+    std::from_chars_result result;
+    if constexpr (std::is_integral_v<T>){
+        result = std::from_chars(p, end, out, base);
+    } else {
+        result = std::from_chars(p, end, out);
+    }
+    if(result.ec != std::errc()){
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+// rrggbbaa as written to the packed RGBA8 the engine uses
+static uint32_t parseColor(const char*& p, const char* end, uint32_t fallback){
+    uint32_t rgba;
+    return field(p, end, rgba, 16) ? std::byteswap(rgba) : fallback;
+}
+
+class PointWriter{
+public:
+    explicit PointWriter(const std::filesystem::path& path) : path(path), file(path, std::ios::binary | std::ios::trunc){
+        if(!file){
+            throw std::runtime_error("failed to create temporary file: " + path.string());
+        }
+        buffer.reserve(STREAM_POINTS);
+    }
+    void push(const TilePoint& point){
+        buffer.push_back(point);
+        count++;
+        if(buffer.size() == STREAM_POINTS){
+            flush();
+        }
+    }
+    void close(){
+        flush();
+        buffer = {}; // the writers of every level above stay around while the children get built
+        file.close();
+        if(!file){
+            throw std::runtime_error("failed to write temporary file: " + path.string());
+        }
+    }
+    uint64_t getCount() const {return count;}
+    const std::filesystem::path& getPath() const {return path;}
+
+private:
+    void flush(){
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(TilePoint)));
+        buffer.clear();
+    }
+    std::filesystem::path path;
+    std::ofstream file;
+    std::vector<TilePoint> buffer;
+    uint64_t count = 0;
+};
+
+// Calls fn(span of points) over the whole file, STREAM_POINTS at a time
+template <typename Fn>
+static void readPoints(const std::filesystem::path& path, uint64_t count, Fn&& fn){
+    std::ifstream file(path, std::ios::binary);
+    std::vector<TilePoint> buffer(static_cast<size_t>(std::min<uint64_t>(count, STREAM_POINTS)));
+    while(count > 0){
+        const size_t chunk = static_cast<size_t>(std::min<uint64_t>(count, STREAM_POINTS));
+        if(!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(chunk * sizeof(TilePoint)))){
+            throw std::runtime_error("failed to read temporary file: " + path.string());
+        }
+        fn(std::span<const TilePoint>(buffer.data(), chunk));
+        count -= chunk;
+    }
+}
+
+class Packer{
+public:
+    Packer(const std::string& outputPath, float defaultSize, uint32_t defaultColor)
+        : outputPath(outputPath), defaultSize(defaultSize), defaultColor(defaultColor){}
+
+    void pack(const std::string& inputPath){
+        osd::MappedFile input;
+        if(!input.open(inputPath)){
+            throw std::runtime_error("failed to open input: " + inputPath);
+        }
+        const std::span<const std::byte> bytes = input.view();
+        const char* p = reinterpret_cast<const char*>(bytes.data());
+        const char* end = p + bytes.size();
+
+        PointWriter all(tempPath("r"));
+        glm::vec2 low(std::numeric_limits<float>::max());
+        glm::vec2 high(std::numeric_limits<float>::lowest());
+        uint64_t skipped = 0;
+        while(p < end){
+            const void* found = std::memchr(p, '\n', static_cast<size_t>(end - p));
+            const char* line = found ? static_cast<const char*>(found) : end;
+            const char* cursor = p;
+            TilePoint point{{0.0f, 0.0f}, defaultSize, defaultColor};
+            if(field(cursor, line, point.position.x) && field(cursor, line, point.position.y)){
+                if(field(cursor, line, point.size)){
+                    point.color = parseColor(cursor, line, defaultColor);
+                }
+                low = glm::min(low, point.position);
+                high = glm::max(high, point.position);
+                all.push(point);
+            } else if(cursor < line){
+                skipped++; // header or comment
+            }
+            p = line + 1;
+        }
+        all.close();
+        input.close();
+        if(all.getCount() == 0){
+            std::filesystem::remove(all.getPath());
+            throw std::runtime_error("no points in input: " + inputPath);
+        }
+
+        header.origin = low;
+        header.size = std::max(std::max(high.x - low.x, high.y - low.y), 1e-3f) * 1.0001f; // the far edge stays inside
+        header.pointCount = all.getCount();
+
+        output.open(outputPath, std::ios::binary | std::ios::trunc);
+        if(!output){
+            throw std::runtime_error("failed to open output: " + outputPath);
+        }
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header)); // rewritten at the end
+        build(0, 0, 0, all.getPath(), all.getCount());
+
+        std::sort(directory.begin(), directory.end(), [](const TileEntry& a, const TileEntry& b){return a.key < b.key;});
+        header.tileCount = static_cast<uint32_t>(directory.size());
+        header.directoryOffset = static_cast<uint64_t>(output.tellp());
+        output.write(reinterpret_cast<const char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(TileEntry)));
+        output.seekp(0);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.close();
+        if(!output){
+            throw std::runtime_error("failed to write output: " + outputPath);
+        }
+        std::cout << header.pointCount << " points, " << skipped << " rows skipped, " << header.levels << " levels, "
+            << header.tileCount << " tiles\n";
+    }
+
+private:
+    struct Cell{
+        glm::dvec2 position{0.0};
+        glm::dvec4 color{0.0};
+        double size = 0.0;
+        uint64_t count = 0;
+    };
+
+    std::filesystem::path tempPath(const std::string& name) const{
+        return outputPath + ".tmp" + name;
+    }
+
+    void writeTile(uint64_t key, std::span<const TilePoint> points, bool leaf){
+        directory.push_back({key, static_cast<uint64_t>(output.tellp()), static_cast<uint32_t>(points.size()), leaf ? 1u : 0u});
+        output.write(reinterpret_cast<const char*>(points.data()), static_cast<std::streamsize>(points.size() * sizeof(TilePoint)));
+    }
+
+    void build(uint32_t level, uint32_t x, uint32_t y, const std::filesystem::path& path, uint64_t count){
+        header.levels = std::max(header.levels, level + 1);
+        const uint64_t key = tileKey(level, x, y);
+        if(count <= TILE_CAPACITY){
+            std::vector<TilePoint> points;
+            points.reserve(static_cast<size_t>(count));
+            readPoints(path, count, [&points](std::span<const TilePoint> chunk){
+                points.insert(points.end(), chunk.begin(), chunk.end());
+            });
+            std::filesystem::remove(path);
+            writeTile(key, points, true);
+            return;
+        }
+
+        const float tileSize = header.size / static_cast<float>(1u << level);
+        const glm::vec2 tileMin = header.origin + glm::vec2(x, y) * tileSize;
+        const glm::vec2 middle = tileMin + tileSize * 0.5f;
+        const float cellSize = tileSize / TILE_GRID;
+        const bool last = level + 1 == TILE_MAX_LEVELS;
+
+        std::vector<Cell> cells(TILE_CAPACITY);
+        std::vector<PointWriter> children;
+        if(!last){
+            children.reserve(4);
+            for(uint32_t child = 0; child < 4; child++){
+                children.emplace_back(path.string() + std::to_string(child));
+            }
+        }
+        readPoints(path, count, [&](std::span<const TilePoint> chunk){
+            for(const TilePoint& point : chunk){
+                const glm::ivec2 cell = glm::clamp(glm::ivec2((point.position - tileMin) / cellSize), 0, static_cast<int>(TILE_GRID) - 1);
+                Cell& sum = cells[cell.y * TILE_GRID + cell.x];
+                sum.position += glm::dvec2(point.position);
+                sum.color += glm::dvec4(glm::unpackUnorm4x8(point.color));
+                sum.size += point.size;
+                sum.count++;
+                if(!last){
+                    children[(point.position.x >= middle.x ? 1 : 0) | (point.position.y >= middle.y ? 2 : 0)].push(point);
+                }
+            }
+        });
+        std::filesystem::remove(path);
+
+        // One point per occupied cell, at least half a cell wide so a dense area still reads as covered
+        std::vector<TilePoint> aggregate;
+        for(const Cell& cell : cells){
+            if(cell.count == 0){
+                continue;
+            }
+            const double n = static_cast<double>(cell.count);
+            aggregate.push_back({glm::vec2(cell.position / n), std::max(static_cast<float>(cell.size / n), cellSize * 0.5f),
+                glm::packUnorm4x8(glm::vec4(cell.color / n))});
+        }
+        writeTile(key, aggregate, last);
+        cells = {};
+        aggregate = {};
+
+        for(PointWriter& child : children){
+            child.close();
+        }
+        for(uint32_t child = 0; child < children.size(); child++){
+            if(children[child].getCount() == 0){
+                std::filesystem::remove(children[child].getPath());
+                continue;
+            }
+            build(level + 1, x * 2 + (child & 1), y * 2 + (child >> 1), children[child].getPath(), children[child].getCount());
+        }
+    }
+
+    std::string outputPath;
+    float defaultSize;
+    uint32_t defaultColor;
+    TilePyramidHeader header;
+    std::ofstream output;
+    std::vector<TileEntry> directory;
+};
+
+int main(int argc, char** argv){
+    try {
+        if(argc < 3){
+            std::cerr << "Usage:\n  " << argv[0] << " <points.csv> <output.tiles> [size] [rrggbbaa]\n\n"
+                "Size and color are used for rows that have none, defaults 1 and ffffffff\n";
+            return 2;
+        }
+        float size = 1.0f;
+        uint32_t color = 0xFFFFFFFF;
+        if(argc >= 4){
+            const char* p = argv[3];
+            field(p, p + std::strlen(p), size);
+        }
+        if(argc >= 5){
+            const char* p = argv[4];
+            color = parseColor(p, p + std::strlen(p), color);
+        }
+        Packer(argv[2], size, color).pack(argv[1]);
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "tile_packer error: " << e.what() << "\n";
+        return 1;
+    }
+}